@@ -217,6 +217,39 @@ int32_t db_upperbound_i64(account_name code, account_name scope, table_name tabl
   */
 int32_t db_end_i64(account_name code, account_name scope, table_name table);
 
+/**
+  *
+  *  Copy the table rows with a primary key in [lower, upper) into a buffer in a single call.
+  *  Every row is packed as its primary key (uint64_t), the size of its value (uint32_t) and the value itself.
+  *  The scan stops after limit rows (0 for no limit) or at the first row that does not fit in the buffer,
+  *  lower is then set to the primary key of that row so that the next call resumes from it,
+  *  or to upper once every row of the range has been copied.
+  *
+  *  @brief Copy a range of table rows of a primary 64-bit integer index table into a buffer
+  *  @param code - The name of the owner of the table
+  *  @param scope - The scope where the table resides
+  *  @param table - The table name
+  *  @param lower - Pointer to the primary key to start from, set to the key to continue from
+  *  @param upper - The primary key the scan stops before
+  *  @param limit - Maximum number of rows to copy, 0 for no limit
+  *  @param data - Pointer to the buffer the rows are packed into
+  *  @param len - Size of the buffer
+  *  @return number of rows copied, or minus the size the first row needs if the buffer is too small for it
+  *
+  *  Example:
+  *
+  *  @code
+  *  char buffer[4096];
+  *  uint64_t lower = 0;
+  *  while (lower < upper) {
+  *     int32_t count = db_scan_i64(current_receiver(), current_receiver(), N(mytable), &lower, upper, 0, buffer, sizeof(buffer));
+  *     eosio_assert(count >= 0, "row too large");
+  *     // unpack count rows from buffer
+  *  }
+  *  @endcode
+  */
+int32_t db_scan_i64(account_name code, account_name scope, table_name table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len);
+
 //for ipc & rpc
 void db_remove_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t id );
 void db_update_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t id, const char* buffer, size_t buffer_size );
@@ -362,6 +395,29 @@ int32_t db_idx64_upperbound(account_name code, account_name scope, table_name ta
   */
 int32_t db_idx64_end(account_name code, account_name scope, table_name table);
 
+/**
+  *
+  *  Copy the rows of a secondary 64-bit integer index table with a secondary key below upper, starting from (secondary, primary),
+  *  into a buffer in a single call. Every entry is packed as its secondary key (uint64_t), its primary key (uint64_t),
+  *  the size of the row with that primary key in row_table (uint32_t, 0 if there is none) and the value of that row.
+  *  The scan stops like db_scan_i64 and leaves the entry to continue from in secondary and primary,
+  *  or upper and 0 once the range has been copied.
+  *
+  *  @brief Copy a range of a secondary 64-bit integer index table and the rows it refers to into a buffer
+  *  @param code - The name of the owner of the table
+  *  @param scope - The scope where the table resides
+  *  @param table - The name of the secondary index table
+  *  @param row_table - The name of the primary table the rows are read from
+  *  @param secondary - Pointer to the secondary key to start from, set to the secondary key to continue from
+  *  @param primary - Pointer to the primary key to start from, set to the primary key to continue from
+  *  @param upper - The secondary key the scan stops before
+  *  @param limit - Maximum number of entries to copy, 0 for no limit
+  *  @param data - Pointer to the buffer the entries are packed into
+  *  @param len - Size of the buffer
+  *  @return number of entries copied, or minus the size the first entry needs if the buffer is too small for it
+  */
+int32_t db_idx64_scan(account_name code, account_name scope, table_name table, table_name row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len);
+
 
 
 /**
@@ -1333,6 +1333,58 @@ class multi_index
          return {this, &obj};
       }
 
+      /**
+       *  Calls a visitor on every object with a primary key in [lower, upper), in primary key order.
+       *  The rows are read with db_scan_i64, one intrinsic call per buffer of rows instead of a lookup and two reads per row.
+       *  The objects are not cached by the table: use find() to get an iterator to an object that has to be modified.
+       *  @brief Visits a range of objects without loading them one by one.
+       *
+       *  @param lower - Primary key to start from
+       *  @param upper - Primary key to stop before
+       *  @param visitor - Lambda called with a const reference to each object
+       *
+       *  Example:
+       *
+       *  @code
+       *  uint64_t total = 0;
+       *  accounts.scan( 0, std::numeric_limits<uint64_t>::max(), [&]( const auto& a ) {
+       *     total += a.balance;
+       *  });
+       *  @endcode
+       */
+      template<typename Lambda>
+      void scan( uint64_t lower, uint64_t upper, Lambda&& visitor )const {
+         char stack_buffer[max_stack_buffer_size];
+         char* buffer = stack_buffer;
+         uint32_t buffer_size = sizeof(stack_buffer);
+
+         while( lower < upper ) {
+            auto count = db_scan_i64( _code, _scope, TableName, &lower, upper, 0, buffer, buffer_size );
+            if( count < 0 ) {
+               //the next row does not fit in the buffer
+               if( buffer != stack_buffer ) free( buffer );
+               buffer_size = uint32_t(-count);
+               buffer = (char*)malloc( buffer_size );
+               continue;
+            }
+
+            datastream<const char*> ds( buffer, buffer_size );
+            for( int32_t i = 0; i < count; ++i ) {
+               uint64_t primary;
+               uint32_t size;
+               ds >> primary >> size;
+
+               T obj;
+               datastream<const char*> row( ds.pos(), size );
+               row >> obj;
+               ds.skip( size );
+               visitor( static_cast<const T&>(obj) );
+            }
+         }
+
+         if( buffer != stack_buffer ) free( buffer );
+      }
+
       /**
        *  Returns an available primary key.
        *  @brief Returns an available primary key.
@@ -69,6 +69,10 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
    return get_vm_api()->db_end_i64(code, scope, table);
 }
 
+int32_t db_scan_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len) {
+   return get_vm_api()->db_scan_i64(code, scope, table, lower, upper, limit, data, len);
+}
+
 int32_t db_idx64_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary) {
    return get_vm_api()->db_idx64_store(scope, table, payer, id, secondary);
 }
@@ -109,6 +113,10 @@ int32_t db_idx64_end(uint64_t code, uint64_t scope, uint64_t table) {
    return get_vm_api()->db_idx64_end(code, scope, table);
 }
 
+int32_t db_idx64_scan(uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len) {
+   return get_vm_api()->db_idx64_scan(code, scope, table, row_table, secondary, primary, upper, limit, data, len);
+}
+
 int32_t db_idx128_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint128_t* secondary) {
    return get_vm_api()->db_idx128_store(scope, table, payer, id, secondary);
 }
@@ -280,7 +280,13 @@ struct vm_api {
    int (*vm_apply)(int type, uint64_t receiver, uint64_t account, uint64_t act);
 
    int (*is_contracts_console_enabled)();
-   char reserved[sizeof(char*)*128]; //for forward compatibility
+
+   void (*profile_begin)(int phase);
+   void (*profile_end)(int phase);
+
+   int32_t (*db_scan_i64)(uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len);
+   int32_t (*db_idx64_scan)(uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len);
+   char reserved[sizeof(char*)*124]; //for forward compatibility
 };
 
 int32_t uint64_to_string(uint64_t n, char* out, int size);
@@ -295,6 +301,7 @@ typedef int (*fn_call)(uint64_t account, uint64_t func);
 typedef void (*fn_vm_init)(struct vm_api* api);
 typedef void (*fn_vm_deinit)(void);
 typedef int (*fn_preload)(uint64_t account);
+typedef int (*fn_preload_code)(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size);
 typedef int (*fn_unload)(uint64_t account);
 
 
@@ -308,6 +315,7 @@ int vm_apply(uint64_t receiver, uint64_t account, uint64_t act);
 int vm_call(uint64_t account, uint64_t func);
 
 int vm_preload(uint64_t account);
+int vm_preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size);
 
 int vm_load(uint64_t account);
 int vm_unload(uint64_t account);
@@ -347,6 +355,8 @@ int get_option(const char* option, char *result, int size);
 #define  VM_TYPE_JAVA                     12
 #define  VM_TYPE_WABT                     13
 
+#include "vm_profile.h"
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,10 @@
+#ifndef __VM_PROFILE_H__
+#define __VM_PROFILE_H__
+
+//phases a VM reports through vm_api's profile_begin/profile_end,
+//the time of an action not spent in any of them counts as execution
+#define  VM_PROFILE_LOAD                   0
+#define  VM_PROFILE_INSTANTIATE            1
+#define  VM_PROFILE_DB                     2
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/action.hpp>
+#include <eosiolib/crypto.h>
+#include <eosiolib/db.h>
+
+/**
+ * Workloads of the vm_bench benchmark in tests/vm_bench.
+ * vm_bench.py and vm_bench.lua implement the same actions on the same tables, so every backend
+ * makes the same vm_api calls. Every action starts with a uint64 nonce that only keeps the
+ * transaction ids unique.
+ */
+namespace vmbench {
+
+   static const uint64_t rows_table     = N(rows);
+   static const uint64_t accounts_table = N(accounts);
+   static const uint64_t range_count    = 100;
+   static const uint64_t fanout_count   = 8;
+   static const uint64_t lookup_count   = 5000;
+   static const uint64_t max_hash_size  = 4096;
+   static const uint32_t scan_buffer_size = 4096;
+
+   struct row {
+      uint64_t key;
+      uint64_t value;
+   };
+
+   struct setup_args {
+      uint64_t nonce;
+      uint32_t start;
+      uint32_t count;
+   };
+
+   //rows [start, start+count) of the rows table, with secondary keys in reverse order of the primary keys
+   void setup( uint64_t self ) {
+      setup_args args;
+      eosio_assert( action_data_size() == sizeof(args), "bad setup args" );
+      read_action_data( &args, sizeof(args) );
+
+      for( uint64_t i = args.start; i < args.start + args.count; i++ ) {
+         row r{ i, i * 2 };
+         db_store_i64( self, rows_table, self, i, &r, sizeof(r) );
+         uint64_t secondary = 1000000 - i;
+         db_idx64_store( self, rows_table, self, i, &secondary );
+      }
+
+      if( db_find_i64( self, self, accounts_table, self ) < 0 ) {
+         int64_t balance = 1000000000;
+         db_store_i64( self, accounts_table, self, self, &balance, sizeof(balance) );
+         balance = 0;
+         db_store_i64( self, accounts_table, self, N(alice), &balance, sizeof(balance) );
+      }
+   }
+
+   void transfer( uint64_t self ) {
+      int32_t from = db_find_i64( self, self, accounts_table, self );
+      int32_t to = db_find_i64( self, self, accounts_table, N(alice) );
+      eosio_assert( from >= 0 && to >= 0, "run setup first" );
+
+      int64_t from_balance = 0;
+      int64_t to_balance = 0;
+      db_get_i64( from, &from_balance, sizeof(from_balance) );
+      db_get_i64( to, &to_balance, sizeof(to_balance) );
+      eosio_assert( from_balance > 0, "overdrawn balance" );
+
+      from_balance -= 1;
+      to_balance += 1;
+      db_update_i64( from, self, &from_balance, sizeof(from_balance) );
+      db_update_i64( to, self, &to_balance, sizeof(to_balance) );
+   }
+
+   void scan( uint64_t self ) {
+      row r;
+      uint64_t primary = 0;
+      int32_t itr = db_lowerbound_i64( self, self, rows_table, 0 );
+      while( itr >= 0 ) {
+         db_get_i64( itr, &r, sizeof(r) );
+         itr = db_next_i64( itr, &primary );
+      }
+   }
+
+   //same rows as scan, read with db_scan_i64
+   void bulkscan( uint64_t self ) {
+      static char buffer[scan_buffer_size];
+      row r;
+      uint64_t lower = 0;
+      while( lower < uint64_t(-1) ) {
+         int32_t count = db_scan_i64( self, self, rows_table, &lower, uint64_t(-1), 0, buffer, sizeof(buffer) );
+         eosio_assert( count >= 0, "row too large" );
+         const char* pos = buffer;
+         for( int32_t i = 0; i < count; i++ ) {
+            uint32_t size;
+            memcpy( &size, pos + sizeof(uint64_t), sizeof(size) );
+            memcpy( &r, pos + sizeof(uint64_t) + sizeof(size), sizeof(r) );
+            pos += sizeof(uint64_t) + sizeof(size) + size;
+         }
+      }
+   }
+
+   //lookup_count finds, each followed by a next, the table lookups of token-like contracts
+   void lookup( uint64_t self ) {
+      uint64_t primary = 0;
+      for( uint64_t i = 0; i < lookup_count; i++ ) {
+         int32_t itr = db_find_i64( self, self, rows_table, i % range_count );
+         db_next_i64( itr, &primary );
+      }
+   }
+
+   void range( uint64_t self ) {
+      row r;
+      uint64_t secondary = 0;
+      uint64_t primary = 0;
+      int32_t itr = db_idx64_lowerbound( self, self, rows_table, &secondary, &primary );
+      for( uint64_t i = 0; i < range_count && itr >= 0; i++ ) {
+         int32_t row_itr = db_find_i64( self, self, rows_table, primary );
+         db_get_i64( row_itr, &r, sizeof(r) );
+         itr = db_idx64_next( itr, &primary );
+      }
+   }
+
+   //hashes the whole action data, nonce included
+   void hash() {
+      static char data[max_hash_size];
+      uint32_t size = action_data_size();
+      eosio_assert( size <= max_hash_size, "hash data too large" );
+      read_action_data( data, size );
+      checksum256 digest;
+      sha256( data, size, &digest );
+   }
+
+   void fanout( uint64_t self ) {
+      for( uint64_t i = 0; i < fanout_count; i++ ) {
+         eosio::action( eosio::permission_level{ self, N(active) }, self, N(empty), i ).send();
+      }
+   }
+
+} /// vmbench
+
+extern "C" {
+   void apply( uint64_t receiver, uint64_t code, uint64_t action ) {
+      if( code != receiver ) {
+         return;
+      }
+      switch( action ) {
+         case N(setup):
+            vmbench::setup( receiver );
+            break;
+         case N(empty):
+            break;
+         case N(transfer):
+            vmbench::transfer( receiver );
+            break;
+         case N(scan):
+            vmbench::scan( receiver );
+            break;
+         case N(bulkscan):
+            vmbench::bulkscan( receiver );
+            break;
+         case N(lookup):
+            vmbench::lookup( receiver );
+            break;
+         case N(range):
+            vmbench::range( receiver );
+            break;
+         case N(hash):
+            vmbench::hash();
+            break;
+         case N(fanout):
+            vmbench::fanout( receiver );
+            break;
+         default:
+            eosio_assert( false, "unknown action" );
+      }
+   }
+}
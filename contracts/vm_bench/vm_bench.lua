@@ -0,0 +1,94 @@
+-- Lua version of vm_bench.cpp. vm_lua has no crypto, secondary index or inline action api,
+-- so only setup, empty, transfer, scan, bulkscan and lookup are implemented.
+
+rows_table = N('rows')
+accounts_table = N('accounts')
+
+function pack64(n)
+    local s = ''
+    for i = 1, 8 do
+        s = s .. string.char(n % 256)
+        n = math.floor(n / 256)
+    end
+    return s
+end
+
+function unpack_uint(s, pos, size)
+    local n = 0
+    for i = pos + size - 1, pos, -1 do
+        n = n * 256 + string.byte(s, i)
+    end
+    return n
+end
+
+function setup(receiver)
+    local args = read_action_data()
+    local start = unpack_uint(args, 9, 4)
+    local count = unpack_uint(args, 13, 4)
+    for i = start, start + count - 1 do
+        db_store_i64(receiver, rows_table, receiver, i, pack64(i) .. pack64(i * 2))
+    end
+
+    if db_find_i64(receiver, receiver, accounts_table, receiver) < 0 then
+        db_store_i64(receiver, accounts_table, receiver, receiver, pack64(1000000000))
+        db_store_i64(receiver, accounts_table, receiver, N('alice'), pack64(0))
+    end
+end
+
+function transfer(receiver)
+    local from = db_find_i64(receiver, receiver, accounts_table, receiver)
+    local to = db_find_i64(receiver, receiver, accounts_table, N('alice'))
+    assert(from >= 0 and to >= 0, 'run setup first')
+
+    local from_balance = unpack_uint(db_get_i64(from), 1, 8)
+    local to_balance = unpack_uint(db_get_i64(to), 1, 8)
+    assert(from_balance > 0, 'overdrawn balance')
+
+    db_update_i64(from, receiver, pack64(from_balance - 1))
+    db_update_i64(to, receiver, pack64(to_balance + 1))
+end
+
+function scan(receiver)
+    local itr = db_lowerbound_i64(receiver, receiver, rows_table, 0)
+    while itr >= 0 do
+        db_get_i64(itr)
+        itr = db_next_i64(itr)
+    end
+end
+
+-- the largest primary key a lua number holds exactly, above every row of the rows table
+scan_upper = 2^53
+
+function bulkscan(receiver)
+    local lower = 0
+    local rows
+    while lower < scan_upper do
+        rows, lower = db_scan_i64(receiver, receiver, rows_table, lower, scan_upper)
+    end
+end
+
+function lookup(receiver)
+    for i = 0, 4999 do
+        db_next_i64(db_find_i64(receiver, receiver, rows_table, i % 100))
+    end
+end
+
+function apply(receiver, account, act)
+    if account ~= receiver then
+        return 1
+    end
+    if act == N('setup') then
+        setup(receiver)
+    elseif act == N('transfer') then
+        transfer(receiver)
+    elseif act == N('scan') then
+        scan(receiver)
+    elseif act == N('bulkscan') then
+        bulkscan(receiver)
+    elseif act == N('lookup') then
+        lookup(receiver)
+    elseif act ~= N('empty') then
+        error('unknown action')
+    end
+    return 1
+end
@@ -0,0 +1,89 @@
+import db
+import struct
+from eoslib import *
+
+# Python version of vm_bench.cpp, the workloads make the same vm_api calls
+
+rows_table = N('rows')
+accounts_table = N('accounts')
+range_count = 100
+fanout_count = 8
+lookup_count = 5000
+
+def setup(receiver):
+    nonce, start, count = struct.unpack('QII', read_action())
+    for i in range(start, start + count):
+        db.store_i64(receiver, rows_table, receiver, i, struct.pack('QQ', i, i * 2))
+        db.db_idx64_store(receiver, rows_table, receiver, i, 1000000 - i)
+
+    if db.find_i64(receiver, receiver, accounts_table, receiver) < 0:
+        db.store_i64(receiver, accounts_table, receiver, receiver, struct.pack('q', 1000000000))
+        db.store_i64(receiver, accounts_table, receiver, N('alice'), struct.pack('q', 0))
+
+def transfer(receiver):
+    itr_from = db.find_i64(receiver, receiver, accounts_table, receiver)
+    itr_to = db.find_i64(receiver, receiver, accounts_table, N('alice'))
+    eosio_assert(itr_from >= 0 and itr_to >= 0, 'run setup first')
+
+    from_balance = struct.unpack('q', db.get_i64(itr_from))[0]
+    to_balance = struct.unpack('q', db.get_i64(itr_to))[0]
+    eosio_assert(from_balance > 0, 'overdrawn balance')
+
+    db.update_i64(itr_from, receiver, struct.pack('q', from_balance - 1))
+    db.update_i64(itr_to, receiver, struct.pack('q', to_balance + 1))
+
+def scan(receiver):
+    itr = db.lowerbound_i64(receiver, receiver, rows_table, 0)
+    while itr >= 0:
+        db.get_i64(itr)
+        itr, primary = db.next_i64(itr)
+
+def bulkscan(receiver):
+    lower = 0
+    while lower < 0xffffffffffffffff:
+        rows, lower = db.scan_i64(receiver, receiver, rows_table, lower, 0xffffffffffffffff)
+
+def lookup(receiver):
+    for i in range(lookup_count):
+        itr = db.find_i64(receiver, receiver, rows_table, i % range_count)
+        db.next_i64(itr)
+
+def range_(receiver):
+    itr, primary, secondary = db.db_idx64_lowerbound(receiver, receiver, rows_table)
+    i = 0
+    while i < range_count and itr >= 0:
+        row_itr = db.find_i64(receiver, receiver, rows_table, primary)
+        db.get_i64(row_itr)
+        itr, primary = db.db_idx64_next(itr)
+        i += 1
+
+def hash_():
+    sha256(read_action())
+
+def fanout(receiver):
+    for i in range(fanout_count):
+        send_inline(receiver, N('empty'), struct.pack('Q', i), {n2s(receiver):'active'})
+
+def apply(receiver, code, action):
+    if code != receiver:
+        return
+    if action == N('setup'):
+        setup(receiver)
+    elif action == N('empty'):
+        pass
+    elif action == N('transfer'):
+        transfer(receiver)
+    elif action == N('scan'):
+        scan(receiver)
+    elif action == N('bulkscan'):
+        bulkscan(receiver)
+    elif action == N('lookup'):
+        lookup(receiver)
+    elif action == N('range'):
+        range_(receiver)
+    elif action == N('hash'):
+        hash_()
+    elif action == N('fanout'):
+        fanout(receiver)
+    else:
+        eosio_assert(False, 'unknown action')
@@ -9,6 +9,7 @@
 #include <eosio/chain/resource_limits.hpp>
 #include <eosio/chain/account_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
+#include <eosio/chain/state_prefetcher.hpp>
 #include <boost/container/flat_set.hpp>
 #include <fc/scoped_exit.hpp>
 #include <vm_manager.hpp>
@@ -100,7 +101,7 @@ void apply_context::exec_one( action_trace& trace )
                  vm_manager::get().apply(a.vm_type, receiver.value, act.account.value, act.name.value);
             } catch ( const wasm_exit& ){}
          }
-      } FC_RETHROW_EXCEPTIONS( warn, "pending console output: ${console}", ("console", _pending_console_output.str()) )
+      } FC_RETHROW_EXCEPTIONS( warn, "pending console output: ${console}", ("console", pending_console()) )
    } catch( fc::exception& e ) {
       trace.receipt = r; // fill with known data
       trace.except = e;
@@ -135,7 +136,7 @@ void apply_context::finalize_trace( action_trace& trace, const fc::time_point& s
    trace.account_ram_deltas = std::move( _account_ram_deltas );
    _account_ram_deltas.clear();
 
-   trace.console = _pending_console_output.str();
+   trace.console = pending_console();
    reset_console();
 
    trace.elapsed = fc::time_point::now() - start;
@@ -367,27 +368,39 @@ bool apply_context::cancel_deferred_transaction( const uint128_t& sender_id, acc
 }
 
 const table_id_object* apply_context::find_table( name code, name scope, name table ) {
-   return db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   table_key key{code.value, scope.value, table.value};
+   if( const auto* memo = _table_memo.find(key) ) {
+      return *memo;
+   }
+
+   const auto* tid = db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   if( tid != nullptr ) {
+      _table_memo.set(key, tid);
+   }
+   return tid;
 }
 
 const table_id_object& apply_context::find_or_create_table( name code, name scope, name table, const account_name &payer ) {
-   const auto* existing_tid =  db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   const auto* existing_tid = find_table(code, scope, table);
    if (existing_tid != nullptr) {
       return *existing_tid;
    }
 
    update_db_usage(payer, config::billable_size_v<table_id_object>);
 
-   return db.create<table_id_object>([&](table_id_object &t_id){
+   const auto& tid = db.create<table_id_object>([&](table_id_object &t_id){
       t_id.code = code;
       t_id.scope = scope;
       t_id.table = table;
       t_id.payer = payer;
    });
+   _table_memo.set(table_key{code.value, scope.value, table.value}, &tid);
+   return tid;
 }
 
 void apply_context::remove_table( const table_id_object& tid ) {
    update_db_usage(tid.payer, - config::billable_size_v<table_id_object>);
+   _table_memo.erase(table_key{tid.code.value, tid.scope.value, tid.table.value});
    db.remove(tid);
 }
 
@@ -402,7 +415,7 @@ vector<account_name> apply_context::get_active_producers() const {
 }
 
 void apply_context::reset_console() {
-   _pending_console_output = std::ostringstream();
+   _pending_console_output = arena_ostringstream();
    _pending_console_output.setf( std::ios::scientific, std::ios::floatfield );
 }
 
@@ -498,6 +511,9 @@ int apply_context::db_store_i64( uint64_t code, uint64_t scope, uint64_t table,
 
    int64_t billable_size = (int64_t)(buffer_size + config::billable_size_v<key_value_object>);
    update_db_usage( payer, billable_size);
+   update_table_stats( db, tab.code, tab.table, {1, 0, (int64_t)buffer_size, billable_size} );
+
+   if( state_prefetcher::enabled() ) state_prefetcher::record( act, tab, id, &obj );
 
    keyval_cache.cache_table( tab );
    return keyval_cache.add( obj );
@@ -529,11 +545,18 @@ void apply_context::db_update_i64( int iterator, account_name payer, const char*
       update_db_usage( obj.payer, new_size - old_size);
    }
 
+   if( old_size != new_size ) {
+      update_table_stats( db, table_obj.code, table_obj.table, {0, 0, new_size - old_size, new_size - old_size} );
+   }
+
    db.modify( obj, [&]( auto& o ) {
      o.value.resize( buffer_size );
      memcpy( o.value.data(), buffer, buffer_size );
      o.payer = payer;
    });
+
+   // the value may have been reallocated
+   if( state_prefetcher::enabled() ) state_prefetcher::record( act, table_obj, obj.primary_key, &obj );
 }
 
 void apply_context::db_remove_i64( int iterator, bool check_code ) {
@@ -547,6 +570,10 @@ void apply_context::db_remove_i64( int iterator, bool check_code ) {
 //   require_write_lock( table_obj.scope );
 
    update_db_usage( obj.payer,  -(obj.value.size() + config::billable_size_v<key_value_object>) );
+   update_table_stats( db, table_obj.code, table_obj.table,
+                       {-1, 0, -(int64_t)obj.value.size(), -(int64_t)(obj.value.size() + config::billable_size_v<key_value_object>)} );
+
+   if( state_prefetcher::enabled() ) state_prefetcher::forget( table_obj, obj.primary_key );
 
    db.modify( table_obj, [&]( auto& t ) {
       --t.count;
@@ -642,6 +669,7 @@ int apply_context::db_find_i64( uint64_t code, uint64_t scope, uint64_t table, u
    auto table_end_itr = keyval_cache.cache_table( *tab );
 
    const key_value_object* obj = db.find<key_value_object, by_scope_primary>( boost::make_tuple( tab->id, id ) );
+   if( state_prefetcher::enabled() ) state_prefetcher::record( act, *tab, id, obj );
    if( !obj ) return table_end_itr;
 
    return keyval_cache.add( *obj );
@@ -660,6 +688,8 @@ int apply_context::db_lowerbound_i64( uint64_t code, uint64_t scope, uint64_t ta
    if( itr == idx.end() ) return table_end_itr;
    if( itr->t_id != tab->id ) return table_end_itr;
 
+   if( state_prefetcher::enabled() ) state_prefetcher::record( act, *tab, id, &*itr );
+
    return keyval_cache.add( *itr );
 }
 
@@ -688,6 +718,90 @@ int apply_context::db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
    return keyval_cache.cache_table( *tab );
 }
 
+/**
+ * Copies the rows of [lower, upper) into buffer as packed (primary u64, size u32, value) records.
+ * Stops after limit rows (0 means no limit) or when the next record does not fit,
+ * lower is then the primary key of the first row not copied, or upper once the range is exhausted.
+ * Returns the number of records copied, or minus the size of the first record if the buffer can not hold it.
+ * Reads no iterator into keyval_cache and bills nothing, like the find/next/get calls it replaces.
+ */
+int apply_context::db_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t& lower, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size ) {
+   const auto* tab = find_table( code, scope, table );
+   if( !tab ) {
+      lower = upper;
+      return 0;
+   }
+
+   const auto& idx = db.get_index<key_value_index, by_scope_primary>();
+   auto itr = idx.lower_bound( boost::make_tuple( tab->id, lower ) );
+
+   uint32_t count = 0;
+   size_t pos = 0;
+   for( ; itr != idx.end() && itr->t_id == tab->id && itr->primary_key < upper; ++itr ) {
+      uint32_t size = itr->value.size();
+      size_t record_size = sizeof(uint64_t) + sizeof(uint32_t) + size;
+      if( (limit && count == limit) || pos + record_size > buffer_size ) {
+         lower = itr->primary_key;
+         return count ? int(count) : -int(record_size);
+      }
+      memcpy( buffer + pos, &itr->primary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + sizeof(uint64_t), &size, sizeof(uint32_t) );
+      memcpy( buffer + pos + sizeof(uint64_t) + sizeof(uint32_t), itr->value.data(), size );
+      pos += record_size;
+      ++count;
+   }
+
+   lower = upper;
+   return count;
+}
+
+/**
+ * Secondary index version of db_scan_i64: walks idx64 from (secondary, primary) while the secondary key is below upper
+ * and copies packed (secondary u64, primary u64, size u32, value) records, value being the row of row_table
+ * (the primary table of the index, size is 0 if it has no such row).
+ * The continuation is left in (secondary, primary), which are (upper, 0) once the range is exhausted.
+ */
+int apply_context::db_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t& secondary, uint64_t& primary, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size ) {
+   const auto* tab = find_table( code, scope, table );
+   if( !tab ) {
+      secondary = upper;
+      primary = 0;
+      return 0;
+   }
+   const auto* rows = find_table( code, scope, row_table );
+
+   const auto& idx = db.get_index<index64_index, by_secondary>();
+   auto itr = idx.lower_bound( boost::make_tuple( tab->id, secondary, primary ) );
+
+   uint32_t count = 0;
+   size_t pos = 0;
+   for( ; itr != idx.end() && itr->t_id == tab->id && itr->secondary_key < upper; ++itr ) {
+      const key_value_object* obj = nullptr;
+      if( rows ) {
+         obj = db.find<key_value_object, by_scope_primary>( boost::make_tuple( rows->id, itr->primary_key ) );
+      }
+      uint32_t size = obj ? obj->value.size() : 0;
+      size_t record_size = 2 * sizeof(uint64_t) + sizeof(uint32_t) + size;
+      if( (limit && count == limit) || pos + record_size > buffer_size ) {
+         secondary = itr->secondary_key;
+         primary = itr->primary_key;
+         return count ? int(count) : -int(record_size);
+      }
+      memcpy( buffer + pos, &itr->secondary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + sizeof(uint64_t), &itr->primary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + 2 * sizeof(uint64_t), &size, sizeof(uint32_t) );
+      if( size ) {
+         memcpy( buffer + pos + 2 * sizeof(uint64_t) + sizeof(uint32_t), obj->value.data(), size );
+      }
+      pos += record_size;
+      ++count;
+   }
+
+   secondary = upper;
+   primary = 0;
+   return count;
+}
+
 
 int apply_context::db_store_i256( uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size ) {
    return db_store_i256( get_receiver(), scope, table, payer, id, buffer, buffer_size);
@@ -714,6 +828,7 @@ int apply_context::db_store_i256( uint64_t code, uint64_t scope, uint64_t table,
 
    int64_t billable_size = (int64_t)(buffer_size + config::billable_size_v<key256_value_object>);
    update_db_usage( payer, billable_size);
+   update_table_stats( db, tab.code, tab.table, {1, 0, (int64_t)buffer_size, billable_size} );
 
    key256val_cache.cache_table( tab );
    return key256val_cache.add( obj );
@@ -745,6 +860,10 @@ void apply_context::db_update_i256( int iterator, account_name payer, const char
       update_db_usage( obj.payer, new_size - old_size);
    }
 
+   if( old_size != new_size ) {
+      update_table_stats( db, table_obj.code, table_obj.table, {0, 0, new_size - old_size, new_size - old_size} );
+   }
+
    db.modify( obj, [&]( auto& o ) {
      o.value.resize( buffer_size );
      memcpy( o.value.data(), buffer, buffer_size );
@@ -763,6 +882,8 @@ void apply_context::db_remove_i256( int iterator, bool check_code ) {
 //   require_write_lock( table_obj.scope );
 
    update_db_usage( obj.payer,  -(obj.value.size() + config::billable_size_v<key256_value_object>) );
+   update_table_stats( db, table_obj.code, table_obj.table,
+                       {-1, 0, -(int64_t)obj.value.size(), -(int64_t)(obj.value.size() + config::billable_size_v<key256_value_object>)} );
 
    db.modify( table_obj, [&]( auto& t ) {
       --t.count;
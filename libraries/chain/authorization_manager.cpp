@@ -145,6 +145,8 @@ namespace eosio { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      invalidate_authority_cache();
+
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -172,6 +174,8 @@ namespace eosio { namespace chain {
          creation_time = _control.pending_block_time();
       }
 
+      invalidate_authority_cache();
+
       const auto& perm_usage = _db.create<permission_usage_object>([&](auto& p) {
          p.last_used = creation_time;
       });
@@ -188,6 +192,7 @@ namespace eosio { namespace chain {
    }
 
    void authorization_manager::modify_permission( const permission_object& permission, const authority& auth ) {
+      invalidate_authority_cache();
       _db.modify( permission, [&](permission_object& po) {
          po.auth = auth;
          po.last_updated = _control.pending_block_time();
@@ -200,6 +205,8 @@ namespace eosio { namespace chain {
       EOS_ASSERT( range.first == range.second, action_validate_exception,
                   "Cannot remove a permission which has children. Remove the children first.");
 
+      invalidate_authority_cache();
+
       _db.get_mutable_index<permission_usage_index>().remove_object( permission.usage_id._id );
       _db.remove( permission );
    }
@@ -227,12 +234,44 @@ namespace eosio { namespace chain {
       return _db.get<permission_object, by_owner>( boost::make_tuple(level.actor,level.permission) );
    } EOS_RETHROW_EXCEPTIONS( chain::permission_query_exception, "Failed to retrieve permission: ${level}", ("level", level) ) }
 
+   void authorization_manager::reset_authority_cache() {
+      _authority_cache.authorities.clear();
+      _authority_cache.links.clear();
+      _authority_cache.enabled = true;
+   }
+
+   void authorization_manager::invalidate_authority_cache() {
+      reset_authority_cache();
+      _authority_cache.enabled = false;
+   }
+
+   void authorization_manager::begin_authority_lookups()const {
+      // while bypassed the cache only lives for one check, like the authority_checker's own cache
+      if( !_authority_cache.enabled )
+         _authority_cache.authorities.clear();
+   }
+
+   const authority& authorization_manager::get_authority( const permission_level& level )const {
+      auto itr = _authority_cache.authorities.find( level );
+      if( itr == _authority_cache.authorities.end() ) {
+         itr = _authority_cache.authorities.emplace( level, get_permission(level).auth.to_authority() ).first;
+      }
+      return itr->second;
+   }
+
    optional<permission_name> authorization_manager::lookup_linked_permission( account_name authorizer_account,
                                                                               account_name scope,
                                                                               action_name act_name
                                                                             )const
    {
       try {
+         auto cache_key = std::make_tuple(authorizer_account, scope, act_name);
+         if( _authority_cache.enabled ) {
+            auto itr = _authority_cache.links.find( cache_key );
+            if( itr != _authority_cache.links.end() )
+               return itr->second;
+         }
+
          // First look up a specific link for this message act_name
          auto key = boost::make_tuple(authorizer_account, scope, act_name);
          auto link = _db.find<permission_link_object, by_action_name>(key);
@@ -243,10 +282,14 @@ namespace eosio { namespace chain {
          }
 
          // If no specific or default link found, use active permission
+         optional<permission_name> result;
          if (link != nullptr) {
-            return link->required_permission;
+            result = link->required_permission;
          }
-         return optional<permission_name>();
+
+         if( _authority_cache.enabled )
+            _authority_cache.links.emplace( cache_key, result );
+         return result;
 
        //  return optional<permission_name>();
       } FC_CAPTURE_AND_RETHROW((authorizer_account)(scope)(act_name))
@@ -440,7 +483,8 @@ namespace eosio { namespace chain {
 
       auto effective_provided_delay =  (provided_delay >= delay_max_limit) ? fc::microseconds::maximum() : provided_delay;
 
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      begin_authority_lookups();
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& { return get_authority(p); },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
@@ -539,7 +583,8 @@ namespace eosio { namespace chain {
 
       auto delay_max_limit = fc::seconds( _control.get_global_properties().configuration.max_transaction_delay );
 
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      begin_authority_lookups();
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& { return get_authority(p); },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         provided_keys,
                                         provided_permissions,
@@ -570,7 +615,8 @@ namespace eosio { namespace chain {
                                                                        fc::microseconds provided_delay
                                                                      )const
    {
-      auto checker = make_auth_checker( [&](const permission_level& p){ return get_permission(p).auth; },
+      begin_authority_lookups();
+      auto checker = make_auth_checker( [&](const permission_level& p) -> const authority& { return get_authority(p); },
                                         _control.get_global_properties().configuration.max_authority_depth,
                                         candidate_keys,
                                         {},
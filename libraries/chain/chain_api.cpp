@@ -97,6 +97,10 @@ string chain_api::state_dir() {
    return s_cfg->state_dir.string();
 }
 
+state_mapping_config chain_api::state_mapping() {
+   return s_cfg->state_mapping;
+}
+
 void chain_api::get_account( const name& account_name, variant& out )const {
 
 }
@@ -9,18 +9,29 @@
 #include <eosio/chain/block_summary_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/table_stats_object.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
 #include <eosio/chain/transaction_object.hpp>
 #include <eosio/chain/reversible_block_object.hpp>
 
 #include <eosio/chain/authorization_manager.hpp>
 #include <eosio/chain/resource_limits.hpp>
+#include <eosio/chain/state_prefetcher.hpp>
 #include <eosio/chain/chain_snapshot.hpp>
 
 #include <chainbase/chainbase.hpp>
 #include <fc/io/json.hpp>
 #include <fc/scoped_exit.hpp>
 
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#endif
+
 #include <fc/variant_object.hpp>
 
 #include <eosio/chain/eosio_contract.hpp>
@@ -167,6 +178,7 @@ struct controller_impl {
       }
       head = prev;
       db.undo();
+      authorization.reset_authority_cache();
 
    }
 
@@ -192,6 +204,16 @@ struct controller_impl {
     chain_id( cfg.genesis.compute_chain_id() ),
     read_mode( cfg.read_mode )
    {
+   // the chain thread first, so that prefaulting allocates the pages on its node
+   if( cfg.state_mapping.numa_node )
+      bind_thread_to_numa_node( *cfg.state_mapping.numa_node );
+   map_state( db, cfg.state_dir, cfg.state_mapping );
+   if( cfg.state_mapping.prefault ) {
+      auto start = fc::time_point::now();
+      auto bytes = prefault_state( db );
+      ilog( "prefaulted ${mb} MiB of state in ${ms} ms",
+            ("mb", bytes / (1024 * 1024))("ms", (fc::time_point::now() - start).count() / 1000) );
+   }
 
 #define SET_APP_HANDLER( receiver, contract, action) \
    set_apply_handler( #receiver, #contract, #action, &BOOST_PP_CAT(apply_, BOOST_PP_CAT(contract, BOOST_PP_CAT(_,action) ) ) )
@@ -349,6 +371,8 @@ struct controller_impl {
          snapshot->validate();
 
          read_from_snapshot(snapshot);
+         // before the replay, which would otherwise only count the rows its blocks touch
+         rebuild_table_stats();
 
          auto end = blog.read_head();
          if( !end ) {
@@ -395,6 +419,8 @@ struct controller_impl {
          db.undo();
       }
 
+      rebuild_table_stats();
+
       ilog( "database initialized with hash: ${hash}", ("hash", calculate_integrity_hash()));
 
    }
@@ -411,6 +437,7 @@ struct controller_impl {
 
       controller_index_set::add_indices(db);
       contract_database_index_set::add_indices(db);
+      db.add_index<table_stats_index>();
 
       db.add_index<action_object_index>();
 
@@ -430,14 +457,67 @@ struct controller_impl {
       });
    }
 
-   void add_contract_tables_to_snapshot( const snapshot_writer_ptr& snapshot ) const {
-      snapshot->write_section("contract_tables", [this]( auto& section ) {
-         index_utils<table_id_multi_index>::walk(db, [this, &section]( const table_id_object& table_row ){
+   static void add_row_to_table_stats( table_stats_delta& stats, const key_value_object& row ) {
+      stats.rows += 1;
+      stats.payload_bytes += row.value.size();
+      stats.ram_bytes += row.value.size() + config::billable_size_v<key_value_object>;
+   }
+
+   static void add_row_to_table_stats( table_stats_delta& stats, const key256_value_object& row ) {
+      stats.rows += 1;
+      stats.payload_bytes += row.value.size();
+      stats.ram_bytes += row.value.size() + config::billable_size_v<key256_value_object>;
+   }
+
+   template<typename SecondaryObject>
+   static void add_row_to_table_stats( table_stats_delta& stats, const SecondaryObject& row ) {
+      stats.secondary_rows += 1;
+      stats.ram_bytes += config::billable_size_v<SecondaryObject>;
+   }
+
+   /**
+    *  The table stats are not part of snapshots, recount them from the contract tables when they are
+    *  missing: after loading a snapshot or when opening state written before they were tracked.
+    */
+   void rebuild_table_stats() {
+      if( db.get_index<table_id_multi_index>().indices().empty() || !db.get_index<table_stats_index>().indices().empty() ) {
+         return;
+      }
+
+      auto start = fc::time_point::now();
+      map<std::pair<account_name, table_name>, table_stats_delta> totals;
+      contract_database_index_set::walk_indices([this, &totals]( auto utils ) {
+         using value_t = typename decltype(utils)::index_t::value_type;
+
+         decltype(utils)::walk(db, [this, &totals]( const value_t& row ) {
+            const auto& tab = db.get<table_id_object>(row.t_id);
+            add_row_to_table_stats(totals[std::make_pair(tab.code, table_stats_key(tab.table))], row);
+         });
+      });
+
+      for( const auto& t : totals ) {
+         db.create<table_stats_object>([&]( auto& s ) {
+            s.code = t.first.first;
+            s.table = t.first.second;
+            s.rows = t.second.rows;
+            s.secondary_rows = t.second.secondary_rows;
+            s.payload_bytes = t.second.payload_bytes;
+            s.ram_bytes = t.second.ram_bytes;
+         });
+      }
+
+      ilog( "rebuilt stats of ${n} contract tables in ${ms} ms",
+            ("n", totals.size())("ms", (fc::time_point::now() - start).count() / 1000) );
+   }
+
+   static void add_contract_tables_to_snapshot( const chainbase::database& db, const snapshot_writer_ptr& snapshot ) {
+      snapshot->write_section("contract_tables", [&db]( auto& section ) {
+         index_utils<table_id_multi_index>::walk(db, [&db, &section]( const table_id_object& table_row ){
             // add a row for the table
             section.add_row(table_row, db);
 
             // followed by a size row and then N data rows for each type of table
-            contract_database_index_set::walk_indices([this, &section, &table_row]( auto utils ) {
+            contract_database_index_set::walk_indices([&db, &section, &table_row]( auto utils ) {
                using utils_t = decltype(utils);
                using value_t = typename decltype(utils)::index_t::value_type;
                using by_table_id = object_to_table_id_tag_t<value_t>;
@@ -448,7 +528,7 @@ struct controller_impl {
                unsigned_int size = utils_t::template size_range<by_table_id>(db, tid_key, next_tid_key);
                section.add_row(size, db);
 
-               utils_t::template walk_range<by_table_id>(db, tid_key, next_tid_key, [this, &section]( const auto &row ) {
+               utils_t::template walk_range<by_table_id>(db, tid_key, next_tid_key, [&db, &section]( const auto &row ) {
                   section.add_row(row, db);
                });
             });
@@ -485,20 +565,22 @@ struct controller_impl {
       });
    }
 
-   void add_to_snapshot( const snapshot_writer_ptr& snapshot ) const {
-      snapshot->write_section<chain_snapshot_header>([this]( auto &section ){
+   static void add_state_to_snapshot( const chainbase::database& db, const authorization_manager& authorization,
+                                      const resource_limits_manager& resource_limits, const genesis_state& genesis,
+                                      const block_header_state& head, const snapshot_writer_ptr& snapshot ) {
+      snapshot->write_section<chain_snapshot_header>([&db]( auto &section ){
          section.add_row(chain_snapshot_header(), db);
       });
 
-      snapshot->write_section<genesis_state>([this]( auto &section ){
-         section.add_row(conf.genesis, db);
+      snapshot->write_section<genesis_state>([&db, &genesis]( auto &section ){
+         section.add_row(genesis, db);
       });
 
-      snapshot->write_section<block_state>([this]( auto &section ){
-         section.template add_row<block_header_state>(*fork_db.head(), db);
+      snapshot->write_section<block_state>([&db, &head]( auto &section ){
+         section.add_row(head, db);
       });
 
-      controller_index_set::walk_indices([this, &snapshot]( auto utils ){
+      controller_index_set::walk_indices([&db, &snapshot]( auto utils ){
          using value_t = typename decltype(utils)::index_t::value_type;
 
          // skip the table_id_object as its inlined with contract tables section
@@ -506,19 +588,87 @@ struct controller_impl {
             return;
          }
 
-         snapshot->write_section<value_t>([this]( auto& section ){
-            decltype(utils)::walk(db, [this, &section]( const auto &row ) {
+         snapshot->write_section<value_t>([&db]( auto& section ){
+            decltype(utils)::walk(db, [&db, &section]( const auto &row ) {
                section.add_row(row, db);
             });
          });
       });
 
-      add_contract_tables_to_snapshot(snapshot);
+      add_contract_tables_to_snapshot(db, snapshot);
 
       authorization.add_to_snapshot(snapshot);
       resource_limits.add_to_snapshot(snapshot);
    }
 
+   void add_to_snapshot( const snapshot_writer_ptr& snapshot ) const {
+      add_state_to_snapshot(db, authorization, resource_limits, conf.genesis, *fork_db.head(), snapshot);
+   }
+
+   /**
+    * clones the state file with a reflink, which is independent of the state size. A full copy of a state
+    * of several GB would hold the chain for as long as it takes, so filesystems without reflink support are
+    * refused rather than copied. The page cache is coherent with the shared mapping so no flush is needed beforehand
+    */
+   static void clone_state_file( const fc::path& from, const fc::path& to ) {
+      if (fc::exists(to)) {
+         fc::remove(to);
+      }
+#if defined(__linux__) && defined(FICLONE)
+      int in = ::open(from.generic_string().c_str(), O_RDONLY);
+      int out = ::open(to.generic_string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      bool cloned = in >= 0 && out >= 0 && ::ioctl(out, FICLONE, in) == 0;
+      std::string error = cloned ? std::string() : std::string(strerror(errno));
+      if (in >= 0) ::close(in);
+      if (out >= 0) ::close(out);
+      if (!cloned) {
+         fc::remove(to);
+      }
+      EOS_ASSERT( cloned, snapshot_exception,
+                  "cannot reflink ${from} to ${to}: ${e}, live snapshots need a filesystem with reflink support (btrfs, xfs), create_snapshot works without",
+                  ("from", from.generic_string())("to", to.generic_string())("e", error) );
+#else
+      EOS_THROW( snapshot_exception, "live snapshots need reflink support, which this platform does not have, create_snapshot works without" );
+#endif
+   }
+
+   controller::pinned_state pin_state( const fc::path& dir ) const {
+      controller::pinned_state pin;
+      pin.state_dir = dir;
+      pin.state_size = conf.state_size;
+      pin.head = *fork_db.head();
+      pin.genesis = conf.genesis;
+
+      auto count_rows = [this, &pin]( auto utils ) {
+         pin.row_count += db.get_index<typename decltype(utils)::index_t>().indices().size();
+      };
+      controller_index_set::walk_indices(count_rows);
+      contract_database_index_set::walk_indices(count_rows);
+
+      fc::create_directories(dir);
+      try {
+         clone_state_file(conf.state_dir / "shared_memory.bin", dir / "shared_memory.bin");
+      } catch (...) {
+         fc::remove_all(dir);
+         throw;
+      }
+      return pin;
+   }
+
+   void write_pinned_snapshot( const controller::pinned_state& pin, const snapshot_writer_ptr& snapshot ) {
+      // the copy was taken from a database open for writing, so it carries the dirty flag
+      database pinned_db( pin.state_dir, database::read_only, pin.state_size, true );
+      controller_index_set::add_indices(pinned_db);
+      contract_database_index_set::add_indices(pinned_db);
+
+      authorization_manager pinned_authorization( self, pinned_db );
+      resource_limits_manager pinned_resource_limits( pinned_db );
+      pinned_authorization.add_indices();
+      pinned_resource_limits.add_indices();
+
+      add_state_to_snapshot(pinned_db, pinned_authorization, pinned_resource_limits, pin.genesis, pin.head, snapshot);
+   }
+
    void read_from_snapshot( const snapshot_reader_ptr& snapshot ) {
       snapshot->read_section<chain_snapshot_header>([this]( auto &section ){
          chain_snapshot_header header;
@@ -566,12 +716,9 @@ struct controller_impl {
    }
 
    sha256 calculate_integrity_hash() const {
-      sha256::encoder enc;
-      auto hash_writer = std::make_shared<integrity_hash_snapshot_writer>(enc);
+      auto hash_writer = std::make_shared<chunked_integrity_hash_snapshot_writer>();
       add_to_snapshot(hash_writer);
-      hash_writer->finalize();
-
-      return enc.result();
+      return hash_writer->finalize();
    }
 
 
@@ -872,6 +1019,7 @@ struct controller_impl {
       trx_context.explicit_billed_cpu_time = explicit_billed_cpu_time;
       trx_context.billed_cpu_time_us = billed_cpu_time_us;
       trace = trx_context.trace;
+      if( state_prefetcher::enabled() ) state_prefetcher::prefetch( dtrx );
       try {
          trx_context.init_for_deferred_trx( gtrx.published );
          trx_context.exec();
@@ -1001,6 +1149,7 @@ struct controller_impl {
          trx_context.explicit_billed_cpu_time = explicit_billed_cpu_time;
          trx_context.billed_cpu_time_us = billed_cpu_time_us;
          trace = trx_context.trace;
+         if( state_prefetcher::enabled() ) state_prefetcher::prefetch( trx->trx );
          try {
             if( trx->implicit ) {
                trx_context.init_for_implicit_trx();
@@ -1110,6 +1259,8 @@ struct controller_impl {
          pending.emplace(maybe_session());
       }
 
+      authorization.reset_authority_cache();
+
       pending->_block_status = s;
       pending->_producer_block_id = producer_block_id;
       pending->_pending_block_state = std::make_shared<block_state>( *head, when ); // promotes pending schedule (if any) to active
@@ -1186,11 +1337,23 @@ struct controller_impl {
 
          transaction_trace_ptr trace;
 
+         // all of the block's transactions are unpacked first so that the helper thread reads their rows ahead
+         vector<transaction_metadata_ptr> mtrxs;
+         if( state_prefetcher::enabled() ) {
+            mtrxs.reserve( b->transactions.size() );
+            for( const auto& receipt : b->transactions ) {
+               if( !receipt.trx.contains<packed_transaction>() ) continue;
+               mtrxs.emplace_back( std::make_shared<transaction_metadata>( receipt.trx.get<packed_transaction>() ) );
+               state_prefetcher::schedule( mtrxs.back()->trx );
+            }
+         }
+         auto next_mtrx = mtrxs.begin();
+
          for( const auto& receipt : b->transactions ) {
             auto num_pending_receipts = pending->_pending_block_state->block->transactions.size();
             if( receipt.trx.contains<packed_transaction>() ) {
                auto& pt = receipt.trx.get<packed_transaction>();
-               auto mtrx = std::make_shared<transaction_metadata>(pt);
+               auto mtrx = next_mtrx != mtrxs.end() ? *next_mtrx++ : std::make_shared<transaction_metadata>(pt);
                trace = push_transaction( mtrx, fc::time_point::maximum(), receipt.cpu_usage_us, true );
             } else if( receipt.trx.contains<transaction_id_type>() ) {
                trace = push_scheduled_transaction( receipt.trx.get<transaction_id_type>(), fc::time_point::maximum(), receipt.cpu_usage_us, true );
@@ -1354,6 +1517,7 @@ struct controller_impl {
                unapplied_transactions[t->signed_id] = t;
          }
          pending.reset();
+         authorization.reset_authority_cache();
       }
    }
 
@@ -1843,6 +2007,15 @@ void controller::write_snapshot( const snapshot_writer_ptr& snapshot ) const {
    return my->add_to_snapshot(snapshot);
 }
 
+controller::pinned_state controller::pin_state( const fc::path& dir ) const {
+   EOS_ASSERT( !my->pending, block_validate_exception, "cannot take a consistent snapshot with a pending block" );
+   return my->pin_state(dir);
+}
+
+void controller::write_snapshot( const pinned_state& pin, const snapshot_writer_ptr& snapshot ) {
+   my->write_pinned_snapshot(pin, snapshot);
+}
+
 void controller::pop_block() {
    my->pop_block();
 }
@@ -6,6 +6,9 @@
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/transaction.hpp>
 #include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/table_stats_object.hpp>
+#include <eosio/chain/flat_hash_map.hpp>
+#include <eosio/chain/transaction_arena.hpp>
 #include <fc/utility.hpp>
 #include <sstream>
 #include <algorithm>
@@ -23,33 +26,35 @@ class apply_context {
       template<typename T>
       class iterator_cache {
          public:
-            iterator_cache(){
+            iterator_cache()
+            :_table_cache(8)
+            ,_object_to_iterator(32)
+            {
                _end_iterator_to_table.reserve(8);
                _iterator_to_object.reserve(32);
             }
 
             /// Returns end iterator of the table.
             int cache_table( const table_id_object& tobj ) {
-               auto itr = _table_cache.find(tobj.id);
-               if( itr != _table_cache.end() )
-                  return itr->second.second;
+               if( const auto* cached = _table_cache.find(tobj.id._id) )
+                  return cached->second;
 
                auto ei = index_to_end_iterator(_end_iterator_to_table.size());
                _end_iterator_to_table.push_back( &tobj );
-               _table_cache.emplace( tobj.id, make_pair(&tobj, ei) );
+               _table_cache.set( tobj.id._id, make_pair(&tobj, ei) );
                return ei;
             }
 
             const table_id_object& get_table( table_id_object::id_type i )const {
-               auto itr = _table_cache.find(i);
-               EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
-               return *itr->second.first;
+               const auto* cached = _table_cache.find(i._id);
+               EOS_ASSERT( cached, table_not_in_cache, "an invariant was broken, table should be in cache" );
+               return *cached->first;
             }
 
             int get_end_iterator_by_table_id( table_id_object::id_type i )const {
-               auto itr = _table_cache.find(i);
-               EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
-               return itr->second.second;
+               const auto* cached = _table_cache.find(i._id);
+               EOS_ASSERT( cached, table_not_in_cache, "an invariant was broken, table should be in cache" );
+               return cached->second;
             }
 
             const table_id_object* find_table_by_end_iterator( int ei )const {
@@ -79,21 +84,20 @@ class apply_context {
             }
 
             int add( const T& obj ) {
-               auto itr = _object_to_iterator.find( &obj );
-               if( itr != _object_to_iterator.end() )
-                    return itr->second;
+               if( const auto* itr = _object_to_iterator.find( &obj ) )
+                    return *itr;
 
                _iterator_to_object.push_back( &obj );
-               _object_to_iterator[&obj] = _iterator_to_object.size() - 1;
+               _object_to_iterator.set( &obj, _iterator_to_object.size() - 1 );
 
                return _iterator_to_object.size() - 1;
             }
 
          private:
-            map<table_id_object::id_type, pair<const table_id_object*, int>> _table_cache;
-            vector<const table_id_object*>                  _end_iterator_to_table;
-            vector<const T*>                                _iterator_to_object;
-            map<const T*,int>                               _object_to_iterator;
+            flat_hash_map<int64_t, pair<const table_id_object*, int>> _table_cache;
+            vector<const table_id_object*>                            _end_iterator_to_table;
+            vector<const T*>                                          _iterator_to_object;
+            flat_hash_map<const T*, int>                              _object_to_iterator;
 
             /// Precondition: std::numeric_limits<int>::min() < ei < -1
             /// Iterator of -1 is reserved for invalid iterators (i.e. when the appropriate table has not yet been created).
@@ -197,6 +201,7 @@ class apply_context {
                });
 
                context.update_db_usage( payer, config::billable_size_v<ObjectType> );
+               update_table_stats( context.db, tab.code, tab.table, {0, 1, 0, config::billable_size_v<ObjectType>} );
 
                itr_cache.cache_table( tab );
                return itr_cache.add( obj );
@@ -211,6 +216,9 @@ class apply_context {
 
 //               context.require_write_lock( table_obj.scope );
 
+               update_table_stats( context.db, table_obj.code, table_obj.table,
+                                   {0, -1, 0, -(int64_t)config::billable_size_v<ObjectType>} );
+
                context.db.modify( table_obj, [&]( auto& t ) {
                   --t.count;
                });
@@ -522,8 +530,12 @@ class apply_context {
    public:
 
       void reset_console();
-      std::ostringstream& get_console_stream()            { return _pending_console_output; }
-      const std::ostringstream& get_console_stream()const { return _pending_console_output; }
+      arena_ostringstream& get_console_stream()            { return _pending_console_output; }
+      const arena_ostringstream& get_console_stream()const { return _pending_console_output; }
+      std::string pending_console()const {
+         const auto s = _pending_console_output.str();
+         return std::string( s.data(), s.size() );
+      }
 
       template<typename T>
       void console_append(T val) {
@@ -562,6 +574,8 @@ class apply_context {
       int  db_upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
       int  db_end_i64( uint64_t code, uint64_t scope, uint64_t table );
 
+      int  db_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t& lower, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size );
+      int  db_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t& secondary, uint64_t& primary, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size );
 
       int  db_store_i256( uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size );
       int  db_store_i256( uint64_t code, uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size );
@@ -591,6 +605,18 @@ class apply_context {
       const table_id_object& find_or_create_table( name code, name scope, name table, const account_name &payer );
       void                   remove_table( const table_id_object& tid );
 
+      struct table_key {
+         uint64_t code;
+         uint64_t scope;
+         uint64_t table;
+
+         bool operator==( const table_key& k )const { return code == k.code && scope == k.scope && table == k.table; }
+      };
+
+      struct table_key_hash {
+         size_t operator()( const table_key& k )const { return mix_hash( k.code ^ mix_hash( k.scope ^ mix_hash( k.table ) ) ); }
+      };
+
 
 
    /// Misc methods:
@@ -622,7 +648,7 @@ class apply_context {
       transaction_context&          trx_context; ///< transaction context in which the action is running
       const action&                 act; ///< message being applied
       account_name                  receiver; ///< the code that is currently running
-      vector<bool> used_authorizations; ///< Parallel to act.authorization; tracks which permissions have been used while processing the message
+      vector<bool, arena_allocator<bool>> used_authorizations; ///< Parallel to act.authorization; tracks which permissions have been used while processing the message
       uint32_t                      recurse_depth; ///< how deep inline actions can recurse
       bool                          privileged   = false;
       bool                          context_free = false;
@@ -637,10 +663,12 @@ class apply_context {
    private:
       iterator_cache<key256_value_object>    key256val_cache;
       iterator_cache<key_value_object>    keyval_cache;
-      vector<account_name>                _notified; ///< keeps track of new accounts to be notifed of current message
-      vector<action>                      _inline_actions; ///< queued inline messages
-      vector<action>                      _cfa_inline_actions; ///< queued inline messages
-      std::ostringstream                  _pending_console_output;
+      /// tables found or created by this action, every table create and remove of the action goes through find_or_create_table and remove_table
+      flat_hash_map<table_key, const table_id_object*, table_key_hash> _table_memo;
+      arena_vector<account_name>          _notified; ///< keeps track of new accounts to be notifed of current message
+      arena_vector<action>                _inline_actions; ///< queued inline messages
+      arena_vector<action>                _cfa_inline_actions; ///< queued inline messages
+      arena_ostringstream                 _pending_console_output;
       flat_set<account_delta>             _account_ram_deltas; ///< flat_set of account_delta so json is an array of objects
 
       //bytes                               _cached_trx;
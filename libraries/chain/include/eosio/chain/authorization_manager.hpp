@@ -10,6 +10,7 @@
 
 #include <utility>
 #include <functional>
+#include <tuple>
 
 namespace eosio { namespace chain {
 
@@ -56,6 +57,16 @@ namespace eosio { namespace chain {
          const permission_object*  find_permission( const permission_level& level )const;
          const permission_object&  get_permission( const permission_level& level )const;
 
+         /**
+          *  Authorities and permission links resolved while checking authorizations are kept until the
+          *  end of the pending block, so transactions using the same permissions skip the database.
+          *
+          *  Any change to a permission or a link clears the cache and bypasses it for the rest of the
+          *  block, as an undone transaction could otherwise leave stale entries behind.
+          */
+         void reset_authority_cache();
+         void invalidate_authority_cache();
+
          /**
           * @brief Find the lowest authority level required for @ref authorizer_account to authorize a message of the
           * specified type
@@ -131,6 +142,17 @@ namespace eosio { namespace chain {
                                                              scope_name code_account,
                                                              action_name type
                                                            )const;
+
+         const authority& get_authority( const permission_level& level )const;
+         void             begin_authority_lookups()const;
+
+         struct authority_cache {
+            bool                                                                           enabled = true;
+            map<permission_level, authority>                                               authorities;
+            map<std::tuple<account_name, scope_name, action_name>, optional<permission_name>> links;
+         };
+
+         mutable authority_cache _authority_cache;
    };
 
 } } /// namespace eosio::chain
@@ -99,6 +99,7 @@ const static uint32_t   hashing_checktime_block_size       = 10*1024;  /// call
 
 const static eosio::chain::wasm_interface::vm_type default_wasm_runtime = eosio::chain::wasm_interface::vm_type::wabt;
 const static uint32_t   default_abi_serializer_max_time_ms = 15*1000; ///< default deadline for abi serialization methods
+const static uint32_t   default_signature_cache_size = 50*1000; ///< recovered public keys kept in the signature recovery cache
 
 /**
  *  The number of sequential blocks produced by a single producer
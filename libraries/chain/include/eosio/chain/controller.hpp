@@ -7,6 +7,7 @@
 #include <eosio/chain/abi_serializer.hpp>
 #include <eosio/chain/account_object.hpp>
 #include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/state_mapping.hpp>
 
 namespace chainbase {
    class database;
@@ -61,6 +62,7 @@ namespace eosio { namespace chain {
             path                     state_dir              =  chain::config::default_state_dir_name;
             uint64_t                 state_size             =  chain::config::default_state_size;
             uint64_t                 state_guard_size       =  chain::config::default_state_guard_size;
+            state_mapping_config     state_mapping;
             uint64_t                 reversible_cache_size  =  chain::config::default_reversible_cache_size;
             uint64_t                 reversible_guard_size  =  chain::config::default_reversible_guard_size;
             bool                     read_only              =  false;
@@ -209,6 +211,22 @@ namespace eosio { namespace chain {
          sha256 calculate_integrity_hash()const;
          void write_snapshot( const snapshot_writer_ptr& snapshot )const;
 
+         /**
+          * A reflink copy of the state database taken at the head block, a snapshot can be written from it on
+          * another thread while this controller keeps applying blocks. pin_state throws snapshot_exception
+          * when the state directory is on a filesystem without reflink support.
+          */
+         struct pinned_state {
+            fc::path             state_dir;
+            uint64_t             state_size = 0;
+            uint64_t             row_count = 0;   ///< rows in the chain and contract table indices, for progress
+            block_header_state   head;
+            genesis_state        genesis;
+         };
+
+         pinned_state pin_state( const fc::path& dir )const;
+         void write_snapshot( const pinned_state& pin, const snapshot_writer_ptr& snapshot );
+
          void check_contract_list( account_name code )const;
          void check_action_list( account_name code, action_name action )const;
          void check_key_list( const public_key_type& key )const;
@@ -310,6 +328,7 @@ FC_REFLECT( eosio::chain::controller::config,
             (blocks_dir)
             (state_dir)
             (state_size)
+            (state_mapping)
             (reversible_cache_size)
             (read_only)
             (force_all_checks)
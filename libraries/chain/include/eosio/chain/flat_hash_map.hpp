@@ -0,0 +1,134 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace eosio { namespace chain {
+
+   /// 64 bit mixer (the murmur3 finalizer), pointers and chainbase ids are too regular to be used as hashes
+   inline size_t mix_hash( uint64_t h ) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return size_t(h);
+   }
+
+   template<typename Key>
+   struct flat_hash {
+      size_t operator()( const Key& k )const { return mix_hash( uint64_t(k) ); }
+   };
+
+   template<typename T>
+   struct flat_hash<T*> {
+      size_t operator()( T* p )const { return mix_hash( uint64_t(reinterpret_cast<uintptr_t>(p)) ); }
+   };
+
+   /**
+    * Open addressing hash map with linear probing, for the small maps filled and thrown away within one action.
+    * The slots live in a single vector kept at most half full, so a lookup is usually one cache line
+    * and inserting does not allocate until the table grows. Erased slots are left as tombstones
+    * until the next rehash.
+    *
+    * Key and Value must be default constructible and copyable, pointers to values are invalidated by insertion.
+    */
+   template<typename Key, typename Value, typename Hash = flat_hash<Key>>
+   class flat_hash_map {
+      public:
+         flat_hash_map( size_t capacity = 16 ) {
+            size_t n = 8;
+            while( n < capacity * 2 ) n <<= 1;
+            _slots.resize( n );
+         }
+
+         Value* find( const Key& k ) {
+            auto i = probe( k );
+            return _slots[i].state == used ? &_slots[i].value : nullptr;
+         }
+
+         const Value* find( const Key& k )const {
+            return const_cast<flat_hash_map*>(this)->find( k );
+         }
+
+         /// Inserts or overwrites the value of k
+         Value& set( const Key& k, const Value& v ) {
+            if( (_used + 1) * 2 > _slots.size() ) {
+               rehash( _size * 4 > _slots.size() ? _slots.size() * 2 : _slots.size() );
+            }
+            auto i = probe( k );
+            auto& s = _slots[i];
+            if( s.state != used ) {
+               if( s.state == free_slot ) ++_used;
+               s.state = used;
+               s.key = k;
+               ++_size;
+            }
+            s.value = v;
+            return s.value;
+         }
+
+         bool erase( const Key& k ) {
+            auto i = probe( k );
+            if( _slots[i].state != used ) return false;
+            _slots[i].state = erased;
+            _slots[i].value = Value();
+            --_size;
+            return true;
+         }
+
+         void clear() {
+            for( auto& s : _slots ) s = slot();
+            _size = 0;
+            _used = 0;
+         }
+
+         size_t size()const { return _size; }
+         bool empty()const { return _size == 0; }
+
+      private:
+         enum slot_state : uint8_t { free_slot, used, erased };
+
+         struct slot {
+            Key        key   = Key();
+            Value      value = Value();
+            slot_state state = free_slot;
+         };
+
+         /// Slot holding k, or the slot to insert k in: the first tombstone on its probe sequence if any
+         size_t probe( const Key& k )const {
+            size_t mask = _slots.size() - 1;
+            size_t i = Hash()( k ) & mask;
+            size_t first_erased = _slots.size();
+            while( true ) {
+               const auto& s = _slots[i];
+               if( s.state == free_slot ) return first_erased < _slots.size() ? first_erased : i;
+               if( s.state == used && s.key == k ) return i;
+               if( s.state == erased && first_erased == _slots.size() ) first_erased = i;
+               i = (i + 1) & mask;
+            }
+         }
+
+         void rehash( size_t capacity ) {
+            std::vector<slot> old( capacity );
+            old.swap( _slots );
+            _size = 0;
+            _used = 0;
+            for( const auto& s : old ) {
+               if( s.state == used ) set( s.key, s.value );
+            }
+         }
+
+         std::vector<slot> _slots;
+         size_t            _size = 0; ///< live entries
+         size_t            _used = 0; ///< live entries and tombstones
+   };
+
+} } // namespace eosio::chain
@@ -24,6 +24,8 @@ public:
       return *_inst;
    }
    int get_wasm_runtime_type();
+   //for programs that run a controller without appbase options, e.g. replay-bench
+   void set_wasm_runtime_type(vm_type runtime);
    bool is_contracts_console_enabled();
    ~options();
 private:
@@ -0,0 +1,25 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <stddef.h>
+
+namespace eosio { namespace chain {
+
+   /**
+    *  Hashes `count` independent 64 byte messages stored back to back in `in` and writes their
+    *  32 byte sha256 digests back to back to `out`, `in` and `out` must not overlap.
+    *
+    *  The implementation is picked once for the running cpu: SHA-NI, 8 lane AVX2 or plain C++.
+    */
+   void sha256_batch_64( const char* in, size_t count, char* out );
+
+   /// name of the implementation in use
+   const char* sha256_batch_impl();
+
+   /// switches to the named implementation ("shani", "avx2" or "generic"), returns false if the cpu lacks it
+   bool set_sha256_batch_impl( const char* name );
+
+} } /// eosio::chain
@@ -0,0 +1,37 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+namespace eosio { namespace chain {
+
+   /**
+    *  Process wide cache of public keys recovered from (signature, digest) pairs.
+    *
+    *  Every path recovering transaction signatures goes through it (incoming transactions, block
+    *  production and block validation), so a signature is recovered once per node while it stays
+    *  cached.  Entries are spread over independently locked shards, each evicting its least recently
+    *  used entries, and the recovery itself runs outside of any lock.
+    */
+   class signature_recovery_cache {
+      public:
+         struct stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t size = 0;
+            uint64_t capacity = 0;
+         };
+
+         static public_key_type recover( const signature_type& sig, const digest_type& digest );
+
+         /// total number of entries over all shards, 0 disables caching
+         static void   set_capacity( size_t entries );
+         static stats  get_stats();
+   };
+
+} } /// eosio::chain
+
+FC_REFLECT( eosio::chain::signature_recovery_cache::stats, (hits)(misses)(size)(capacity) )
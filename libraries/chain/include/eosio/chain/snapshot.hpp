@@ -7,15 +7,26 @@
 #include <eosio/chain/database_utils.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <fc/variant_object.hpp>
+#include <fc/io/datastream.hpp>
 #include <boost/core/demangle.hpp>
 #include <ostream>
+#include <deque>
+#include <future>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace eosio { namespace chain {
    /**
     * History:
     * Version 1: initial version with string identified sections and rows
+    * Version 2: binary only, rows of a section are packed into independently compressed and checksummed chunks
     */
    static const uint32_t current_snapshot_version = 1;
+   static const uint32_t chunked_snapshot_version = 2;
 
    namespace detail {
       template<typename T>
@@ -71,10 +82,74 @@ namespace eosio { namespace chain {
          std::ostream& inner;
       };
 
+      /**
+       * appends packed rows to the in-memory chunk of a chunked snapshot
+       */
+      struct chunk_wrapper {
+         explicit chunk_wrapper(bytes& b)
+         :inner(b) {
+
+         }
+
+         void write( const char* d, size_t s ) {
+            inner.insert(inner.end(), d, d + s);
+         }
+
+         void put(char c) {
+           inner.push_back(c);
+         }
+
+         size_t tellp() const {
+            return inner.size();
+         }
+
+         bytes& inner;
+      };
+
+      struct snapshot_chunk {
+         static const uint8_t compression_none = 0;
+         static const uint8_t compression_zlib = 1;
+
+         uint32_t   rows = 0;
+         uint32_t   raw_size = 0;
+         uint8_t    compression = compression_none;
+         fc::sha256 hash;
+         bytes      data;
+      };
+
+      /**
+       * Fixed set of threads started with a chunked reader or writer, its chunks are queued to them
+       * rather than each starting a thread.  Queued jobs still run when it is destroyed.
+       */
+      class chunk_workers {
+         public:
+            explicit chunk_workers( uint32_t threads );
+            ~chunk_workers();
+
+            template<typename F>
+            auto post( F&& f ) -> std::future<decltype(f())> {
+               auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::forward<F>(f));
+               auto result = task->get_future();
+               enqueue([task]() { (*task)(); });
+               return result;
+            }
+
+         private:
+            void enqueue( std::function<void()> job );
+            void run();
+
+            std::mutex                        lock;
+            std::condition_variable           cond;
+            std::deque<std::function<void()>> jobs;
+            std::vector<std::thread>          threads;
+            bool                              stopping = false;
+      };
+
 
       struct abstract_snapshot_row_writer {
          virtual void write(ostream_wrapper& out) const = 0;
          virtual void write(fc::sha256::encoder& out) const = 0;
+         virtual void write(chunk_wrapper& out) const = 0;
          virtual variant to_variant() const = 0;
          virtual std::string row_type_name() const = 0;
       };
@@ -97,6 +172,10 @@ namespace eosio { namespace chain {
             write_stream(out);
          }
 
+         void write(chunk_wrapper& out) const override {
+            write_stream(out);
+         }
+
          fc::variant to_variant() const override {
             variant var;
             fc::to_variant(data, var);
@@ -161,6 +240,7 @@ namespace eosio { namespace chain {
    namespace detail {
       struct abstract_snapshot_row_reader {
          virtual void provide(std::istream& in) const = 0;
+         virtual void provide(fc::datastream<const char*>& in) const = 0;
          virtual void provide(const fc::variant&) const = 0;
          virtual std::string row_type_name() const = 0;
       };
@@ -206,6 +286,12 @@ namespace eosio { namespace chain {
             });
          }
 
+         void provide(fc::datastream<const char*>& in) const override {
+            row_validation_helper::apply(data, [&in,this](){
+               fc::raw::unpack(in, data);
+            });
+         }
+
          void provide(const fc::variant& var) const override {
             row_validation_helper::apply(data, [&var,this]() {
                fc::from_variant(var, data);
@@ -366,6 +452,77 @@ namespace eosio { namespace chain {
          uint64_t       cur_row;
    };
 
+   /**
+    * Writes the version 2 binary format.  Rows are packed into chunks of about chunk_size bytes on the
+    * calling thread, chunks are then compressed and hashed on up to `threads` worker threads while the
+    * next one is filled, and written to the stream in order.
+    */
+   class chunked_ostream_snapshot_writer : public snapshot_writer {
+      public:
+         explicit chunked_ostream_snapshot_writer(std::ostream& snapshot, uint32_t threads = 0, bool compress = true);
+
+         void write_start_section( const std::string& section_name ) override;
+         void write_row( const detail::abstract_snapshot_row_writer& row_writer ) override;
+         void write_end_section( ) override;
+         void finalize();
+
+         /// rows written so far, safe to read from another thread for progress reporting
+         uint64_t rows_written() const { return total_rows.load(std::memory_order_relaxed); }
+
+         static const size_t chunk_size = 4*1024*1024;
+
+      private:
+         void flush_chunk();
+         void write_chunks( size_t max_pending );
+
+         std::ostream&                                   snapshot;
+         std::streampos                                  section_pos;
+         uint64_t                                        row_count;
+         uint64_t                                        chunk_count;
+         uint32_t                                        threads;
+         bool                                            compress;
+         detail::snapshot_chunk                          current;
+         std::deque<std::future<detail::snapshot_chunk>> pending;
+         std::atomic<uint64_t>                           total_rows{0};
+         detail::chunk_workers                           workers;
+   };
+
+   /**
+    * Reads the version 2 binary format.  Chunks of the current section are read ahead and
+    * decompressed and verified on worker threads, rows are unpacked on the calling thread.
+    */
+   class chunked_istream_snapshot_reader : public snapshot_reader {
+      public:
+         explicit chunked_istream_snapshot_reader(std::istream& snapshot, uint32_t threads = 0);
+
+         void validate() const override;
+         bool has_section( const string& section_name ) override;
+         void set_section( const string& section_name ) override;
+         bool read_row( detail::abstract_snapshot_row_reader& row_reader ) override;
+         bool empty ( ) override;
+         void clear_section() override;
+
+      private:
+         bool validate_section() const;
+         void fetch_chunks();
+
+         std::istream&                                   snapshot;
+         std::streampos                                  header_pos;
+         uint64_t                                        num_rows;
+         uint64_t                                        cur_row;
+         uint64_t                                        chunks_left;
+         uint32_t                                        threads;
+         detail::snapshot_chunk                          current;
+         size_t                                          current_pos;
+         std::deque<std::future<detail::snapshot_chunk>> pending;
+         detail::chunk_workers                           workers;
+   };
+
+   /**
+    * opens a binary snapshot with the reader matching its version
+    */
+   snapshot_reader_ptr make_istream_snapshot_reader(std::istream& snapshot);
+
    class integrity_hash_snapshot_writer : public snapshot_writer {
       public:
          explicit integrity_hash_snapshot_writer(fc::sha256::encoder&  enc);
@@ -380,4 +537,30 @@ namespace eosio { namespace chain {
 
    };
 
+   /**
+    * Integrity hash computed as a two level tree: rows are cut into fixed size chunks regardless of
+    * sections, chunks are hashed in parallel and the result is the hash of the ordered chunk hashes.
+    * The chunk size is part of the hash definition and must not change.
+    */
+   class chunked_integrity_hash_snapshot_writer : public snapshot_writer {
+      public:
+         explicit chunked_integrity_hash_snapshot_writer(uint32_t threads = 0);
+
+         void write_start_section( const std::string& section_name ) override;
+         void write_row( const detail::abstract_snapshot_row_writer& row_writer ) override;
+         void write_end_section( ) override;
+         fc::sha256 finalize();
+
+         static const size_t chunk_size = 1024*1024;
+
+      private:
+         void flush_chunk();
+
+         uint32_t                            threads;
+         bytes                               current;
+         std::vector<fc::sha256>             hashes;
+         std::deque<std::future<fc::sha256>> pending;
+         detail::chunk_workers               workers;
+   };
+
 }}
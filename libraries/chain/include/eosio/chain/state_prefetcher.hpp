@@ -0,0 +1,59 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <eosio/chain/action.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/transaction.hpp>
+
+namespace eosio { namespace chain {
+
+   /**
+    *  Process wide prefetcher of the contract table rows a transaction is about to read.
+    *
+    *  apply_context reports the rows every action looks up. For each (contract, action) the lookups are kept as
+    *  patterns whose code, scope and primary key are a constant, the action's account or an 8 byte word of the
+    *  action data (the from and to of eosio.token::transfer for instance), and the addresses of the rows in the
+    *  state file are remembered. Predicted rows are only located through these addresses, chainbase itself is
+    *  never read outside of the thread applying transactions.
+    *
+    *  schedule() hands the pages of the predicted rows to a helper thread which madvise(WILLNEED)s them, so a
+    *  state file larger than memory is read ahead of the transactions of a block. prefetch() issues cache
+    *  prefetches for them on the calling thread right before a transaction runs, so that their misses overlap
+    *  instead of being taken one lookup at a time. Inline actions are not predicted. Disabled by default.
+    */
+   class state_prefetcher {
+      public:
+         struct stats {
+            uint64_t recorded = 0;  ///< row lookups reported
+            uint64_t patterns = 0;  ///< patterns currently kept
+            uint64_t rows = 0;      ///< row addresses currently kept
+            uint64_t predicted = 0; ///< rows predicted for the transactions prefetched
+            uint64_t located = 0;   ///< predicted rows found in the row addresses
+            uint64_t scheduled = 0; ///< rows handed to the helper thread
+            uint64_t dropped = 0;   ///< rows not handed over because the helper thread was behind
+         };
+
+         /// starts or stops the helper thread, patterns and row addresses are kept while disabled
+         static void set_enabled( bool enabled );
+         static bool enabled();
+
+         /// a lookup of primary in tab by act, row is the row found if any
+         static void record( const action& act, const table_id_object& tab, uint64_t primary, const key_value_object* row );
+         static void forget( const table_id_object& tab, uint64_t primary );
+
+         /// predicts the rows of trx and lets the helper thread fault their pages in
+         static void schedule( const transaction& trx );
+         /// predicts the rows of trx and prefetches them into the cache of the calling thread
+         static void prefetch( const transaction& trx );
+
+         static stats get_stats();
+         /// drops the patterns, the row addresses and the counters
+         static void reset();
+   };
+
+} } /// eosio::chain
+
+FC_REFLECT( eosio::chain::state_prefetcher::stats, (recorded)(patterns)(rows)(predicted)(located)(scheduled)(dropped) )
@@ -0,0 +1,88 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <eosio/chain/database_utils.hpp>
+#include <eosio/chain/multi_index_includes.hpp>
+
+namespace eosio { namespace chain {
+
+   /**
+    * @brief Running totals of the rows a contract keeps in one table, summed over all scopes
+    *
+    * The db intrinsics adjust these as rows are stored, updated and removed, so they are undone together
+    * with the rows.  Secondary index tables are named after their primary table with the index number in
+    * the low 4 bits, so stats are keyed by the table name with those bits cleared.
+    *
+    * The stats are derived data: they are not part of snapshots or the integrity hash and are rebuilt
+    * from the contract tables when the index is empty.
+    */
+   class table_stats_object : public chainbase::object<table_stats_object_type, table_stats_object> {
+      OBJECT_CTOR(table_stats_object)
+
+      id_type        id;
+      account_name   code;
+      table_name     table;
+      uint64_t       rows = 0;           /// primary rows, in key_value_object and key256_value_object
+      uint64_t       secondary_rows = 0; /// rows in all secondary indices
+      uint64_t       payload_bytes = 0;  /// size of the primary row values
+      uint64_t       ram_bytes = 0;      /// billable size of all rows, as charged to the payers
+   };
+
+   struct by_code_table;
+
+   using table_stats_index = chainbase::shared_multi_index_container<
+      table_stats_object,
+      indexed_by<
+         ordered_unique<tag<by_id>,
+            member<table_stats_object, table_stats_object::id_type, &table_stats_object::id>
+         >,
+         ordered_unique<tag<by_code_table>,
+            composite_key< table_stats_object,
+               member<table_stats_object, account_name, &table_stats_object::code>,
+               member<table_stats_object, table_name,   &table_stats_object::table>
+            >
+         >
+      >
+   >;
+
+   inline table_name table_stats_key( table_name table ) {
+      return table_name(table.value & 0xFFFFFFFFFFFFFFF0ULL);
+   }
+
+   struct table_stats_delta {
+      int64_t rows = 0;
+      int64_t secondary_rows = 0;
+      int64_t payload_bytes = 0;
+      int64_t ram_bytes = 0;
+   };
+
+   inline void update_table_stats( chainbase::database& db, account_name code, table_name table, const table_stats_delta& delta ) {
+      table = table_stats_key(table);
+      const auto* stats = db.find<table_stats_object, by_code_table>(boost::make_tuple(code, table));
+      if( stats == nullptr ) {
+         stats = &db.create<table_stats_object>([&]( auto& s ) {
+            s.code = code;
+            s.table = table;
+         });
+      }
+
+      db.modify( *stats, [&]( auto& s ) {
+         s.rows           += delta.rows;
+         s.secondary_rows += delta.secondary_rows;
+         s.payload_bytes  += delta.payload_bytes;
+         s.ram_bytes      += delta.ram_bytes;
+      });
+
+      if( stats->rows == 0 && stats->secondary_rows == 0 ) {
+         db.remove( *stats );
+      }
+   }
+
+} }  // namespace eosio::chain
+
+CHAINBASE_SET_INDEX_TYPE(eosio::chain::table_stats_object, eosio::chain::table_stats_index)
+
+FC_REFLECT(eosio::chain::table_stats_object, (code)(table)(rows)(secondary_rows)(payload_bytes)(ram_bytes) )
@@ -0,0 +1,117 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <fc/reflect/reflect.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace eosio { namespace chain {
+
+   /**
+    *  Per thread monotonic arena for the short lived containers of transaction execution.
+    *
+    *  transaction_context opens a scope on the arena of its thread around each top level action it dispatches,
+    *  allocations made while it is open are bumped out of chunks the arena keeps from one action to the next,
+    *  and are all released at once when the outermost scope closes. Memory is never handed back in between, so
+    *  only containers that do not outlive the action (those of apply_context) draw from it.
+    */
+   class transaction_arena {
+      public:
+         struct stats {
+            uint64_t releases = 0;          ///< outermost scopes closed
+            uint64_t last_bytes = 0;        ///< bytes drawn before the last release
+            uint64_t high_water_bytes = 0;  ///< most bytes drawn between two releases
+            uint64_t reserved_bytes = 0;    ///< chunks kept by the arenas of all threads
+            uint64_t chunk_allocations = 0; ///< chunks allocated from the heap
+         };
+
+         /// the arena of the calling thread while a scope is open on it, null otherwise
+         static transaction_arena* current();
+
+         void* allocate( size_t bytes, size_t alignment );
+
+         static stats get_stats();
+         static void  reset_stats();
+
+         class scope {
+            public:
+               scope();
+               ~scope();
+
+               scope( const scope& ) = delete;
+               scope& operator=( const scope& ) = delete;
+         };
+
+         ~transaction_arena();
+
+      private:
+         struct chunk {
+            char*  begin;
+            size_t size;
+         };
+
+         void release();
+         void add_chunk( size_t min_size );
+
+         std::vector<chunk> chunks;
+         size_t             active = 0;  ///< index of the chunk allocations are bumped from
+         char*              next = nullptr;
+         char*              end = nullptr;
+         size_t             used = 0;    ///< bytes drawn since the arena was last released
+         uint32_t           depth = 0;   ///< scopes open
+   };
+
+   /**
+    *  Draws from the arena of the thread that constructs it when a scope is open there, from the heap
+    *  otherwise. Deallocation is a no-op for arena memory.
+    */
+   template<typename T>
+   class arena_allocator {
+      public:
+         typedef T value_type;
+         typedef std::true_type propagate_on_container_move_assignment;
+         typedef std::true_type propagate_on_container_swap;
+
+         arena_allocator() noexcept : arena( transaction_arena::current() ) {}
+         template<typename U>
+         arena_allocator( const arena_allocator<U>& o ) noexcept : arena( o.arena ) {}
+
+         T* allocate( size_t n ) {
+            if( arena )
+               return static_cast<T*>( arena->allocate( n * sizeof(T), alignof(T) ) );
+            return std::allocator<T>().allocate( n );
+         }
+
+         void deallocate( T* p, size_t n ) {
+            if( !arena )
+               std::allocator<T>().deallocate( p, n );
+         }
+
+         template<typename U>
+         bool operator==( const arena_allocator<U>& o )const { return arena == o.arena; }
+         template<typename U>
+         bool operator!=( const arena_allocator<U>& o )const { return arena != o.arena; }
+
+      private:
+         template<typename U> friend class arena_allocator;
+
+         transaction_arena* arena;
+   };
+
+   template<typename T>
+   using arena_vector = std::vector<T, arena_allocator<T>>;
+
+   typedef std::basic_string<char, std::char_traits<char>, arena_allocator<char>>        arena_string;
+   typedef std::basic_ostringstream<char, std::char_traits<char>, arena_allocator<char>> arena_ostringstream;
+
+} } /// eosio::chain
+
+FC_REFLECT( eosio::chain::transaction_arena::stats, (releases)(last_bytes)(high_water_bytes)(reserved_bytes)(chunk_allocations) )
@@ -179,6 +179,7 @@ namespace eosio { namespace chain {
       reversible_block_object_type,
       action_object_type,
       key256_value_object_type,
+      table_stats_object_type,
       OBJECT_TYPE_COUNT ///< Sentry value which contains the number of different object types
    };
 
@@ -65,6 +65,8 @@ namespace eosio { namespace chain {
          int apply(uint64_t receiver, uint64_t account, uint64_t act);
          bool init();
          int preload(uint64_t account);
+         //compiles code supplied by the caller, without touching the chain state
+         int preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size);
          int unload(uint64_t account);
 
          //Immediately exits currently running wasm. UB is called when no wasm running
@@ -21,6 +21,8 @@
 #include <fc/scoped_exit.hpp>
 #include <fc/io/fstream.hpp>
 
+#include <eosiolib_native/vm_profile.h>
+
 #include "IR/Module.h"
 #include "Runtime/Intrinsics.h"
 #include "Platform/Platform.h"
@@ -38,6 +40,8 @@ using namespace Runtime;
 
 void resume_billing_timer();
 void pause_billing_timer();
+void vm_profile_begin(int phase);
+void vm_profile_end(int phase);
 
 extern "C" const char* get_code( uint64_t receiver, size_t* size );
 extern "C" int get_code_id( uint64_t account, char* code_id, size_t size );
@@ -109,22 +113,21 @@ namespace eosio { namespace chain {
 
          auto timer_pause = fc::make_scoped_exit([&](){
             if (!preload) {
+               vm_profile_end(VM_PROFILE_LOAD);
                resume_billing_timer();
             }
          });
          if (!preload) {
             pause_billing_timer();
+            vm_profile_begin(VM_PROFILE_LOAD);
          }
          return load_module(receiver, code, size);
       }
 
 
-       void load_module_async(uint64_t receiver, const char* code, size_t size) {
-          load_module(receiver, code, size);
-          //send a transaction to indicate that module is loaded by BP.
-       }
-
-      std::unique_ptr<wasm_instantiated_module_interface>& load_module(uint64_t receiver, const char* code, size_t size) {
+      //code_id may be passed in by callers that already have it, such as vm_manager's background
+      //compile pool, which must not read the chain state
+      std::unique_ptr<wasm_instantiated_module_interface>& load_module(uint64_t receiver, const char* code, size_t size, const char* code_id = nullptr) {
          IR::Module module;
          try {
             Serialization::MemoryInputStream stream((const U8*)code, size);
@@ -153,9 +156,11 @@ namespace eosio { namespace chain {
             std::lock_guard<std::mutex> lock(m);
             instantiation_cache[receiver] = runtime_interface->instantiate_module((const char*)bytes.data(), bytes.size(), parse_initial_memory(module));
             auto it = instantiation_cache.find(receiver);
-            char code_id[8*4];
-            get_code_id(receiver, code_id, sizeof(code_id));
-            memcpy(it->second->code_id, code_id, sizeof(code_id));
+            if (code_id) {
+               memcpy(it->second->code_id, code_id, sizeof(it->second->code_id));
+            } else {
+               get_code_id(receiver, it->second->code_id, sizeof(it->second->code_id));
+            }
             return it->second;
          }
       }
@@ -54,8 +54,11 @@ inline array_ptr<T> array_ptr_impl (running_instance_context& ctx, U32 ptr, size
    if (!mem)
       Runtime::causeException(Exception::Cause::accessViolation);
 
-   size_t mem_total = IR::numBytesPerPage * Runtime::getMemoryNumPages(mem);
-   if (ptr >= mem_total || length > (mem_total - ptr) / sizeof(T))
+   //same bounds as ptr >= mem_total || length > (mem_total - ptr) / sizeof(T), without the division
+   //and with a single branch. length may be a sign extended I32, the middle term keeps the product
+   //from mattering when it wraps.
+   const uint64_t mem_total = IR::numBytesPerPage * Runtime::getMemoryNumPages(mem);
+   if ((ptr >= mem_total) | (length > mem_total) | (uint64_t(ptr) + uint64_t(length) * sizeof(T) > mem_total))
       Runtime::causeException(Exception::Cause::accessViolation);
 
 //   T* ret_ptr = (T*)(getMemoryBaseAddress(mem) + ptr);
@@ -73,11 +76,9 @@ inline null_terminated_ptr null_terminated_ptr_impl(running_instance_context& ct
       Runtime::causeException(Exception::Cause::accessViolation);
 
    char *value                     = (char*)(getMemoryBaseAddress(mem) + ptr);
-   const char* p                   = value;
    const char* const top_of_memory = (char*)(getMemoryBaseAddress(mem) + IR::numBytesPerPage*Runtime::getMemoryNumPages(mem));
-   while(p < top_of_memory)
-      if(*p++ == '\0')
-         return null_terminated_ptr(value);
+   if(value < top_of_memory && memchr(value, '\0', top_of_memory - value))
+      return null_terminated_ptr(value);
 
    Runtime::causeException(Exception::Cause::accessViolation);
 }
@@ -274,6 +275,33 @@ constexpr bool is_reference_from_value_v = is_reference_from_value<T>::value;
 struct void_type {
 };
 
+/**
+ * aligned copy of a misaligned in-wasm-memory array, kept on the stack unless it is large
+ * @tparam T - the element type
+ */
+template<typename T>
+struct misaligned_copy {
+   static constexpr size_t inline_count = 512 / sizeof(T) > 0 ? 512 / sizeof(T) : 1;
+
+   misaligned_copy(const void* src, size_t length) : length(length) {
+      if (length > inline_count)
+         heap.resize(length);
+      memcpy( (void*)data(), src, length * sizeof(T) );
+   }
+
+   T* data() {
+      return heap.size() ? heap.data() : inline_buffer;
+   }
+
+   void write_back(void* dst) {
+      memcpy( dst, (void*)data(), length * sizeof(T) );
+   }
+
+   size_t length;
+   T inline_buffer[inline_count];
+   std::vector<T> heap;
+};
+
 /**
  * Forward declaration of provider for FunctionType given a desired C ABI signature
  */
@@ -387,10 +415,8 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>,
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          if(get_vm_api()->contracts_console())
             wlog( "misaligned array of const values" );
-         std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
-         T* copy_ptr = &copy[0];
-         memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
-         return Then(ctx, static_cast<array_ptr<T>>(copy_ptr), length, rest..., translated...);
+         misaligned_copy<std::remove_const_t<T>> copy(base, length);
+         return Then(ctx, static_cast<array_ptr<T>>(copy.data()), length, rest..., translated...);
       }
       return Then(ctx, static_cast<array_ptr<T>>(base), length, rest..., translated...);
    };
@@ -403,11 +429,9 @@ struct intrinsic_invoker_impl<Ret, std::tuple<array_ptr<T>, size_t, Inputs...>,
       if ( reinterpret_cast<uintptr_t>(base) % alignof(T) != 0 ) {
          if(get_vm_api()->contracts_console())
             wlog( "misaligned array of values" );
-         std::vector<std::remove_const_t<T> > copy(length > 0 ? length : 1);
-         T* copy_ptr = &copy[0];
-         memcpy( (void*)copy_ptr, (void*)base, length * sizeof(T) );
-         Ret ret = Then(ctx, static_cast<array_ptr<T>>(copy_ptr), length, rest..., translated...);
-         memcpy( (void*)base, (void*)copy_ptr, length * sizeof(T) );
+         misaligned_copy<T> copy(base, length);
+         Ret ret = Then(ctx, static_cast<array_ptr<T>>(copy.data()), length, rest..., translated...);
+         copy.write_back(base);
          return ret;
       }
       return Then(ctx, static_cast<array_ptr<T>>(base), length, rest..., translated...);
@@ -640,8 +664,10 @@ struct intrinsic_function_invoker {
 
    template<MethodSig Method>
    static Ret wrapper(running_instance_context& ctx, Params... params) {
-      class_from_wasm<Cls>::value().checktime();
-      return (class_from_wasm<Cls>::value().*Method)(params...);
+      //constructing Cls runs its context checks, so do it once per call
+      auto&& cls = class_from_wasm<Cls>::value();
+      cls.checktime();
+      return (cls.*Method)(params...);
    }
 
    template<MethodSig Method>
@@ -659,8 +685,9 @@ struct intrinsic_function_invoker<WasmSig, void, MethodSig, Cls, Params...> {
 
    template<MethodSig Method>
    static void_type wrapper(running_instance_context& ctx, Params... params) {
-      class_from_wasm<Cls>::value().checktime();
-      (class_from_wasm<Cls>::value().*Method)(params...);
+      auto&& cls = class_from_wasm<Cls>::value();
+      cls.checktime();
+      (cls.*Method)(params...);
       return void_type();
    }
 
@@ -1,4 +1,5 @@
 #include <eosio/chain/merkle.hpp>
+#include <eosio/chain/sha256_batch.hpp>
 #include <fc/io/raw.hpp>
 
 namespace eosio { namespace chain {
@@ -35,15 +36,25 @@ bool is_canonical_right(const digest_type& val) {
 digest_type merkle(vector<digest_type> ids) {
    if( 0 == ids.size() ) { return digest_type(); }
 
+   static_assert( sizeof(digest_type) == 32, "merkle hashes digests as packed 64 byte pairs" );
+
+   // each level is hashed as one batch of canonical pairs, identical to
+   // digest_type::hash(make_canonical_pair(l, r)) which packs the two digests back to back
+   vector<char> pairs;
    while( ids.size() > 1 ) {
       if( ids.size() % 2 )
          ids.push_back(ids.back());
 
-      for (int i = 0; i < ids.size() / 2; i++) {
-         ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+      size_t count = ids.size() / 2;
+      pairs.resize(count * 64);
+      memcpy(pairs.data(), ids.data(), pairs.size());
+      for( size_t i = 0; i < count; i++ ) {
+         pairs[i * 64] &= 0x7F;
+         pairs[i * 64 + 32] |= 0x80;
       }
 
-      ids.resize(ids.size() / 2);
+      ids.resize(count);
+      sha256_batch_64(pairs.data(), count, (char*)ids.data());
    }
 
    return ids.front();
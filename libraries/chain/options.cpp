@@ -21,6 +21,10 @@ int options::get_wasm_runtime_type() {
    return (int)wasm_runtime;
 }
 
+void options::set_wasm_runtime_type(vm_type runtime) {
+   wasm_runtime = runtime;
+}
+
 options::~options() {
 
 }
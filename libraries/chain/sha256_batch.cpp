@@ -0,0 +1,323 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/sha256_batch.hpp>
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EOSIO_SHA256_BATCH_X86
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+namespace eosio { namespace chain {
+
+namespace {
+
+const uint32_t k[64] = {
+   0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+   0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+   0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+   0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+   0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+   0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+   0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+   0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t h0[8] = {
+   0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline uint32_t rotr( uint32_t x, int n ) {
+   return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t load_be32( const char* p ) {
+   const unsigned char* u = (const unsigned char*)p;
+   return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) | (uint32_t(u[2]) << 8) | uint32_t(u[3]);
+}
+
+inline void store_be32( char* p, uint32_t v ) {
+   unsigned char* u = (unsigned char*)p;
+   u[0] = v >> 24;
+   u[1] = v >> 16;
+   u[2] = v >> 8;
+   u[3] = v;
+}
+
+inline void expand( uint32_t w[64] ) {
+   for( int i = 16; i < 64; i++ ) {
+      uint32_t s0 = rotr(w[i-15], 7) ^ rotr(w[i-15], 18) ^ (w[i-15] >> 3);
+      uint32_t s1 = rotr(w[i-2], 17) ^ rotr(w[i-2], 19) ^ (w[i-2] >> 10);
+      w[i] = w[i-16] + s0 + w[i-7] + s1;
+   }
+}
+
+// every message is exactly one block long, so its second block is always the same padding block
+// (0x80, zeros, bit length 512).  Its schedule with the round constants added is computed once.
+struct padding_schedule {
+   uint32_t kw[64];
+
+   padding_schedule() {
+      uint32_t w[64] = {0};
+      w[0] = 0x80000000;
+      w[15] = 512;
+      expand(w);
+      for( int i = 0; i < 64; i++ ) {
+         kw[i] = k[i] + w[i];
+      }
+   }
+};
+
+const padding_schedule padding;
+
+void rounds_generic( uint32_t s[8], const uint32_t kw[64] ) {
+   uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+   for( int i = 0; i < 64; i++ ) {
+      uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + kw[i];
+      uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g; g = f; f = e; e = d + t1;
+      d = c; c = b; b = a; a = t1 + t2;
+   }
+   s[0] += a; s[1] += b; s[2] += c; s[3] += d; s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+void hash_generic( const char* in, size_t count, char* out ) {
+   for( size_t n = 0; n < count; n++, in += 64, out += 32 ) {
+      uint32_t w[64];
+      for( int i = 0; i < 16; i++ ) {
+         w[i] = load_be32(in + i * 4);
+      }
+      expand(w);
+      for( int i = 0; i < 64; i++ ) {
+         w[i] += k[i];
+      }
+
+      uint32_t s[8];
+      memcpy(s, h0, sizeof(s));
+      rounds_generic(s, w);
+      rounds_generic(s, padding.kw);
+
+      for( int i = 0; i < 8; i++ ) {
+         store_be32(out + i * 4, s[i]);
+      }
+   }
+}
+
+#ifdef EOSIO_SHA256_BATCH_X86
+
+#define EOSIO_TARGET_AVX2  __attribute__((target("avx2")))
+#define EOSIO_TARGET_SHANI __attribute__((target("sha,sse4.1")))
+
+EOSIO_TARGET_AVX2 inline __m256i ror8x( __m256i x, int n ) {
+   return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+EOSIO_TARGET_AVX2 inline __m256i xor8x( __m256i x, __m256i y, __m256i z ) {
+   return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+}
+
+EOSIO_TARGET_AVX2 void rounds_avx2( __m256i s[8], const __m256i kw[64] ) {
+   __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+   for( int i = 0; i < 64; i++ ) {
+      __m256i ch  = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+      __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+      __m256i t1  = _mm256_add_epi32(_mm256_add_epi32(h, xor8x(ror8x(e, 6), ror8x(e, 11), ror8x(e, 25))),
+                                     _mm256_add_epi32(ch, kw[i]));
+      __m256i t2  = _mm256_add_epi32(xor8x(ror8x(a, 2), ror8x(a, 13), ror8x(a, 22)), maj);
+      h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+      d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+   }
+   s[0] = _mm256_add_epi32(s[0], a); s[1] = _mm256_add_epi32(s[1], b);
+   s[2] = _mm256_add_epi32(s[2], c); s[3] = _mm256_add_epi32(s[3], d);
+   s[4] = _mm256_add_epi32(s[4], e); s[5] = _mm256_add_epi32(s[5], f);
+   s[6] = _mm256_add_epi32(s[6], g); s[7] = _mm256_add_epi32(s[7], h);
+}
+
+// eight messages at once, one per 32 bit lane
+EOSIO_TARGET_AVX2 void hash_avx2_x8( const char* in, char* out ) {
+   const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                         12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   const __m256i lanes = _mm256_setr_epi32(0, 16, 32, 48, 64, 80, 96, 112);
+
+   __m256i w[64];
+   for( int i = 0; i < 16; i++ ) {
+      w[i] = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)(in + i * 4), lanes, 4), bswap);
+   }
+   for( int i = 16; i < 64; i++ ) {
+      __m256i s0 = xor8x(ror8x(w[i-15], 7), ror8x(w[i-15], 18), _mm256_srli_epi32(w[i-15], 3));
+      __m256i s1 = xor8x(ror8x(w[i-2], 17), ror8x(w[i-2], 19), _mm256_srli_epi32(w[i-2], 10));
+      w[i] = _mm256_add_epi32(_mm256_add_epi32(w[i-16], s0), _mm256_add_epi32(w[i-7], s1));
+   }
+   for( int i = 0; i < 64; i++ ) {
+      w[i] = _mm256_add_epi32(w[i], _mm256_set1_epi32(k[i]));
+   }
+
+   __m256i s[8];
+   for( int i = 0; i < 8; i++ ) {
+      s[i] = _mm256_set1_epi32(h0[i]);
+   }
+   rounds_avx2(s, w);
+
+   for( int i = 0; i < 64; i++ ) {
+      w[i] = _mm256_set1_epi32(padding.kw[i]);
+   }
+   rounds_avx2(s, w);
+
+   alignas(32) uint32_t words[8][8];
+   for( int i = 0; i < 8; i++ ) {
+      _mm256_store_si256((__m256i*)words[i], _mm256_shuffle_epi8(s[i], bswap));
+   }
+   for( int lane = 0; lane < 8; lane++ ) {
+      for( int i = 0; i < 8; i++ ) {
+         memcpy(out + lane * 32 + i * 4, &words[i][lane], 4);
+      }
+   }
+}
+
+void hash_avx2( const char* in, size_t count, char* out ) {
+   size_t n = 0;
+   for( ; n + 8 <= count; n += 8 ) {
+      hash_avx2_x8(in + n * 64, out + n * 32);
+   }
+   hash_generic(in + n * 64, count - n, out + n * 32);
+}
+
+// state is kept as ABEF/CDGH as sha256rnds2 expects
+EOSIO_TARGET_SHANI inline void rounds_shani_const( __m128i& abef, __m128i& cdgh, const uint32_t kw[64] ) {
+   for( int q = 0; q < 16; q++ ) {
+      __m128i msg = _mm_loadu_si128((const __m128i*)(kw + q * 4));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E));
+   }
+}
+
+EOSIO_TARGET_SHANI void hash_shani( const char* in, size_t count, char* out ) {
+   const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+   __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h0), 0xB1);
+   __m128i init_cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h0 + 4)), 0x1B);
+   const __m128i init_abef = _mm_alignr_epi8(tmp, init_cdgh, 8);
+   init_cdgh = _mm_blend_epi16(init_cdgh, tmp, 0xF0);
+
+   for( size_t n = 0; n < count; n++, in += 64, out += 32 ) {
+      __m128i abef = init_abef;
+      __m128i cdgh = init_cdgh;
+
+      __m128i m[4];
+      for( int i = 0; i < 4; i++ ) {
+         m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i * 16)), bswap);
+      }
+
+      // the schedule for word 4q+4.. is completed while rounds 4q..4q+3 run
+#if defined(__clang__)
+      #pragma unroll
+#else
+      #pragma GCC unroll 16
+#endif
+      for( int q = 0; q < 16; q++ ) {
+         __m128i msg = _mm_add_epi32(m[q % 4], _mm_loadu_si128((const __m128i*)(k + q * 4)));
+         cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+         if( q >= 3 && q <= 14 ) {
+            __m128i t = _mm_alignr_epi8(m[q % 4], m[(q + 3) % 4], 4);
+            m[(q + 1) % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(m[(q + 1) % 4], t), m[q % 4]);
+         }
+         abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E));
+         if( q >= 1 && q <= 12 ) {
+            m[(q + 3) % 4] = _mm_sha256msg1_epu32(m[(q + 3) % 4], m[q % 4]);
+         }
+      }
+      abef = _mm_add_epi32(abef, init_abef);
+      cdgh = _mm_add_epi32(cdgh, init_cdgh);
+
+      __m128i mid_abef = abef;
+      __m128i mid_cdgh = cdgh;
+      rounds_shani_const(abef, cdgh, padding.kw);
+      abef = _mm_add_epi32(abef, mid_abef);
+      cdgh = _mm_add_epi32(cdgh, mid_cdgh);
+
+      // back to ABCD/EFGH, big endian
+      tmp = _mm_shuffle_epi32(abef, 0x1B);
+      cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+      __m128i abcd = _mm_blend_epi16(tmp, cdgh, 0xF0);
+      __m128i efgh = _mm_alignr_epi8(cdgh, tmp, 8);
+      _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(abcd, bswap));
+      _mm_storeu_si128((__m128i*)(out + 16), _mm_shuffle_epi8(efgh, bswap));
+   }
+}
+
+bool cpu_has_avx2() {
+   __builtin_cpu_init();
+   return __builtin_cpu_supports("avx2");
+}
+
+bool cpu_has_shani() {
+   unsigned int a, b, c, d;
+   if( !__get_cpuid(1, &a, &b, &c, &d) || !(c & bit_SSE4_1) || !(c & bit_SSSE3) ) {
+      return false;
+   }
+   if( !__get_cpuid_count(7, 0, &a, &b, &c, &d) ) {
+      return false;
+   }
+   return b & (1u << 29);
+}
+
+#endif
+
+bool cpu_has_generic() {
+   return true;
+}
+
+typedef void (*batch_fn)( const char* in, size_t count, char* out );
+
+struct batch_impl {
+   const char* name;
+   batch_fn    fn;
+   bool      (*supported)();
+};
+
+// in order of preference
+const batch_impl impls[] = {
+#ifdef EOSIO_SHA256_BATCH_X86
+   { "shani",   hash_shani,   cpu_has_shani },
+   { "avx2",    hash_avx2,    cpu_has_avx2 },
+#endif
+   { "generic", hash_generic, cpu_has_generic },
+};
+
+const batch_impl* select_impl() {
+   for( const auto& impl : impls ) {
+      if( impl.supported() ) {
+         return &impl;
+      }
+   }
+   return nullptr;
+}
+
+const batch_impl* current_impl = select_impl();
+
+} /// anonymous namespace
+
+void sha256_batch_64( const char* in, size_t count, char* out ) {
+   current_impl->fn(in, count, out);
+}
+
+const char* sha256_batch_impl() {
+   return current_impl->name;
+}
+
+bool set_sha256_batch_impl( const char* name ) {
+   for( const auto& impl : impls ) {
+      if( strcmp(impl.name, name) == 0 && impl.supported() ) {
+         current_impl = &impl;
+         return true;
+      }
+   }
+   return false;
+}
+
+} } /// eosio::chain
@@ -0,0 +1,115 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/signature_recovery_cache.hpp>
+#include <eosio/chain/config.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace eosio { namespace chain {
+
+using namespace boost::multi_index;
+
+namespace {
+
+   struct cached_pub_key {
+      digest_type     key; ///< hash of the signature and the digest it signs
+      public_key_type pub_key;
+   };
+
+   struct by_key{};
+
+   struct key_hash {
+      size_t operator()( const digest_type& d )const { return d._hash[0]; }
+   };
+
+   typedef multi_index_container<
+      cached_pub_key,
+      indexed_by<
+         sequenced<>,
+         hashed_unique<
+            tag<by_key>,
+            member<cached_pub_key, digest_type, &cached_pub_key::key>,
+            key_hash
+         >
+      >
+   > recovery_cache_type;
+
+   struct shard {
+      std::mutex          mutex;
+      recovery_cache_type entries;
+   };
+
+   constexpr size_t shard_count = 16;
+
+   shard                 shards[shard_count];
+   std::atomic<size_t>   shard_capacity{ (config::default_signature_cache_size + shard_count - 1) / shard_count };
+   std::atomic<uint64_t> hits{0};
+   std::atomic<uint64_t> misses{0};
+
+   void trim( shard& s, size_t capacity ) {
+      while( s.entries.size() > capacity )
+         s.entries.pop_front();
+   }
+}
+
+public_key_type signature_recovery_cache::recover( const signature_type& sig, const digest_type& digest ) {
+   const size_t capacity = shard_capacity.load(std::memory_order_relaxed);
+   if( capacity == 0 ) {
+      misses.fetch_add(1, std::memory_order_relaxed);
+      return public_key_type( sig, digest );
+   }
+
+   const digest_type key = digest_type::hash( std::make_pair(sig, digest) );
+   shard& s = shards[key._hash[1] % shard_count];
+   {
+      std::lock_guard<std::mutex> g(s.mutex);
+      auto& idx = s.entries.get<by_key>();
+      auto itr = idx.find( key );
+      if( itr != idx.end() ) {
+         // most recently used entries are kept at the back
+         s.entries.relocate( s.entries.end(), s.entries.project<0>(itr) );
+         hits.fetch_add(1, std::memory_order_relaxed);
+         return itr->pub_key;
+      }
+   }
+
+   misses.fetch_add(1, std::memory_order_relaxed);
+   public_key_type recovered( sig, digest );
+
+   std::lock_guard<std::mutex> g(s.mutex);
+   s.entries.push_back( cached_pub_key{key, recovered} ); // fails if another thread recovered it meanwhile; not a problem
+   trim( s, capacity );
+   return recovered;
+}
+
+void signature_recovery_cache::set_capacity( size_t entries ) {
+   const size_t capacity = (entries + shard_count - 1) / shard_count;
+   shard_capacity.store( capacity, std::memory_order_relaxed );
+   for( auto& s : shards ) {
+      std::lock_guard<std::mutex> g(s.mutex);
+      trim( s, capacity );
+   }
+}
+
+signature_recovery_cache::stats signature_recovery_cache::get_stats() {
+   stats result;
+   result.hits = hits.load(std::memory_order_relaxed);
+   result.misses = misses.load(std::memory_order_relaxed);
+   result.capacity = shard_capacity.load(std::memory_order_relaxed) * shard_count;
+   for( auto& s : shards ) {
+      std::lock_guard<std::mutex> g(s.mutex);
+      result.size += s.entries.size();
+   }
+   return result;
+}
+
+} } /// eosio::chain
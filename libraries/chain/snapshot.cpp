@@ -2,8 +2,16 @@
 #include <eosio/chain/exceptions.hpp>
 #include <fc/scoped_exit.hpp>
 
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include <thread>
+
 namespace eosio { namespace chain {
 
+namespace bio = boost::iostreams;
+
 variant_snapshot_writer::variant_snapshot_writer(fc::mutable_variant_object& snapshot)
 : snapshot(snapshot)
 {
@@ -358,4 +366,516 @@ void integrity_hash_snapshot_writer::finalize() {
    // no-op for structural details
 }
 
-}}
\ No newline at end of file
+namespace detail {
+   static uint32_t worker_count( uint32_t threads ) {
+      if (threads == 0) {
+         threads = std::thread::hardware_concurrency();
+      }
+      return std::max<uint32_t>(threads, 1);
+   }
+
+   chunk_workers::chunk_workers( uint32_t count ) {
+      for (uint32_t i = 0; i < count; i++) {
+         threads.emplace_back(&chunk_workers::run, this);
+      }
+   }
+
+   chunk_workers::~chunk_workers() {
+      {
+         std::lock_guard<std::mutex> g(lock);
+         stopping = true;
+      }
+      cond.notify_all();
+      for (auto& t: threads) {
+         t.join();
+      }
+   }
+
+   void chunk_workers::enqueue( std::function<void()> job ) {
+      {
+         std::lock_guard<std::mutex> g(lock);
+         jobs.emplace_back(std::move(job));
+      }
+      cond.notify_one();
+   }
+
+   void chunk_workers::run() {
+      while (true) {
+         std::function<void()> job;
+         {
+            std::unique_lock<std::mutex> g(lock);
+            cond.wait(g, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+               return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+         }
+         // exceptions of the chunk end up in its future
+         job();
+      }
+   }
+
+   // runs on a worker thread, hashes the packed rows and replaces them with their compressed form
+   static snapshot_chunk seal_chunk( snapshot_chunk chunk, bool compress ) {
+      chunk.raw_size = chunk.data.size();
+      chunk.hash = fc::sha256::hash(chunk.data.data(), chunk.data.size());
+      if (compress) {
+         bytes out;
+         bio::filtering_ostream comp;
+         comp.push(bio::zlib_compressor(bio::zlib::best_speed));
+         comp.push(bio::back_inserter(out));
+         bio::write(comp, chunk.data.data(), chunk.data.size());
+         bio::close(comp);
+         chunk.data = std::move(out);
+         chunk.compression = snapshot_chunk::compression_zlib;
+      }
+      return chunk;
+   }
+
+   // runs on a worker thread, the inverse of seal_chunk
+   static snapshot_chunk open_chunk( snapshot_chunk chunk ) {
+      if (chunk.compression == snapshot_chunk::compression_zlib) {
+         bytes out;
+         out.reserve(chunk.raw_size);
+         try {
+            bio::filtering_ostream decomp;
+            decomp.push(bio::zlib_decompressor());
+            decomp.push(bio::back_inserter(out));
+            bio::write(decomp, chunk.data.data(), chunk.data.size());
+            bio::close(decomp);
+         } catch( const std::exception& e ) {
+            EOS_THROW(snapshot_exception, "Binary snapshot chunk failed to decompress (${what})", ("what", e.what()));
+         }
+         chunk.data = std::move(out);
+      } else {
+         EOS_ASSERT(chunk.compression == snapshot_chunk::compression_none, snapshot_exception,
+                    "Binary snapshot chunk has unknown compression ${c}", ("c", chunk.compression));
+      }
+
+      EOS_ASSERT(chunk.data.size() == chunk.raw_size, snapshot_exception,
+                 "Binary snapshot chunk has unexpected size.  Expected : ${expected}, Got: ${actual}",
+                 ("expected", chunk.raw_size)("actual", chunk.data.size()));
+      EOS_ASSERT(fc::sha256::hash(chunk.data.data(), chunk.data.size()) == chunk.hash, snapshot_exception,
+                 "Binary snapshot chunk checksum mismatch");
+      return chunk;
+   }
+
+   // chunk header: rows, raw size, stored size, compression, hash
+   static const std::streamoff chunk_header_size = sizeof(uint32_t) * 3 + sizeof(uint8_t) + sizeof(fc::sha256);
+
+   // section header: section size, row count, chunk count, followed by the null terminated name
+   static const std::streamoff section_header_size = sizeof(uint64_t) * 3;
+}
+
+chunked_ostream_snapshot_writer::chunked_ostream_snapshot_writer(std::ostream& snapshot, uint32_t threads, bool compress)
+:snapshot(snapshot)
+,section_pos(-1)
+,row_count(0)
+,chunk_count(0)
+,threads(detail::worker_count(threads))
+,compress(compress)
+,workers(detail::worker_count(threads))
+{
+   // write magic number
+   auto totem = ostream_snapshot_writer::magic_number;
+   snapshot.write((char*)&totem, sizeof(totem));
+
+   // write version
+   auto version = chunked_snapshot_version;
+   snapshot.write((char*)&version, sizeof(version));
+}
+
+void chunked_ostream_snapshot_writer::write_start_section( const std::string& section_name )
+{
+   EOS_ASSERT(section_pos == std::streampos(-1), snapshot_exception, "Attempting to write a new section without closing the previous section");
+   section_pos = snapshot.tellp();
+   row_count = 0;
+   chunk_count = 0;
+
+   uint64_t placeholder = std::numeric_limits<uint64_t>::max();
+
+   // write placeholders for the section size, row count and chunk count
+   snapshot.write((char*)&placeholder, sizeof(placeholder));
+   snapshot.write((char*)&placeholder, sizeof(placeholder));
+   snapshot.write((char*)&placeholder, sizeof(placeholder));
+
+   // write the section name (null terminated)
+   snapshot.write(section_name.data(), section_name.size());
+   snapshot.put(0);
+}
+
+void chunked_ostream_snapshot_writer::write_row( const detail::abstract_snapshot_row_writer& row_writer ) {
+   auto restore = current.data.size();
+   try {
+      detail::chunk_wrapper out(current.data);
+      row_writer.write(out);
+   } catch (...) {
+      current.data.resize(restore);
+      throw;
+   }
+   current.rows++;
+   row_count++;
+   total_rows.fetch_add(1, std::memory_order_relaxed);
+
+   if (current.data.size() >= chunk_size) {
+      flush_chunk();
+   }
+}
+
+void chunked_ostream_snapshot_writer::flush_chunk() {
+   if (current.rows == 0) {
+      return;
+   }
+
+   // keep at most one chunk per worker in flight
+   write_chunks(threads - 1);
+
+   pending.emplace_back(workers.post([chunk = std::move(current), compress = compress]() mutable {
+      return detail::seal_chunk(std::move(chunk), compress);
+   }));
+   current = detail::snapshot_chunk();
+   current.data.reserve(chunk_size + chunk_size / 8);
+   chunk_count++;
+}
+
+void chunked_ostream_snapshot_writer::write_chunks( size_t max_pending ) {
+   while (pending.size() > max_pending) {
+      auto chunk = pending.front().get();
+      pending.pop_front();
+
+      uint32_t stored_size = chunk.data.size();
+      snapshot.write((char*)&chunk.rows, sizeof(chunk.rows));
+      snapshot.write((char*)&chunk.raw_size, sizeof(chunk.raw_size));
+      snapshot.write((char*)&stored_size, sizeof(stored_size));
+      snapshot.write((char*)&chunk.compression, sizeof(chunk.compression));
+      snapshot.write(chunk.hash.data(), sizeof(chunk.hash));
+      snapshot.write(chunk.data.data(), chunk.data.size());
+   }
+}
+
+void chunked_ostream_snapshot_writer::write_end_section( ) {
+   flush_chunk();
+   write_chunks(0);
+
+   auto restore = snapshot.tellp();
+
+   uint64_t section_size = restore - section_pos - sizeof(uint64_t);
+
+   snapshot.seekp(section_pos);
+
+   // write the section size, row count and chunk count
+   snapshot.write((char*)&section_size, sizeof(section_size));
+   snapshot.write((char*)&row_count, sizeof(row_count));
+   snapshot.write((char*)&chunk_count, sizeof(chunk_count));
+
+   snapshot.seekp(restore);
+
+   section_pos = std::streampos(-1);
+   row_count = 0;
+   chunk_count = 0;
+}
+
+void chunked_ostream_snapshot_writer::finalize() {
+   uint64_t end_marker = std::numeric_limits<uint64_t>::max();
+
+   // write the end marker in place of a section size
+   snapshot.write((char*)&end_marker, sizeof(end_marker));
+}
+
+chunked_istream_snapshot_reader::chunked_istream_snapshot_reader(std::istream& snapshot, uint32_t threads)
+:snapshot(snapshot)
+,header_pos(snapshot.tellg())
+,num_rows(0)
+,cur_row(0)
+,chunks_left(0)
+,threads(detail::worker_count(threads))
+,current_pos(0)
+,workers(detail::worker_count(threads))
+{
+
+}
+
+void chunked_istream_snapshot_reader::validate() const {
+   // make sure to restore the read pos
+   auto restore_pos = fc::make_scoped_exit([this,pos=snapshot.tellg(),ex=snapshot.exceptions()](){
+      snapshot.seekg(pos);
+      snapshot.exceptions(ex);
+   });
+
+   snapshot.exceptions(std::istream::failbit|std::istream::eofbit);
+
+   try {
+      // validate totem
+      auto expected_totem = ostream_snapshot_writer::magic_number;
+      decltype(expected_totem) actual_totem;
+      snapshot.read((char*)&actual_totem, sizeof(actual_totem));
+      EOS_ASSERT(actual_totem == expected_totem, snapshot_exception,
+                 "Binary snapshot has unexpected magic number!");
+
+      // validate version
+      auto expected_version = chunked_snapshot_version;
+      decltype(expected_version) actual_version;
+      snapshot.read((char*)&actual_version, sizeof(actual_version));
+      EOS_ASSERT(actual_version == expected_version, snapshot_exception,
+                 "Binary snapshot is an unsuppored version.  Expected : ${expected}, Got: ${actual}",
+                 ("expected", expected_version)("actual", actual_version));
+
+      while (validate_section()) {}
+   } catch( const std::exception& e ) {
+      snapshot_exception fce(FC_LOG_MESSAGE( warn, "Binary snapshot validation threw IO exception (${what})",("what",e.what())));
+      throw fce;
+   }
+}
+
+bool chunked_istream_snapshot_reader::validate_section() const {
+   uint64_t section_size = 0;
+   snapshot.read((char*)&section_size,sizeof(section_size));
+
+   // stop when we see the end marker
+   if (section_size == std::numeric_limits<uint64_t>::max()) {
+      return false;
+   }
+
+   auto section_end = snapshot.tellg() + std::streamoff(section_size);
+
+   uint64_t row_count = 0;
+   uint64_t chunk_count = 0;
+   snapshot.read((char*)&row_count,sizeof(row_count));
+   snapshot.read((char*)&chunk_count,sizeof(chunk_count));
+   while (snapshot.get() != 0) {}
+
+   // walk the chunk headers, contents are verified against their checksums as they are read
+   uint64_t rows = 0;
+   for (uint64_t i = 0; i < chunk_count; i++) {
+      uint32_t chunk_rows = 0;
+      uint32_t raw_size = 0;
+      uint32_t stored_size = 0;
+      snapshot.read((char*)&chunk_rows, sizeof(chunk_rows));
+      snapshot.read((char*)&raw_size, sizeof(raw_size));
+      snapshot.read((char*)&stored_size, sizeof(stored_size));
+      snapshot.seekg(snapshot.tellg() + std::streamoff(sizeof(uint8_t) + sizeof(fc::sha256) + stored_size));
+      rows += chunk_rows;
+   }
+
+   EOS_ASSERT(rows == row_count, snapshot_exception,
+              "Binary snapshot section has ${actual} rows in its chunks but declares ${expected}",
+              ("expected", row_count)("actual", rows));
+   EOS_ASSERT(snapshot.tellg() == section_end, snapshot_exception,
+              "Binary snapshot section chunks do not match the section size");
+
+   return true;
+}
+
+bool chunked_istream_snapshot_reader::has_section( const string& section_name ) {
+   auto restore_pos = fc::make_scoped_exit([this,pos=snapshot.tellg()](){
+      snapshot.seekg(pos);
+   });
+
+   const std::streamoff header_size = sizeof(ostream_snapshot_writer::magic_number) + sizeof(chunked_snapshot_version);
+
+   auto next_section_pos = header_pos + header_size;
+
+   while (true) {
+      snapshot.seekg(next_section_pos);
+      uint64_t section_size = 0;
+      snapshot.read((char*)&section_size,sizeof(section_size));
+      if (section_size == std::numeric_limits<uint64_t>::max()) {
+         break;
+      }
+
+      next_section_pos = snapshot.tellg() + std::streamoff(section_size);
+
+      // skip the row and chunk counts
+      snapshot.seekg(snapshot.tellg() + std::streamoff(sizeof(uint64_t) * 2));
+
+      bool match = true;
+      for(auto c : section_name) {
+         if(snapshot.get() != c) {
+            match = false;
+            break;
+         }
+      }
+
+      if (match && snapshot.get() == 0) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void chunked_istream_snapshot_reader::set_section( const string& section_name ) {
+   auto restore_pos = fc::make_scoped_exit([this,pos=snapshot.tellg()](){
+      snapshot.seekg(pos);
+   });
+
+   const std::streamoff header_size = sizeof(ostream_snapshot_writer::magic_number) + sizeof(chunked_snapshot_version);
+
+   auto next_section_pos = header_pos + header_size;
+
+   while (true) {
+      snapshot.seekg(next_section_pos);
+      uint64_t section_size = 0;
+      snapshot.read((char*)&section_size,sizeof(section_size));
+      if (section_size == std::numeric_limits<uint64_t>::max()) {
+         break;
+      }
+
+      next_section_pos = snapshot.tellg() + std::streamoff(section_size);
+
+      uint64_t row_count = 0;
+      uint64_t chunk_count = 0;
+      snapshot.read((char*)&row_count,sizeof(row_count));
+      snapshot.read((char*)&chunk_count,sizeof(chunk_count));
+
+      bool match = true;
+      for(auto c : section_name) {
+         if(snapshot.get() != c) {
+            match = false;
+            break;
+         }
+      }
+
+      if (match && snapshot.get() == 0) {
+         cur_row = 0;
+         num_rows = row_count;
+         chunks_left = chunk_count;
+         current = detail::snapshot_chunk();
+         current_pos = 0;
+
+         // leave the stream at the first chunk and start unpacking ahead of the reader
+         restore_pos.cancel();
+         fetch_chunks();
+         return;
+      }
+   }
+
+   EOS_THROW(snapshot_exception, "Binary snapshot has no section named ${n}", ("n", section_name));
+}
+
+void chunked_istream_snapshot_reader::fetch_chunks() {
+   // reading is sequential, keep two chunks per worker queued so the reader never waits on io
+   while (chunks_left > 0 && pending.size() < threads * 2) {
+      detail::snapshot_chunk chunk;
+      uint32_t stored_size = 0;
+      snapshot.read((char*)&chunk.rows, sizeof(chunk.rows));
+      snapshot.read((char*)&chunk.raw_size, sizeof(chunk.raw_size));
+      snapshot.read((char*)&stored_size, sizeof(stored_size));
+      snapshot.read((char*)&chunk.compression, sizeof(chunk.compression));
+      snapshot.read(chunk.hash.data(), sizeof(chunk.hash));
+      chunk.data.resize(stored_size);
+      snapshot.read(chunk.data.data(), stored_size);
+      EOS_ASSERT(snapshot, snapshot_exception, "Binary snapshot chunk is truncated");
+
+      pending.emplace_back(workers.post([chunk = std::move(chunk)]() mutable {
+         return detail::open_chunk(std::move(chunk));
+      }));
+      chunks_left--;
+   }
+}
+
+bool chunked_istream_snapshot_reader::read_row( detail::abstract_snapshot_row_reader& row_reader ) {
+   if (current_pos >= current.data.size()) {
+      EOS_ASSERT(!pending.empty(), snapshot_exception, "Binary snapshot section has fewer rows than declared");
+      current = pending.front().get();
+      pending.pop_front();
+      current_pos = 0;
+      fetch_chunks();
+   }
+
+   fc::datastream<const char*> ds(current.data.data() + current_pos, current.data.size() - current_pos);
+   row_reader.provide(ds);
+   current_pos += ds.tellp();
+
+   return ++cur_row < num_rows;
+}
+
+bool chunked_istream_snapshot_reader::empty ( ) {
+   return num_rows == 0;
+}
+
+void chunked_istream_snapshot_reader::clear_section() {
+   for (auto& f: pending) {
+      f.wait();
+   }
+   pending.clear();
+   current = detail::snapshot_chunk();
+   current_pos = 0;
+   chunks_left = 0;
+   num_rows = 0;
+   cur_row = 0;
+}
+
+snapshot_reader_ptr make_istream_snapshot_reader(std::istream& snapshot) {
+   auto pos = snapshot.tellg();
+   uint32_t totem = 0;
+   uint32_t version = 0;
+   snapshot.read((char*)&totem, sizeof(totem));
+   snapshot.read((char*)&version, sizeof(version));
+   snapshot.clear();
+   snapshot.seekg(pos);
+
+   if (totem == ostream_snapshot_writer::magic_number && version == chunked_snapshot_version) {
+      return std::make_shared<chunked_istream_snapshot_reader>(snapshot);
+   }
+   return std::make_shared<istream_snapshot_reader>(snapshot);
+}
+
+chunked_integrity_hash_snapshot_writer::chunked_integrity_hash_snapshot_writer(uint32_t threads)
+:threads(detail::worker_count(threads))
+,workers(detail::worker_count(threads))
+{
+   current.reserve(chunk_size + chunk_size / 8);
+}
+
+void chunked_integrity_hash_snapshot_writer::write_start_section( const std::string& )
+{
+   // no-op for structural details
+}
+
+void chunked_integrity_hash_snapshot_writer::write_row( const detail::abstract_snapshot_row_writer& row_writer ) {
+   detail::chunk_wrapper out(current);
+   row_writer.write(out);
+   while (current.size() >= chunk_size) {
+      flush_chunk();
+   }
+}
+
+void chunked_integrity_hash_snapshot_writer::write_end_section( ) {
+   // no-op for structural details
+}
+
+void chunked_integrity_hash_snapshot_writer::flush_chunk() {
+   while (pending.size() >= threads) {
+      hashes.emplace_back(pending.front().get());
+      pending.pop_front();
+   }
+
+   // cut at exactly chunk_size so the result does not depend on row boundaries
+   size_t size = std::min(current.size(), chunk_size);
+   bytes chunk(current.begin(), current.begin() + size);
+   current.erase(current.begin(), current.begin() + size);
+
+   pending.emplace_back(workers.post([chunk = std::move(chunk)]() {
+      return fc::sha256::hash(chunk.data(), chunk.size());
+   }));
+}
+
+fc::sha256 chunked_integrity_hash_snapshot_writer::finalize() {
+   if (!current.empty()) {
+      flush_chunk();
+   }
+   while (!pending.empty()) {
+      hashes.emplace_back(pending.front().get());
+      pending.pop_front();
+   }
+
+   sha256::encoder enc;
+   for (const auto& h: hashes) {
+      enc.write(h.data(), sizeof(h));
+   }
+   return enc.result();
+}
+
+}}
@@ -0,0 +1,355 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/state_prefetcher.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace eosio { namespace chain {
+
+namespace {
+
+   /// where a code, scope or primary key of a lookup comes from
+   struct operand {
+      enum source_type : uint8_t { constant, account, data, data_shr8 };
+
+      source_type source = constant;
+      uint32_t    offset = 0; ///< of the 8 byte word in the action data
+      uint64_t    value = 0;  ///< of a constant
+
+      bool resolve( const action& act, uint64_t& out )const {
+         switch( source ) {
+            case constant:
+               out = value;
+               return true;
+            case account:
+               out = act.account.value;
+               return true;
+            default:
+               if( offset + sizeof(uint64_t) > act.data.size() ) return false;
+               memcpy( &out, act.data.data() + offset, sizeof(uint64_t) );
+               if( source == data_shr8 ) out >>= 8;
+               return true;
+         }
+      }
+   };
+
+   /// action data words further in are not searched, the keys of an action come first
+   constexpr uint32_t max_data_offset = 64;
+
+   /**
+    * The source of v: the action's account, an 8 byte word of the action data at any offset, the same word
+    * shifted by 8 (the symbol code of an asset's symbol), or a constant. Zero is always a constant.
+    */
+   operand classify( const action& act, uint64_t v ) {
+      operand op;
+      op.value = v;
+      if( v == 0 ) return op;
+      if( v == act.account.value ) {
+         op.source = operand::account;
+         op.value = 0;
+         return op;
+      }
+      const size_t end = std::min<size_t>( act.data.size(), max_data_offset + sizeof(uint64_t) );
+      for( auto source : { operand::data, operand::data_shr8 } ) {
+         for( size_t offset = 0; offset + sizeof(uint64_t) <= end; ++offset ) {
+            uint64_t w;
+            memcpy( &w, act.data.data() + offset, sizeof(uint64_t) );
+            if( source == operand::data_shr8 ) w >>= 8;
+            if( w == v ) {
+               op.source = source;
+               op.offset = offset;
+               op.value = 0;
+               return op;
+            }
+         }
+      }
+      return op;
+   }
+
+   struct access_pattern {
+      operand  code;
+      operand  scope;
+      uint64_t table = 0;
+      operand  primary;
+      uint64_t hits = 0;
+   };
+
+   struct row_key {
+      uint64_t code;
+      uint64_t scope;
+      uint64_t table;
+      uint64_t primary;
+
+      bool operator==( const row_key& o )const {
+         return code == o.code && scope == o.scope && table == o.table && primary == o.primary;
+      }
+   };
+
+   struct row_key_hash {
+      size_t operator()( const row_key& k )const {
+         return mix_hash( k.code ^ mix_hash( k.scope ^ mix_hash( k.table ^ mix_hash( k.primary ) ) ) );
+      }
+
+      static size_t mix_hash( uint64_t h ) {
+         h ^= h >> 33;
+         h *= 0xff51afd7ed558ccdULL;
+         h ^= h >> 33;
+         return size_t(h);
+      }
+   };
+
+   struct row_location {
+      const void* table = nullptr; ///< table_id_object
+      const void* row = nullptr;   ///< key_value_object, null if the row did not exist
+      const char* value = nullptr;
+      size_t      size = 0;
+   };
+
+   constexpr size_t max_patterns_per_action = 16;
+   constexpr size_t max_rows = 1 << 20;
+   /// bytes of a row value prefetched, the rest is left to the hardware prefetcher
+   constexpr size_t max_prefetch_size = 256;
+   constexpr size_t max_queued = 1 << 16;
+   constexpr size_t cache_line = 64;
+
+   std::atomic<bool>     is_enabled{false};
+   std::atomic<uint64_t> recorded{0};
+   std::atomic<uint64_t> predicted{0};
+   std::atomic<uint64_t> located{0};
+   std::atomic<uint64_t> scheduled{0};
+   std::atomic<uint64_t> dropped{0};
+
+   /// patterns and rows, only contended when several controllers run in one process
+   std::mutex mutex;
+   std::map<std::pair<uint64_t, uint64_t>, std::vector<access_pattern>> patterns;
+   std::unordered_map<row_key, row_location, row_key_hash> rows;
+   size_t pattern_count = 0;
+
+   void learn( const action& act, const row_key& key ) {
+      auto& list = patterns[std::make_pair( act.account.value, act.name.value )];
+      for( auto& p : list ) {
+         uint64_t code, scope, primary;
+         if( p.table == key.table && p.code.resolve( act, code ) && code == key.code &&
+             p.scope.resolve( act, scope ) && scope == key.scope &&
+             p.primary.resolve( act, primary ) && primary == key.primary ) {
+            ++p.hits;
+            return;
+         }
+      }
+
+      access_pattern p;
+      p.code = classify( act, key.code );
+      p.scope = classify( act, key.scope );
+      p.table = key.table;
+      p.primary = classify( act, key.primary );
+      p.hits = 1;
+      if( list.size() < max_patterns_per_action ) {
+         list.push_back( p );
+         ++pattern_count;
+         return;
+      }
+      // replaces the least used one
+      auto victim = std::min_element( list.begin(), list.end(), []( const access_pattern& a, const access_pattern& b ) {
+         return a.hits < b.hits;
+      });
+      *victim = p;
+   }
+
+   void predict( const transaction& trx, std::vector<row_location>& out ) {
+      std::lock_guard<std::mutex> g(mutex);
+      for( const auto& act : trx.actions ) {
+         auto itr = patterns.find( std::make_pair( act.account.value, act.name.value ) );
+         if( itr == patterns.end() ) continue;
+         for( const auto& p : itr->second ) {
+            row_key key{0, 0, p.table, 0};
+            if( !p.code.resolve( act, key.code ) || !p.scope.resolve( act, key.scope ) || !p.primary.resolve( act, key.primary ) )
+               continue;
+            predicted.fetch_add( 1, std::memory_order_relaxed );
+            auto row = rows.find( key );
+            if( row == rows.end() ) continue;
+            located.fetch_add( 1, std::memory_order_relaxed );
+            out.push_back( row->second );
+         }
+      }
+   }
+
+   /// pages are handed over rather than rows, the helper thread only sees addresses
+   struct page_range {
+      const char* begin;
+      size_t      size;
+   };
+
+   void prefetch_range( const void* p, size_t size ) {
+      const char* c = static_cast<const char*>(p);
+      for( size_t i = 0; i < size; i += cache_line )
+         __builtin_prefetch( c + i );
+   }
+
+   /**
+    * Faults in the pages handed over with madvise(WILLNEED) and prefetches their lines, which reach the last
+    * level cache shared with the applying thread. The addresses can be stale, the rows having been removed
+    * since, neither touches the memory.
+    */
+   struct helper_thread {
+      std::mutex              queue_mutex;
+      std::condition_variable queue_cv;
+      std::deque<page_range>  queue;
+      std::thread             thread;
+      bool                    stopping = false;
+
+      void start() {
+         std::lock_guard<std::mutex> g(queue_mutex);
+         if( thread.joinable() ) return;
+         stopping = false;
+         thread = std::thread( [this]() { run(); } );
+      }
+
+      void stop() {
+         {
+            std::lock_guard<std::mutex> g(queue_mutex);
+            if( !thread.joinable() ) return;
+            stopping = true;
+            queue.clear();
+         }
+         queue_cv.notify_one();
+         thread.join();
+      }
+
+      bool push( const std::vector<page_range>& ranges ) {
+         {
+            std::lock_guard<std::mutex> g(queue_mutex);
+            if( !thread.joinable() || queue.size() + ranges.size() > max_queued ) return false;
+            queue.insert( queue.end(), ranges.begin(), ranges.end() );
+         }
+         queue_cv.notify_one();
+         return true;
+      }
+
+      void run() {
+         const uintptr_t page_mask = ~uintptr_t( sysconf(_SC_PAGESIZE) - 1 );
+         while( true ) {
+            page_range r;
+            {
+               std::unique_lock<std::mutex> g(queue_mutex);
+               queue_cv.wait( g, [this]() { return stopping || !queue.empty(); } );
+               if( stopping ) return;
+               r = queue.front();
+               queue.pop_front();
+            }
+            uintptr_t begin = reinterpret_cast<uintptr_t>(r.begin) & page_mask;
+            uintptr_t end = reinterpret_cast<uintptr_t>(r.begin) + r.size;
+            madvise( reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED );
+            prefetch_range( r.begin, r.size );
+         }
+      }
+
+      ~helper_thread() { stop(); }
+   };
+
+   helper_thread helper;
+
+   void add_range( std::vector<page_range>& ranges, const void* p, size_t size ) {
+      if( p ) ranges.push_back( page_range{ static_cast<const char*>(p), size } );
+   }
+}
+
+void state_prefetcher::set_enabled( bool enabled ) {
+   is_enabled.store( enabled, std::memory_order_relaxed );
+   if( enabled )
+      helper.start();
+   else
+      helper.stop();
+}
+
+bool state_prefetcher::enabled() {
+   return is_enabled.load( std::memory_order_relaxed );
+}
+
+void state_prefetcher::record( const action& act, const table_id_object& tab, uint64_t primary, const key_value_object* row ) {
+   recorded.fetch_add( 1, std::memory_order_relaxed );
+   row_key key{ tab.code.value, tab.scope.value, tab.table.value, primary };
+
+   std::lock_guard<std::mutex> g(mutex);
+   learn( act, key );
+
+   if( rows.size() >= max_rows && rows.find( key ) == rows.end() ) {
+      // no eviction order is kept, the rows in use are recorded again soon enough
+      rows.clear();
+   }
+   auto& loc = rows[key];
+   loc.table = &tab;
+   loc.row = row;
+   loc.value = row ? row->value.data() : nullptr;
+   loc.size = row ? row->value.size() : 0;
+}
+
+void state_prefetcher::forget( const table_id_object& tab, uint64_t primary ) {
+   std::lock_guard<std::mutex> g(mutex);
+   rows.erase( row_key{ tab.code.value, tab.scope.value, tab.table.value, primary } );
+}
+
+void state_prefetcher::schedule( const transaction& trx ) {
+   std::vector<row_location> locations;
+   predict( trx, locations );
+   if( locations.empty() ) return;
+
+   std::vector<page_range> ranges;
+   for( const auto& loc : locations ) {
+      add_range( ranges, loc.table, sizeof(table_id_object) );
+      add_range( ranges, loc.row, sizeof(key_value_object) );
+      add_range( ranges, loc.value, loc.size );
+   }
+   if( helper.push( ranges ) )
+      scheduled.fetch_add( locations.size(), std::memory_order_relaxed );
+   else
+      dropped.fetch_add( locations.size(), std::memory_order_relaxed );
+}
+
+void state_prefetcher::prefetch( const transaction& trx ) {
+   std::vector<row_location> locations;
+   predict( trx, locations );
+   for( const auto& loc : locations ) {
+      __builtin_prefetch( loc.table );
+      if( loc.row ) prefetch_range( loc.row, sizeof(key_value_object) );
+      if( loc.value ) prefetch_range( loc.value, std::min( loc.size, max_prefetch_size ) );
+   }
+}
+
+state_prefetcher::stats state_prefetcher::get_stats() {
+   stats result;
+   result.recorded = recorded.load( std::memory_order_relaxed );
+   result.predicted = predicted.load( std::memory_order_relaxed );
+   result.located = located.load( std::memory_order_relaxed );
+   result.scheduled = scheduled.load( std::memory_order_relaxed );
+   result.dropped = dropped.load( std::memory_order_relaxed );
+   std::lock_guard<std::mutex> g(mutex);
+   result.patterns = pattern_count;
+   result.rows = rows.size();
+   return result;
+}
+
+void state_prefetcher::reset() {
+   {
+      std::lock_guard<std::mutex> g(mutex);
+      patterns.clear();
+      rows.clear();
+      pattern_count = 0;
+   }
+   for( auto* counter : { &recorded, &predicted, &located, &scheduled, &dropped } )
+      counter->store( 0, std::memory_order_relaxed );
+}
+
+} } /// eosio::chain
@@ -8,10 +8,6 @@
 #include <algorithm>
 
 #include <boost/range/adaptor/transformed.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
@@ -19,35 +15,10 @@
 #include <eosio/chain/config.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <eosio/chain/transaction.hpp>
+#include <eosio/chain/signature_recovery_cache.hpp>
 
 namespace eosio { namespace chain {
 
-using namespace boost::multi_index;
-
-struct cached_pub_key {
-   transaction_id_type trx_id;
-   public_key_type pub_key;
-   signature_type sig;
-   cached_pub_key(const cached_pub_key&) = delete;
-   cached_pub_key() = delete;
-   cached_pub_key& operator=(const cached_pub_key&) = delete;
-   cached_pub_key(cached_pub_key&&) = default;
-};
-struct by_sig{};
-
-typedef multi_index_container<
-   cached_pub_key,
-   indexed_by<
-      sequenced<>,
-      hashed_unique<
-         tag<by_sig>,
-         member<cached_pub_key,
-                signature_type,
-                &cached_pub_key::sig>
-      >
-   >
-> recovery_cache_type;
-
 void transaction_header::set_reference_block( const block_id_type& reference_block ) {
    ref_block_num    = fc::endian_reverse_u32(reference_block._hash[0]);
    ref_block_prefix = reference_block._hash[1];
@@ -86,24 +57,12 @@ flat_set<public_key_type> transaction::get_signature_keys( const vector<signatur
 { try {
    using boost::adaptors::transformed;
 
-   constexpr size_t recovery_cache_size = 1000;
-   static recovery_cache_type recovery_cache;
    const digest_type digest = sig_digest(chain_id, cfd);
 
    flat_set<public_key_type> recovered_pub_keys;
    for(const signature_type& sig : signatures) {
-      public_key_type recov;
-      if( use_cache ) {
-         recovery_cache_type::index<by_sig>::type::iterator it = recovery_cache.get<by_sig>().find( sig );
-         if( it == recovery_cache.get<by_sig>().end() || it->trx_id != id()) {
-            recov = public_key_type( sig, digest );
-            recovery_cache.emplace_back(cached_pub_key{id(), recov, sig} ); //could fail on dup signatures; not a problem
-         } else {
-            recov = it->pub_key;
-         }
-      } else {
-         recov = public_key_type( sig, digest );
-      }
+      public_key_type recov = use_cache ? signature_recovery_cache::recover( sig, digest )
+                                        : public_key_type( sig, digest );
       bool successful_insertion = false;
       std::tie(std::ignore, successful_insertion) = recovered_pub_keys.insert(recov);
       EOS_ASSERT( allow_duplicate_keys || successful_insertion, tx_duplicate_sig,
@@ -112,11 +71,6 @@ flat_set<public_key_type> transaction::get_signature_keys( const vector<signatur
                );
    }
 
-   if( use_cache ) {
-      while ( recovery_cache.size() > recovery_cache_size )
-         recovery_cache.erase( recovery_cache.begin() );
-   }
-
    return recovered_pub_keys;
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -0,0 +1,134 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/transaction_arena.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace eosio { namespace chain {
+
+namespace {
+
+   constexpr size_t first_chunk_size = 64 * 1024;
+   /// chunks past this many bytes are freed at release, so a rare large action does not pin its memory
+   constexpr size_t max_retained_bytes = 4 * 1024 * 1024;
+
+   std::atomic<uint64_t> releases{0};
+   std::atomic<uint64_t> last_bytes{0};
+   std::atomic<uint64_t> high_water_bytes{0};
+   std::atomic<uint64_t> reserved_bytes{0};
+   std::atomic<uint64_t> chunk_allocations{0};
+
+   thread_local std::unique_ptr<transaction_arena> thread_arena;
+   thread_local transaction_arena* open_arena = nullptr;
+
+   char* align_up( char* p, size_t alignment ) {
+      uintptr_t v = reinterpret_cast<uintptr_t>(p);
+      return reinterpret_cast<char*>( (v + alignment - 1) & ~uintptr_t(alignment - 1) );
+   }
+}
+
+transaction_arena* transaction_arena::current() {
+   return open_arena;
+}
+
+void* transaction_arena::allocate( size_t bytes, size_t alignment ) {
+   char* p = align_up( next, alignment );
+   if( !next || p + bytes > end ) {
+      add_chunk( bytes + alignment );
+      p = align_up( next, alignment );
+   }
+   next = p + bytes;
+   used += bytes;
+   return p;
+}
+
+void transaction_arena::add_chunk( size_t min_size ) {
+   // the chunks kept from previous actions are reused first
+   while( active + 1 < chunks.size() ) {
+      ++active;
+      if( chunks[active].size >= min_size ) {
+         next = chunks[active].begin;
+         end = next + chunks[active].size;
+         return;
+      }
+   }
+
+   size_t size = chunks.empty() ? first_chunk_size : chunks.back().size * 2;
+   size = std::max( size, min_size );
+   char* begin = static_cast<char*>( std::malloc( size ) );
+   if( !begin )
+      throw std::bad_alloc();
+   chunks.push_back( chunk{ begin, size } );
+   active = chunks.size() - 1;
+   next = begin;
+   end = begin + size;
+   chunk_allocations.fetch_add( 1, std::memory_order_relaxed );
+   reserved_bytes.fetch_add( size, std::memory_order_relaxed );
+}
+
+void transaction_arena::release() {
+   releases.fetch_add( 1, std::memory_order_relaxed );
+   last_bytes.store( used, std::memory_order_relaxed );
+   uint64_t high = high_water_bytes.load( std::memory_order_relaxed );
+   while( used > high && !high_water_bytes.compare_exchange_weak( high, used, std::memory_order_relaxed ) ) {}
+
+   size_t retained = 0;
+   size_t keep = 0;
+   for( ; keep < chunks.size() && retained + chunks[keep].size <= max_retained_bytes; ++keep )
+      retained += chunks[keep].size;
+   keep = std::max<size_t>( keep, std::min<size_t>( chunks.size(), 1 ) );
+   for( size_t i = keep; i < chunks.size(); ++i ) {
+      reserved_bytes.fetch_sub( chunks[i].size, std::memory_order_relaxed );
+      std::free( chunks[i].begin );
+   }
+   chunks.resize( keep );
+
+   active = 0;
+   next = chunks.empty() ? nullptr : chunks[0].begin;
+   end = chunks.empty() ? nullptr : chunks[0].begin + chunks[0].size;
+   used = 0;
+}
+
+transaction_arena::~transaction_arena() {
+   for( const auto& c : chunks ) {
+      reserved_bytes.fetch_sub( c.size, std::memory_order_relaxed );
+      std::free( c.begin );
+   }
+}
+
+transaction_arena::scope::scope() {
+   if( !thread_arena )
+      thread_arena.reset( new transaction_arena );
+   ++thread_arena->depth;
+   open_arena = thread_arena.get();
+}
+
+transaction_arena::scope::~scope() {
+   if( --thread_arena->depth == 0 ) {
+      open_arena = nullptr;
+      thread_arena->release();
+   }
+}
+
+transaction_arena::stats transaction_arena::get_stats() {
+   stats result;
+   result.releases = releases.load( std::memory_order_relaxed );
+   result.last_bytes = last_bytes.load( std::memory_order_relaxed );
+   result.high_water_bytes = high_water_bytes.load( std::memory_order_relaxed );
+   result.reserved_bytes = reserved_bytes.load( std::memory_order_relaxed );
+   result.chunk_allocations = chunk_allocations.load( std::memory_order_relaxed );
+   return result;
+}
+
+void transaction_arena::reset_stats() {
+   for( auto* counter : { &releases, &last_bytes, &high_water_bytes, &chunk_allocations } )
+      counter->store( 0, std::memory_order_relaxed );
+}
+
+} } /// eosio::chain
@@ -571,6 +571,8 @@ namespace bacc = boost::accumulators;
    }
 
    void transaction_context::dispatch_action( action_trace& trace, const action& a, account_name receiver, bool context_free, uint32_t recurse_depth ) {
+      // the containers of acontext and of the inline actions it dispatches are released together when the top level action returns
+      transaction_arena::scope arena_scope;
       apply_context  acontext( control, *this, a, recurse_depth );
       acontext.context_free = context_free;
       acontext.receiver     = receiver;
@@ -9,20 +9,31 @@ bool is_nan( const float64_t f ) {
 bool is_nan( const float128_t& f ) {
    return (((~(f.v[1]) & uint64_t( 0x7FFF000000000000 )) == 0) && (f.v[0] || ((f.v[1]) & uint64_t( 0x0000FFFFFFFFFFFF ))));
 }
+//times every db intrinsic called by a contract, a no-op unless the action is being profiled
+struct db_profile_scope {
+   db_profile_scope() { apply_profiler::get().begin_phase(VM_PROFILE_DB); }
+   ~db_profile_scope() { apply_profiler::get().end_phase(VM_PROFILE_DB); }
+};
+#define DB_PROFILE() db_profile_scope _db_profile
+
 extern "C" {
 int32_t db_store_i64(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id,  const char* data, uint32_t len) {
+   DB_PROFILE();
    return ctx().db_store_i64(scope, table, payer, id, data, len);
 }
 
 int32_t db_store_i64_ex(uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, uint64_t id,  const char* data, uint32_t len) {
+   DB_PROFILE();
    return ctx().db_store_i64(code, scope, table, payer, id, data, len);
 }
 
 void db_update_i64(int32_t iterator, uint64_t payer, const char* data, uint32_t len) {
+   DB_PROFILE();
    ctx().db_update_i64(iterator, payer, data, len);
 }
 
 void db_update_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t id, const char* buffer, size_t buffer_size ) {
+   DB_PROFILE();
    int itr = ctx().db_find_i64(ctx().get_receiver(), scope, table, id);
    if (itr >= 0) {
       ctx().db_update_i64( itr, payer, buffer, buffer_size );
@@ -30,10 +41,12 @@ void db_update_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t
 }
 
 void db_remove_i64(int32_t iterator) {
+   DB_PROFILE();
    ctx().db_remove_i64(iterator);
 }
 
 void db_remove_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t id ) {
+   DB_PROFILE();
    int itr = ctx().db_find_i64(ctx().get_receiver(), scope, table, id);
    if (itr >= 0) {
       ctx().db_remove_i64( itr );
@@ -41,75 +54,105 @@ void db_remove_i64_ex( uint64_t scope, uint64_t payer, uint64_t table, uint64_t
 }
 
 int32_t db_get_i64(int32_t iterator, void* data, uint32_t len) {
+   DB_PROFILE();
    return ctx().db_get_i64(iterator, (char*)data, len);
 }
 
 int32_t db_get_i64_ex( int itr, uint64_t* primary, char* buffer, size_t buffer_size ) {
+   DB_PROFILE();
    return ctx().db_get_i64_ex( itr, *primary, buffer, buffer_size );
 }
 
 const char* db_get_i64_exex( int itr, size_t* buffer_size ) {
+   DB_PROFILE();
    return ctx().db_get_i64_exex( itr,  buffer_size);
 }
 
 int32_t db_next_i64(int32_t iterator, uint64_t* primary) {
+   DB_PROFILE();
    return ctx().db_next_i64(iterator, *primary);
 }
 
 int32_t db_previous_i64(int32_t iterator, uint64_t* primary) {
+   DB_PROFILE();
    return ctx().db_previous_i64(iterator, *primary);
 }
 
 int32_t db_find_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   DB_PROFILE();
    return ctx().db_find_i64(code, scope, table, id);
 }
 
 int32_t db_lowerbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   DB_PROFILE();
    return ctx().db_lowerbound_i64(code, scope, table, id);
 }
 
 int32_t db_upperbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+   DB_PROFILE();
    return ctx().db_upperbound_i64(code, scope, table, id);
 }
 
 int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
+   DB_PROFILE();
    return ctx().db_end_i64(code, scope, table);
 }
 
+int32_t db_scan_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len) {
+   DB_PROFILE();
+   return ctx().db_scan_i64(code, scope, table, *lower, upper, limit, (char*)data, len);
+}
+
+int32_t db_idx64_scan(uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len) {
+   DB_PROFILE();
+   return ctx().db_idx64_scan(code, scope, table, row_table, *secondary, *primary, upper, limit, (char*)data, len);
+}
+
 #define DB_API_METHOD_WRAPPERS_SIMPLE_SECONDARY_(IDX, TYPE)\
       int db_##IDX##_store( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const TYPE* secondary ) {\
+         DB_PROFILE();\
          return ctx().IDX.store( scope, table, payer, id, *secondary );\
       }\
       void db_##IDX##_update( int iterator, uint64_t payer, const TYPE* secondary ) {\
+         DB_PROFILE();\
          ctx().IDX.update( iterator, payer, *secondary );\
       }\
       void db_##IDX##_remove( int iterator ) {\
+         DB_PROFILE();\
          ctx().IDX.remove( iterator );\
       }\
       int db_##IDX##_find_secondary( uint64_t code, uint64_t scope, uint64_t table, const TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.find_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_find_primary( uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.find_primary(code, scope, table, *secondary, primary);\
       }\
       int db_##IDX##_lowerbound( uint64_t code, uint64_t scope, uint64_t table,  TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.lowerbound_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_upperbound( uint64_t code, uint64_t scope, uint64_t table,  TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.upperbound_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_end( uint64_t code, uint64_t scope, uint64_t table ) {\
+         DB_PROFILE();\
          return ctx().IDX.end_secondary(code, scope, table);\
       }\
       int db_##IDX##_next( int iterator, uint64_t* primary  ) {\
+         DB_PROFILE();\
          return ctx().IDX.next_secondary(iterator, *primary);\
       }\
       int db_##IDX##_previous( int iterator, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.previous_secondary(iterator, *primary);\
       }
 
 #define DB_API_METHOD_WRAPPERS_ARRAY_SECONDARY_(IDX, ARR_SIZE, ARR_ELEMENT_TYPE)\
       int db_##IDX##_store( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const ARR_ELEMENT_TYPE* data, size_t data_len) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -117,6 +160,7 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          return ctx().IDX.store(scope, table, payer, id, (const ARR_ELEMENT_TYPE*)data);\
       }\
       void db_##IDX##_update( int iterator, uint64_t payer, const void* data, size_t data_len ) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -124,9 +168,11 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          ctx().IDX.update(iterator, payer, (const ARR_ELEMENT_TYPE*)data);\
       }\
       void db_##IDX##_remove( int iterator ) {\
+         DB_PROFILE();\
          ctx().IDX.remove(iterator);\
       }\
       int db_##IDX##_find_secondary( uint64_t code, uint64_t scope, uint64_t table, const ARR_ELEMENT_TYPE* data, size_t data_len, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -134,6 +180,7 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          return ctx().IDX.find_secondary(code, scope, table, (const ARR_ELEMENT_TYPE*)data, *primary);\
       }\
       int db_##IDX##_find_primary( uint64_t code, uint64_t scope, uint64_t table, ARR_ELEMENT_TYPE* data, size_t data_len, uint64_t primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -141,6 +188,7 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          return ctx().IDX.find_primary(code, scope, table, (ARR_ELEMENT_TYPE*)data, primary);\
       }\
       int db_##IDX##_lowerbound( uint64_t code, uint64_t scope, uint64_t table, ARR_ELEMENT_TYPE* data, size_t data_len, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -148,6 +196,7 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          return ctx().IDX.lowerbound_secondary(code, scope, table, (ARR_ELEMENT_TYPE*)data, *primary);\
       }\
       int db_##IDX##_upperbound( uint64_t code, uint64_t scope, uint64_t table, ARR_ELEMENT_TYPE* data, size_t data_len, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( data_len == ARR_SIZE,\
               db_api_exception,\
                     "invalid size of secondary key array for " #IDX ": given ${given} bytes but expected ${expected} bytes",\
@@ -155,49 +204,62 @@ int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
          return ctx().IDX.upperbound_secondary(code, scope, table, (ARR_ELEMENT_TYPE*)data, *primary);\
       }\
       int db_##IDX##_end( uint64_t code, uint64_t scope, uint64_t table ) {\
+         DB_PROFILE();\
          return ctx().IDX.end_secondary(code, scope, table);\
       }\
       int db_##IDX##_next( int iterator, uint64_t* primary  ) {\
+         DB_PROFILE();\
          return ctx().IDX.next_secondary(iterator, *primary);\
       }\
       int db_##IDX##_previous( int iterator, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.previous_secondary(iterator, *primary);\
       }
 
 #define DB_API_METHOD_WRAPPERS_FLOAT_SECONDARY_(IDX, TYPE)\
       int db_##IDX##_store( uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const TYPE* secondary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( !is_nan( *secondary ), transaction_exception, "NaN is not an allowed value for a secondary key" );\
          return ctx().IDX.store( scope, table, payer, id, *secondary );\
       }\
       void db_##IDX##_update( int iterator, uint64_t payer, const TYPE* secondary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( !is_nan( *secondary ), transaction_exception, "NaN is not an allowed value for a secondary key" );\
          ctx().IDX.update( iterator, payer, *secondary );\
       }\
       void db_##IDX##_remove( int iterator ) {\
+         DB_PROFILE();\
          ctx().IDX.remove( iterator );\
       }\
       int db_##IDX##_find_secondary( uint64_t code, uint64_t scope, uint64_t table, const TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( !is_nan( *secondary ), transaction_exception, "NaN is not an allowed value for a secondary key" );\
          return ctx().IDX.find_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_find_primary( uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.find_primary(code, scope, table, *secondary, primary);\
       }\
       int db_##IDX##_lowerbound( uint64_t code, uint64_t scope, uint64_t table,  TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( !is_nan( *secondary ), transaction_exception, "NaN is not an allowed value for a secondary key" );\
          return ctx().IDX.lowerbound_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_upperbound( uint64_t code, uint64_t scope, uint64_t table,  TYPE* secondary, uint64_t* primary ) {\
+         DB_PROFILE();\
          EOS_ASSERT( !is_nan( *secondary ), transaction_exception, "NaN is not an allowed value for a secondary key" );\
          return ctx().IDX.upperbound_secondary(code, scope, table, *secondary, *primary);\
       }\
       int db_##IDX##_end( uint64_t code, uint64_t scope, uint64_t table ) {\
+         DB_PROFILE();\
          return ctx().IDX.end_secondary(code, scope, table);\
       }\
       int db_##IDX##_next( int iterator, uint64_t* primary  ) {\
+         DB_PROFILE();\
          return ctx().IDX.next_secondary(iterator, *primary);\
       }\
       int db_##IDX##_previous( int iterator, uint64_t* primary ) {\
+         DB_PROFILE();\
          return ctx().IDX.previous_secondary(iterator, *primary);\
       }
 
@@ -208,12 +270,14 @@ DB_API_METHOD_WRAPPERS_FLOAT_SECONDARY_(idx_double, float64_t)
 DB_API_METHOD_WRAPPERS_FLOAT_SECONDARY_(idx_long_double, float128_t)
 
 int get_table_item_count(uint64_t code, uint64_t scope, uint64_t table) {
+   DB_PROFILE();
    return ctx().get_table_item_count(code, scope, table);
 }
 
 }
 
 int db_store_i256( uint64_t code, uint64_t scope, uint64_t table, uint64_t payer, void* id, int size, const char* buffer, size_t buffer_size ) {
+   DB_PROFILE();
    eosio_assert(size == sizeof(key256_t), "wrong id!");
    key256_t key;
    memcpy(key.data(),id, 32);
@@ -221,18 +285,22 @@ int db_store_i256( uint64_t code, uint64_t scope, uint64_t table, uint64_t payer
 }
 
 void db_update_i256( int iterator, uint64_t payer, const char* buffer, size_t buffer_size ) {
+   DB_PROFILE();
    return ctx().db_update_i256(iterator, payer, buffer, buffer_size, false);
 }
 
 void db_remove_i256( int iterator ) {
+   DB_PROFILE();
    return ctx().db_remove_i256(iterator);
 }
 
 int db_get_i256( int iterator, char* buffer, size_t buffer_size ) {
+   DB_PROFILE();
    return ctx().db_get_i256(iterator, buffer, buffer_size);
 }
 
 int db_find_i256( uint64_t code, uint64_t scope, uint64_t table, void* id, int size ) {
+   DB_PROFILE();
    eosio_assert(size == 32, "wrong id!");
    key256_t key;
    memcpy(key.data(),id, 32);
@@ -31,6 +31,7 @@
 #include <dlfcn.h>
 
 #include <vm_manager.hpp>
+#include <apply_profiler.hpp>
 #include <appbase/application.hpp>
 
 #include <eosio/chain/db_api.h>
@@ -318,6 +319,14 @@ void resume_billing_timer() {
    ctx().trx_context.resume_billing_timer();
 }
 
+void vm_profile_begin(int phase) {
+   apply_profiler::get().begin_phase(phase);
+}
+
+void vm_profile_end(int phase) {
+   apply_profiler::get().end_phase(phase);
+}
+
 void pause_billing_timer() {
    ctx().trx_context.pause_billing_timer();
 }
@@ -548,6 +557,7 @@ extern "C" void vm_api_init() {
       _vm_api.db_lowerbound_i64 = db_lowerbound_i64;
       _vm_api.db_upperbound_i64 = db_upperbound_i64;
       _vm_api.db_end_i64 = db_end_i64;
+      _vm_api.db_scan_i64 = db_scan_i64;
 
 
       _vm_api.db_store_i256 = db_store_i256;
@@ -570,6 +580,7 @@ extern "C" void vm_api_init() {
       _vm_api.db_idx64_lowerbound = db_idx64_lowerbound;
       _vm_api.db_idx64_upperbound = db_idx64_upperbound;
       _vm_api.db_idx64_end = db_idx64_end;
+      _vm_api.db_idx64_scan = db_idx64_scan;
       _vm_api.db_idx128_store = db_idx128_store;
 
       _vm_api.db_idx128_update = db_idx128_update;
@@ -734,6 +745,8 @@ extern "C" void vm_api_init() {
       _vm_api.ethaddr2n = nullptr;
       _vm_api.n2ethaddr = nullptr;
       _vm_api.is_contracts_console_enabled = is_contracts_console_enabled;
+      _vm_api.profile_begin = vm_profile_begin;
+      _vm_api.profile_end = vm_profile_end;
    }
    vm_register_api(&_vm_api);
 
@@ -12,8 +12,14 @@
 #include "Runtime/Linker.h"
 #include "Runtime/Intrinsics.h"
 
+#include <eosiolib_native/vm_profile.h>
+
+#include <fc/scoped_exit.hpp>
 #include <mutex>
 
+void vm_profile_begin(int phase);
+void vm_profile_end(int phase);
+
 using namespace IR;
 using namespace Runtime;
 using namespace eosio::chain;
@@ -28,51 +34,70 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
          _initial_memory(initial_mem),
          _instance(instance),
          _module(std::move(module))
-      {}
+      {
+         //resolve everything apply() needs up front, so the per-notification path is just a memory and
+         // globals reset followed by a direct invoke
+         _apply = asFunctionNullable(getInstanceExport(_instance, "apply"));
+         if( _apply ) {
+            const FunctionType* type = getFunctionType(_apply);
+            EOS_ASSERT( type->parameters.size() == 3, wasm_exception, "apply has wrong number of parameters" );
+            for( auto param : type->parameters ) {
+               EOS_ASSERT( param == ValueType::i64, wasm_exception, "apply has wrong parameter type" );
+            }
+         }
+         _start = getInstanceStartFunc(_instance);
+         _default_mem = getDefaultMemory(_instance);
+      }
 
       void apply(uint64_t receiver, uint64_t account, uint64_t act) override {
-         vector<Value> args = {
-               Value(receiver),
-	            Value(account),
-               Value(act)
-         };
-         call("apply", args);
+         if( !_apply )
+            return;
+         UntaggedValue args[3] = { receiver, account, act };
+         invoke(_apply, args);
       }
 
       uint64_t call(const string &entry_point, const vector <uint64_t> & _args) override {
-         vector<Value> args;
-         for(auto& arg: _args) {
-            args.push_back(Value(uint64_t(arg)));
+         FunctionInstance* call = asFunctionNullable(getInstanceExport(_instance,entry_point));
+         if( !call )
+            return 0;
+
+         const FunctionType* type = getFunctionType(call);
+         EOS_ASSERT( type->parameters.size() == _args.size(), wasm_exception, "" );
+         for( auto param : type->parameters ) {
+            EOS_ASSERT( param == ValueType::i64, wasm_exception, "" );
          }
-         return call(entry_point, args);
+
+         vector<UntaggedValue> args(_args.begin(), _args.end());
+         return invoke(call, args.data());
       }
    private:
-      uint64_t call(const string &entry_point, const vector <Value> &args) {
+      uint64_t invoke(FunctionInstance* call, const UntaggedValue* args) {
          try {
-            FunctionInstance* call = asFunctionNullable(getInstanceExport(_instance,entry_point));
-            if( !call )
-               return 0;
-
-            EOS_ASSERT( getFunctionType(call)->parameters.size() == args.size(), wasm_exception, "" );
-
+            vm_profile_begin(VM_PROFILE_INSTANTIATE);
+            auto instantiated = fc::make_scoped_exit([](){
+               vm_profile_end(VM_PROFILE_INSTANTIATE);
+            });
             //The memory instance is reused across all wavm_instantiated_modules, but for wasm instances
             // that didn't declare "memory", getDefaultMemory() won't see it
-            MemoryInstance* default_mem = getDefaultMemory(_instance);
-            if(default_mem) {
+            if(_default_mem) {
                //reset memory resizes the sandbox'ed memory to the module's init memory size and then
                // (effectively) memzeros it all
-               resetMemory(default_mem, _module->memories.defs[0].type);
+               resetMemory(_default_mem, _module->memories.defs[0].type);
 
-               char* memstart = &memoryRef<char>(getDefaultMemory(_instance), 0);
+               char* memstart = &memoryRef<char>(_default_mem, 0);
                memcpy(memstart, _initial_memory.data(), _initial_memory.size());
             }
 
-            the_running_instance_context.memory = default_mem;
+            the_running_instance_context.memory = _default_mem;
 //            the_running_instance_context.apply_ctx = &context;
 
             resetGlobalInstances(_instance);
-            runInstanceStartFunc(_instance);
-            return Runtime::invokeFunction(call,args).u64;
+            if(_start) {
+               invokeFunctionUnchecked(_start, nullptr);
+            }
+            instantiated.cancel();
+            vm_profile_end(VM_PROFILE_INSTANTIATE);
+            return invokeFunctionUnchecked(call, args).u64;
          } catch( const wasm_exit& e ) {
          } catch( const Runtime::Exception& e ) {
              FC_THROW_EXCEPTION(wasm_execution_error,
@@ -89,6 +114,10 @@ class wavm_instantiated_module : public wasm_instantiated_module_interface {
       //_instance is deleted via WAVM's object garbage collection when wavm_rutime is deleted
       ModuleInstance*          _instance;
       std::unique_ptr<Module>  _module;
+      //resolved once at instantiation; owned by _instance
+      FunctionInstance*        _apply = nullptr;
+      FunctionInstance*        _start = nullptr;
+      MemoryInstance*          _default_mem = nullptr;
 };
 
 
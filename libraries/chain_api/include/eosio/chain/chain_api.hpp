@@ -5,6 +5,7 @@
 #include <eosio/chain/action.hpp>
 #include <eosio/chain/transaction.hpp>
 #include <eosio/chain/block.hpp>
+#include <eosio/chain/state_mapping.hpp>
 
 using namespace fc;
 using namespace std;
@@ -31,6 +32,7 @@ namespace eosio { namespace chain {
       virtual void fc_pack_args(uint64_t code, uint64_t action, string& json, string& bin);
       virtual variant fc_unpack_args(uint64_t code, uint64_t action, string& bin);
       virtual string state_dir();
+      virtual state_mapping_config state_mapping();
 
 
 
@@ -0,0 +1,45 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <fc/filesystem.hpp>
+#include <fc/optional.hpp>
+#include <fc/reflect/reflect.hpp>
+
+namespace chainbase { class database; }
+
+namespace eosio { namespace chain {
+
+   enum class huge_pages_mode {
+      NONE,      ///< 4 KB pages
+      THP,       ///< madvise(MADV_HUGEPAGE), transparent huge pages for a state dir on tmpfs (shmem_enabled=advise)
+      HUGETLBFS  ///< the state dir is a hugetlbfs mount, its page size (2 MB or 1 GB) backs the whole file
+   };
+
+   /**
+    *  How the state file is mapped in memory. Every mapping of shared_memory.bin applies it, the controller's
+    *  and the db_api one of the vm processes, so they keep sharing the same file and page cache.
+    */
+   struct state_mapping_config {
+      huge_pages_mode       huge_pages = huge_pages_mode::NONE;
+      /// node the pages of the state are preferably allocated on and the chain thread runs on
+      fc::optional<uint32_t> numa_node;
+      /// reads every page of the state before the controller starts, the other mappings are not prefaulted
+      bool                  prefault = false;
+   };
+
+   /// applies the huge page and NUMA memory policy of cfg to the mapping of db, whose file is in dir
+   void map_state( const chainbase::database& db, const fc::path& dir, const state_mapping_config& cfg );
+
+   /// faults in every page of the mapping of db, returns the number of bytes read
+   uint64_t prefault_state( const chainbase::database& db );
+
+   /// restricts the calling thread, and the threads it creates from now on, to the cpus of node
+   void bind_thread_to_numa_node( uint32_t node );
+
+} } /// eosio::chain
+
+FC_REFLECT_ENUM( eosio::chain::huge_pages_mode, (NONE)(THP)(HUGETLBFS) )
+FC_REFLECT( eosio::chain::state_mapping_config, (huge_pages)(numa_node)(prefault) )
@@ -0,0 +1,120 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/state_mapping.hpp>
+
+#include <chainbase/chainbase.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <linux/magic.h>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+
+namespace eosio { namespace chain {
+
+namespace {
+
+   struct mapped_range {
+      char*  begin;
+      size_t size;
+   };
+
+   /// the segment manager is at the start of the mapping and spans the rest of the file
+   mapped_range state_range( const chainbase::database& db ) {
+      const auto* segment = db.get_segment_manager();
+      const uintptr_t page_mask = ~uintptr_t( sysconf(_SC_PAGESIZE) - 1 );
+      uintptr_t begin = reinterpret_cast<uintptr_t>(segment) & page_mask;
+      uintptr_t end = reinterpret_cast<uintptr_t>(segment) + segment->get_size();
+      return mapped_range{ reinterpret_cast<char*>(begin), size_t(end - begin) };
+   }
+
+   /// the cpus of a "0-7,16-23" list
+   cpu_set_t parse_cpu_list( const std::string& list ) {
+      cpu_set_t cpus;
+      CPU_ZERO( &cpus );
+      std::istringstream in( list );
+      std::string item;
+      while( std::getline( in, item, ',' ) ) {
+         if( item.empty() || item == "\n" ) continue;
+         auto dash = item.find( '-' );
+         int first = std::stoi( item.substr( 0, dash ) );
+         int last = dash == std::string::npos ? first : std::stoi( item.substr( dash + 1 ) );
+         for( int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu )
+            CPU_SET( cpu, &cpus );
+      }
+      return cpus;
+   }
+}
+
+void map_state( const chainbase::database& db, const fc::path& dir, const state_mapping_config& cfg ) {
+   auto range = state_range( db );
+
+   switch( cfg.huge_pages ) {
+      case huge_pages_mode::NONE:
+         break;
+      case huge_pages_mode::THP:
+         if( madvise( range.begin, range.size, MADV_HUGEPAGE ) != 0 )
+            wlog( "transparent huge pages are not available for the state in ${dir}: ${e}", ("dir", dir.generic_string())("e", strerror(errno)) );
+         break;
+      case huge_pages_mode::HUGETLBFS: {
+         // the mapping of a file on hugetlbfs is made of huge pages, nothing to ask for but checking it is one
+         struct statfs fs;
+         FC_ASSERT( statfs( dir.generic_string().c_str(), &fs ) == 0 && fs.f_type == HUGETLBFS_MAGIC,
+                    "huge pages from hugetlbfs need the state directory ${dir} to be on a hugetlbfs mount", ("dir", dir.generic_string()) );
+         FC_ASSERT( fc::file_size( dir / "shared_memory.bin" ) % fs.f_bsize == 0,
+                    "the state size must be a multiple of the ${size} bytes huge pages of ${dir}", ("size", uint64_t(fs.f_bsize))("dir", dir.generic_string()) );
+         break;
+      }
+   }
+
+   if( cfg.numa_node ) {
+      FC_ASSERT( *cfg.numa_node < 64, "numa node ${n} is out of range", ("n", *cfg.numa_node) );
+      // preferred rather than bound, a state larger than the node spills over instead of failing
+      unsigned long nodemask = 1ul << *cfg.numa_node;
+      if( syscall( SYS_mbind, range.begin, range.size, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8, MPOL_MF_MOVE ) != 0 )
+         wlog( "unable to set the memory policy of the state to numa node ${n}: ${e}", ("n", *cfg.numa_node)("e", strerror(errno)) );
+   }
+}
+
+uint64_t prefault_state( const chainbase::database& db ) {
+   auto range = state_range( db );
+   if( madvise( range.begin, range.size, MADV_POPULATE_READ ) == 0 )
+      return range.size;
+
+   // kernels before 5.14, one read per page
+   const size_t page_size = sysconf(_SC_PAGESIZE);
+   volatile char sink = 0;
+   for( size_t offset = 0; offset < range.size; offset += page_size )
+      sink ^= range.begin[offset];
+   (void)sink;
+   return range.size;
+}
+
+void bind_thread_to_numa_node( uint32_t node ) {
+   std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+   std::ifstream in( path );
+   std::string list;
+   FC_ASSERT( in && std::getline( in, list ), "numa node ${n} does not exist", ("n", node) );
+
+   cpu_set_t cpus = parse_cpu_list( list );
+   FC_ASSERT( CPU_COUNT( &cpus ) > 0, "numa node ${n} has no cpus", ("n", node) );
+   if( sched_setaffinity( 0, sizeof(cpus), &cpus ) != 0 )
+      wlog( "unable to bind the chain thread to numa node ${n}: ${e}", ("n", node)("e", strerror(errno)) );
+}
+
+} } /// eosio::chain
@@ -11,6 +11,8 @@
 
 #include <eosio/chain/db_api.hpp>
 #include <eosio/chain/chain_api.h>
+#include <eosio/chain/chain_api.hpp>
+#include <eosio/chain/state_mapping.hpp>
 
 using boost::container::flat_set;
 using namespace fc;
@@ -42,6 +44,7 @@ idx_long_double(*this)
    db.add_index<table_id_multi_index>();
    db.add_index<key_value_index>();
    db.add_index<key256_value_index>();
+   db.add_index<table_stats_index>();
 
    db.add_index<index64_index>();
    db.add_index<index128_index>();
@@ -56,6 +59,9 @@ idx_long_double(*this)
    db.add_index<generated_transaction_multi_index>();
 
    db.add_index<action_object_index>();
+
+   // the same huge page and numa policy as the controller's mapping of the file, prefaulting is left to it
+   map_state( db, get_path(), get_chain_api().state_mapping() );
 }
 
 bool db_api::get_action(action& act) {
@@ -178,6 +184,7 @@ int db_api::db_store_i64( uint64_t code, uint64_t scope, uint64_t table, const a
 
    int64_t billable_size = (int64_t)(buffer_size + config::billable_size_v<key_value_object>);
    update_db_usage( payer, billable_size);
+   update_table_stats( db, tab.code, tab.table, {1, 0, (int64_t)buffer_size, billable_size} );
 
    keyval_cache.cache_table( tab );
    return keyval_cache.add( obj );
@@ -211,6 +218,10 @@ void db_api::db_update_i64( int iterator, account_name payer, const char* buffer
       update_db_usage( obj.payer, new_size - old_size);
    }
 
+   if( old_size != new_size ) {
+      update_table_stats( db, table_obj.code, table_obj.table, {0, 0, new_size - old_size, new_size - old_size} );
+   }
+
    db.modify( obj, [&]( auto& o ) {
      o.value.resize( buffer_size );
      memcpy( o.value.data(), buffer, buffer_size );
@@ -227,6 +238,8 @@ void db_api::db_remove_i64( int iterator ) {
 //   require_write_lock( table_obj.scope );
 
    update_db_usage( obj.payer,  -(obj.value.size() + config::billable_size_v<key_value_object>) );
+   update_table_stats( db, table_obj.code, table_obj.table,
+                       {-1, 0, -(int64_t)obj.value.size(), -(int64_t)(obj.value.size() + config::billable_size_v<key_value_object>)} );
 
    db.modify( table_obj, [&]( auto& t ) {
       --t.count;
@@ -422,6 +435,84 @@ int db_api::db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
    return keyval_cache.cache_table( *tab );
 }
 
+/**
+ * Same record layout and continuation as apply_context::db_scan_i64, read from the mapped state
+ * for the vms running out of the chain process.
+ */
+int db_api::db_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t& lower, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size ) {
+   const auto* tab = find_table( code, scope, table );
+   if( !tab ) {
+      lower = upper;
+      return 0;
+   }
+
+   const auto& idx = db.get_index<key_value_index, by_scope_primary>();
+   auto itr = idx.lower_bound( boost::make_tuple( tab->id, lower ) );
+
+   uint32_t count = 0;
+   size_t pos = 0;
+   for( ; itr != idx.end() && itr->t_id == tab->id && itr->primary_key < upper; ++itr ) {
+      uint32_t size = itr->value.size();
+      size_t record_size = sizeof(uint64_t) + sizeof(uint32_t) + size;
+      if( (limit && count == limit) || pos + record_size > buffer_size ) {
+         lower = itr->primary_key;
+         return count ? int(count) : -int(record_size);
+      }
+      memcpy( buffer + pos, &itr->primary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + sizeof(uint64_t), &size, sizeof(uint32_t) );
+      memcpy( buffer + pos + sizeof(uint64_t) + sizeof(uint32_t), itr->value.data(), size );
+      pos += record_size;
+      ++count;
+   }
+
+   lower = upper;
+   return count;
+}
+
+/**
+ * Same record layout and continuation as apply_context::db_idx64_scan.
+ */
+int db_api::db_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t& secondary, uint64_t& primary, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size ) {
+   const auto* tab = find_table( code, scope, table );
+   if( !tab ) {
+      secondary = upper;
+      primary = 0;
+      return 0;
+   }
+   const auto* rows = find_table( code, scope, row_table );
+
+   const auto& idx = db.get_index<index64_index, by_secondary>();
+   auto itr = idx.lower_bound( boost::make_tuple( tab->id, secondary, primary ) );
+
+   uint32_t count = 0;
+   size_t pos = 0;
+   for( ; itr != idx.end() && itr->t_id == tab->id && itr->secondary_key < upper; ++itr ) {
+      const key_value_object* obj = nullptr;
+      if( rows ) {
+         obj = db.find<key_value_object, by_scope_primary>( boost::make_tuple( rows->id, itr->primary_key ) );
+      }
+      uint32_t size = obj ? obj->value.size() : 0;
+      size_t record_size = 2 * sizeof(uint64_t) + sizeof(uint32_t) + size;
+      if( (limit && count == limit) || pos + record_size > buffer_size ) {
+         secondary = itr->secondary_key;
+         primary = itr->primary_key;
+         return count ? int(count) : -int(record_size);
+      }
+      memcpy( buffer + pos, &itr->secondary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + sizeof(uint64_t), &itr->primary_key, sizeof(uint64_t) );
+      memcpy( buffer + pos + 2 * sizeof(uint64_t), &size, sizeof(uint32_t) );
+      if( size ) {
+         memcpy( buffer + pos + 2 * sizeof(uint64_t) + sizeof(uint32_t), obj->value.data(), size );
+      }
+      pos += record_size;
+      ++count;
+   }
+
+   secondary = upper;
+   primary = 0;
+   return count;
+}
+
 int db_api::db_store_i256( uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size ) {
    return db_store_i256( get_receiver(), scope, table, payer, id, buffer, buffer_size);
 }
@@ -447,6 +538,7 @@ int db_api::db_store_i256( uint64_t code, uint64_t scope, uint64_t table, const
 
    int64_t billable_size = (int64_t)(buffer_size + config::billable_size_v<key256_value_object>);
    update_db_usage( payer, billable_size);
+   update_table_stats( db, tab.code, tab.table, {1, 0, (int64_t)buffer_size, billable_size} );
 
    key256val_cache.cache_table( tab );
    return key256val_cache.add( obj );
@@ -478,6 +570,10 @@ void db_api::db_update_i256( int iterator, account_name payer, const char* buffe
       update_db_usage( obj.payer, new_size - old_size);
    }
 
+   if( old_size != new_size ) {
+      update_table_stats( db, table_obj.code, table_obj.table, {0, 0, new_size - old_size, new_size - old_size} );
+   }
+
    db.modify( obj, [&]( auto& o ) {
      o.value.resize( buffer_size );
      memcpy( o.value.data(), buffer, buffer_size );
@@ -496,6 +592,8 @@ void db_api::db_remove_i256( int iterator, bool check_code ) {
 //   require_write_lock( table_obj.scope );
 
    update_db_usage( obj.payer,  -(obj.value.size() + config::billable_size_v<key256_value_object>) );
+   update_table_stats( db, table_obj.code, table_obj.table,
+                       {-1, 0, -(int64_t)obj.value.size(), -(int64_t)(obj.value.size() + config::billable_size_v<key256_value_object>)} );
 
    db.modify( table_obj, [&]( auto& t ) {
       --t.count;
@@ -627,6 +725,14 @@ int db_api_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
    return db_api::get().db_end_i64(code, scope, table);
 }
 
+int32_t db_api_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len ) {
+   return db_api::get().db_scan_i64(code, scope, table, *lower, upper, limit, (char*)data, len);
+}
+
+int32_t db_api_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len ) {
+   return db_api::get().db_idx64_scan(code, scope, table, row_table, *secondary, *primary, upper, limit, (char*)data, len);
+}
+
 
 void db_api_update_i256( int iterator, uint64_t payer, const char* buffer, size_t buffer_size ) {
    return db_api::get().db_update_i256(iterator, payer, buffer, buffer_size);
@@ -24,6 +24,8 @@ int db_api_find_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id
 int db_api_lowerbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
 int db_api_upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
 int db_api_end_i64( uint64_t code, uint64_t scope, uint64_t table );
+int32_t db_api_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, void* data, uint32_t len );
+int32_t db_api_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, void* data, uint32_t len );
 
 void db_api_update_i256( int iterator, uint64_t payer, const char* buffer, size_t buffer_size );
 void db_api_remove_i256( int iterator );
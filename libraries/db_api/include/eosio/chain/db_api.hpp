@@ -13,6 +13,8 @@
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/transaction.hpp>
 #include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/table_stats_object.hpp>
+#include <eosio/chain/flat_hash_map.hpp>
 #include <eosio/chain/exceptions.hpp>
 
 namespace chainbase { class database; }
@@ -27,33 +29,35 @@ class db_api {
    template<typename T>
    class iterator_cache {
       public:
-         iterator_cache(){
+         iterator_cache()
+         :_table_cache(8)
+         ,_object_to_iterator(32)
+         {
             _end_iterator_to_table.reserve(8);
             _iterator_to_object.reserve(32);
          }
 
          /// Returns end iterator of the table.
          int cache_table( const table_id_object& tobj ) {
-            auto itr = _table_cache.find(tobj.id);
-            if( itr != _table_cache.end() )
-               return itr->second.second;
+            if( const auto* cached = _table_cache.find(tobj.id._id) )
+               return cached->second;
 
             auto ei = index_to_end_iterator(_end_iterator_to_table.size());
             _end_iterator_to_table.push_back( &tobj );
-            _table_cache.emplace( tobj.id, make_pair(&tobj, ei) );
+            _table_cache.set( tobj.id._id, make_pair(&tobj, ei) );
             return ei;
          }
 
          const table_id_object& get_table( table_id_object::id_type i )const {
-            auto itr = _table_cache.find(i);
-            EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
-            return *itr->second.first;
+            const auto* cached = _table_cache.find(i._id);
+            EOS_ASSERT( cached, table_not_in_cache, "an invariant was broken, table should be in cache" );
+            return *cached->first;
          }
 
          int get_end_iterator_by_table_id( table_id_object::id_type i )const {
-            auto itr = _table_cache.find(i);
-            EOS_ASSERT( itr != _table_cache.end(), table_not_in_cache, "an invariant was broken, table should be in cache" );
-            return itr->second.second;
+            const auto* cached = _table_cache.find(i._id);
+            EOS_ASSERT( cached, table_not_in_cache, "an invariant was broken, table should be in cache" );
+            return cached->second;
          }
 
          const table_id_object* find_table_by_end_iterator( int ei )const {
@@ -83,21 +87,20 @@ class db_api {
          }
 
          int add( const T& obj ) {
-            auto itr = _object_to_iterator.find( &obj );
-            if( itr != _object_to_iterator.end() )
-                 return itr->second;
+            if( const auto* itr = _object_to_iterator.find( &obj ) )
+                 return *itr;
 
             _iterator_to_object.push_back( &obj );
-            _object_to_iterator[&obj] = _iterator_to_object.size() - 1;
+            _object_to_iterator.set( &obj, _iterator_to_object.size() - 1 );
 
             return _iterator_to_object.size() - 1;
          }
 
       private:
-         map<table_id_object::id_type, pair<const table_id_object*, int>> _table_cache;
-         vector<const table_id_object*>                  _end_iterator_to_table;
-         vector<const T*>                                _iterator_to_object;
-         map<const T*,int>                               _object_to_iterator;
+         flat_hash_map<int64_t, pair<const table_id_object*, int>> _table_cache;
+         vector<const table_id_object*>                            _end_iterator_to_table;
+         vector<const T*>                                          _iterator_to_object;
+         flat_hash_map<const T*, int>                              _object_to_iterator;
 
          /// Precondition: std::numeric_limits<int>::min() < ei < -1
          /// Iterator of -1 is reserved for invalid iterators (i.e. when the appropriate table has not yet been created).
@@ -200,6 +203,7 @@ class db_api {
                });
 
                context.update_db_usage( payer, config::billable_size_v<ObjectType> );
+               update_table_stats( context.db, tab.code, tab.table, {0, 1, 0, config::billable_size_v<ObjectType>} );
 
                itr_cache.cache_table( tab );
                return itr_cache.add( obj );
@@ -214,6 +218,9 @@ class db_api {
 
 //               context.require_write_lock( table_obj.scope );
 
+               update_table_stats( context.db, table_obj.code, table_obj.table,
+                                   {0, -1, 0, -(int64_t)config::billable_size_v<ObjectType>} );
+
                context.db.modify( table_obj, [&]( auto& t ) {
                   --t.count;
                });
@@ -572,6 +579,8 @@ class db_api {
       int  db_lowerbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
       int  db_upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id );
       int  db_end_i64( uint64_t code, uint64_t scope, uint64_t table );
+      int  db_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t& lower, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size );
+      int  db_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t& secondary, uint64_t& primary, uint64_t upper, uint32_t limit, char* buffer, size_t buffer_size );
 
       int  db_store_i256( uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size );
       int  db_store_i256( uint64_t code, uint64_t scope, uint64_t table, const account_name& payer, key256_t& id, const char* buffer, size_t buffer_size );
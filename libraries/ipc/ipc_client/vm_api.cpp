@@ -125,6 +125,9 @@ static struct vm_api _vm_api = {
 };
 
 void vm_manager_init(int vm_type) {
+   //range scans only read, they are served from the mapped state
+   _vm_api.db_scan_i64 = db_api_scan_i64;
+   _vm_api.db_idx64_scan = db_api_idx64_scan;
    vm_register_api(&_vm_api);
    vm_manager::get().set_vm_api(&_vm_api);
    vm_manager::get().load_vm(vm_type);
@@ -377,6 +377,7 @@ extern "C" void cpp_init_eosapi() {
    s_eosapi.db_lowerbound_i64 = mp_db_lowerbound_i64;
    s_eosapi.db_upperbound_i64 = mp_db_upperbound_i64;
    s_eosapi.db_end_i64 = mp_db_end_i64;
+   //eosapi has no db_scan_i64/db_idx64_scan slots, vm_api_rpc serves them from the mapped state with db_api_scan_i64
 
    s_eosapi.is_account = mp_is_account;
 
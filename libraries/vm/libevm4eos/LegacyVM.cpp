@@ -21,9 +21,16 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
-uint64_t LegacyVM::memNeed(u256 _offset, u256 _size)
+uint64_t LegacyVM::memNeed(u256 const& _offset, u256 const& _size)
 {
+#if EVM_UINT256
+	uint64_t end = memEnd(fromBoost(_offset), fromBoost(_size));
+	if (end == UINT64_MAX)
+		throwOutOfGas();
+	return end;
+#else
 	return toInt63(_size ? u512(_offset) + _size : u512(0));
+#endif
 }
 
 template <class S> S divWorkaround(S const& _a, S const& _b)
@@ -298,7 +305,11 @@ void LegacyVM::interpretCases()
 			updateMem(toInt63(m_SP[0]) + 32);
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBigEndian(m_mem.data() + (unsigned)m_SP[0]));
+#else
 			m_SPP[0] = (u256)*(h256 const*)(m_mem.data() + (unsigned)m_SP[0]);
+#endif
 		}
 		NEXT
 
@@ -308,7 +319,11 @@ void LegacyVM::interpretCases()
 			updateMem(toInt63(m_SP[0]) + 32);
 			updateIOGas();
 
+#if EVM_UINT256
+			toBigEndian(fromBoost(m_SP[1]), &m_mem[(unsigned)m_SP[0]]);
+#else
 			*(h256*)&m_mem[(unsigned)m_SP[0]] = (h256)m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -318,7 +333,11 @@ void LegacyVM::interpretCases()
 			updateMem(toInt63(m_SP[0]) + 1);
 			updateIOGas();
 
+#if EVM_UINT256
+			m_mem[(unsigned)m_SP[0]] = (byte)fromBoost(m_SP[1]).w[0];
+#else
 			m_mem[(unsigned)m_SP[0]] = (byte)(m_SP[1] & 0xff);
+#endif
 		}
 		NEXT
 
@@ -402,13 +421,17 @@ void LegacyVM::interpretCases()
 
 		CASE(EXP)
 		{
-			u256 expon = m_SP[1];
 //			m_runGas = toInt63(m_schedule->expGas + m_schedule->expByteGas * (32 - (h256(expon).firstBitSet() / 8)));
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], power(fromBoost(m_SP[0]), fromBoost(m_SP[1])));
+#else
+			u256 expon = m_SP[1];
 			u256 base = m_SP[0];
 			m_SPP[0] = exp256(base, expon);
+#endif
 		}
 		NEXT
 
@@ -422,7 +445,11 @@ void LegacyVM::interpretCases()
 			updateIOGas();
 
 			//pops two items and pushes their sum mod 2^256.
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) + fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] + m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -432,7 +459,11 @@ void LegacyVM::interpretCases()
 			updateIOGas();
 
 			//pops two items and pushes their product mod 2^256.
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) * fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] * m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -441,7 +472,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) - fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] - m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -450,7 +485,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) / fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[1] ? divWorkaround(m_SP[0], m_SP[1]) : 0;
+#endif
 		}
 		NEXT
 
@@ -459,7 +498,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], sdiv(fromBoost(m_SP[0]), fromBoost(m_SP[1])));
+#else
 			m_SPP[0] = m_SP[1] ? s2u(divWorkaround(u2s(m_SP[0]), u2s(m_SP[1]))) : 0;
+#endif
 			--m_SP;
 		}
 		NEXT
@@ -469,7 +512,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) % fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[1] ? modWorkaround(m_SP[0], m_SP[1]) : 0;
+#endif
 		}
 		NEXT
 
@@ -478,7 +525,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], smod(fromBoost(m_SP[0]), fromBoost(m_SP[1])));
+#else
 			m_SPP[0] = m_SP[1] ? s2u(modWorkaround(u2s(m_SP[0]), u2s(m_SP[1]))) : 0;
+#endif
 		}
 		NEXT
 
@@ -487,7 +538,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], ~fromBoost(m_SP[0]));
+#else
 			m_SPP[0] = ~m_SP[0];
+#endif
 		}
 		NEXT
 
@@ -514,7 +569,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], uint256(slt(fromBoost(m_SP[0]), fromBoost(m_SP[1]))));
+#else
 			m_SPP[0] = u2s(m_SP[0]) < u2s(m_SP[1]) ? 1 : 0;
+#endif
 		}
 		NEXT
 
@@ -523,7 +582,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], uint256(sgt(fromBoost(m_SP[0]), fromBoost(m_SP[1]))));
+#else
 			m_SPP[0] = u2s(m_SP[0]) > u2s(m_SP[1]) ? 1 : 0;
+#endif
 		}
 		NEXT
 
@@ -550,7 +613,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) & fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] & m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -559,7 +626,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) | fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] | m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -568,7 +639,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], fromBoost(m_SP[0]) ^ fromBoost(m_SP[1]));
+#else
 			m_SPP[0] = m_SP[0] ^ m_SP[1];
+#endif
 		}
 		NEXT
 
@@ -577,7 +652,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], byteAt(fromBoost(m_SP[0]), fromBoost(m_SP[1])));
+#else
 			m_SPP[0] = m_SP[0] < 32 ? (m_SP[1] >> (unsigned)(8 * (31 - m_SP[0]))) & 0xff : 0;
+#endif
 		}
 		NEXT
 
@@ -586,10 +665,14 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], shl(fromBoost(m_SP[1]), fromBoost(m_SP[0])));
+#else
 			if (m_SP[0] >= 256)
 				m_SPP[0] = 0;
 			else
 				m_SPP[0] = m_SP[1] << unsigned(m_SP[0]);
+#endif
 		}
 		NEXT
 
@@ -600,10 +683,14 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], shr(fromBoost(m_SP[1]), fromBoost(m_SP[0])));
+#else
 			if (m_SP[0] >= 256)
 				m_SPP[0] = 0;
 			else
 				m_SPP[0] = m_SP[1] >> unsigned(m_SP[0]);
+#endif
 		}
 		NEXT
 
@@ -614,6 +701,9 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], sar(fromBoost(m_SP[1]), fromBoost(m_SP[0])));
+#else
 			static u256 const hibit = u256(1) << 255;
 			static u256 const allbits =
 				u256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
@@ -633,6 +723,7 @@ void LegacyVM::interpretCases()
 				if (shiftee & hibit)
 					m_SPP[0] |= allbits << (256 - amount);
 			}
+#endif
 		}
 		NEXT
 
@@ -641,7 +732,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], addmod(fromBoost(m_SP[0]), fromBoost(m_SP[1]), fromBoost(m_SP[2])));
+#else
 			m_SPP[0] = m_SP[2] ? u256((u512(m_SP[0]) + u512(m_SP[1])) % m_SP[2]) : 0;
+#endif
 		}
 		NEXT
 
@@ -650,7 +745,11 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SPP[0], mulmod(fromBoost(m_SP[0]), fromBoost(m_SP[1]), fromBoost(m_SP[2])));
+#else
 			m_SPP[0] = m_SP[2] ? u256((u512(m_SP[0]) * u512(m_SP[1])) % m_SP[2]) : 0;
+#endif
 		}
 		NEXT
 
@@ -659,6 +758,9 @@ void LegacyVM::interpretCases()
 			ON_OP();
 			updateIOGas();
 
+#if EVM_UINT256
+			toBoost(m_SP[1], signextend(fromBoost(m_SP[0]), fromBoost(m_SP[1])));
+#else
 			if (m_SP[0] < 31)
 			{
 				unsigned testBit = static_cast<unsigned>(m_SP[0]) * 8 + 7;
@@ -669,6 +771,7 @@ void LegacyVM::interpretCases()
 				else
 					number &= mask;
 			}
+#endif
 		}
 		NEXT
 
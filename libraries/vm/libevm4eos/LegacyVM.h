@@ -21,6 +21,10 @@
 #include "VMConfig.h"
 #include "VMFace.h"
 
+#if EVM_UINT256
+#include <Uint256.h>
+#endif
+
 namespace dev
 {
 namespace eth
@@ -116,7 +120,7 @@ private:
 	void caseCall();
 
 	void copyDataToMemory(bytesConstRef _data, u256*_sp);
-	uint64_t memNeed(u256 _offset, u256 _size);
+	uint64_t memNeed(u256 const& _offset, u256 const& _size);
 
 	void throwOutOfGas();
 	void throwBadInstruction();
@@ -151,6 +155,16 @@ private:
 		uint64_t w = uint64_t(v);
 		return w;
 	}
+
+#if EVM_UINT256
+	uint64_t toInt63(u256 const& v)
+	{
+		uint256 x = fromBoost(v);
+		if (!x.fits64() || x.w[0] > 0x7FFFFFFFFFFFFFFF)
+			throwOutOfGas();
+		return x.w[0];
+	}
+#endif
 	
 	template<class T> uint64_t toInt15(T v)
 	{
@@ -30,6 +30,8 @@ namespace eth
 //
 // EVM_OPTIMIZE           - all optimizations off when false (TO DO - MAKE DYNAMIC)
 //
+// EVM_UINT256            - arithmetic, memory offsets and gas on the fixed width uint256 (Uint256.h)
+//
 // EVM_SWITCH_DISPATCH    - dispatch via loop and switch
 // EVM_JUMP_DISPATCH      - dispatch via a jump table - available only on GCC
 //
@@ -71,6 +73,10 @@ namespace eth
 #define EVM_DO_FIRST_PASS_OPTIMIZATION (EVM_REPLACE_CONST_JUMP || EVM_USE_CONSTANT_POOL)
 #endif
 
+#ifndef EVM_UINT256
+#define EVM_UINT256 false
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -10,6 +10,7 @@ macro(configure_project)
     # Features:
     option(VMTRACE "Enable VM tracing" OFF)
     option(EVM_OPTIMIZE "Enable VM optimizations (can distort tracing)" ON)
+    option(EVM_UINT256 "Run the interpreter's arithmetic on the fixed width uint256" OFF)
     option(FATDB "Enable fat state database" ON)
     option(PARANOID "Enable additional checks when validating transactions (deprecated)" OFF)
     option(MINIUPNPC "Build with UPnP support" OFF)
@@ -83,6 +84,7 @@ macro(print_config)
     message("--------------------------------------------------------------- features")
     message("-- VMTRACE          VM execution tracing                     ${VMTRACE}")
     message("-- EVM_OPTIMIZE     Enable VM optimizations                  ${EVM_OPTIMIZE}")
+    message("-- EVM_UINT256      Fixed width 256 bit arithmetic           ${EVM_UINT256}")
     message("-- FATDB            Full database exploring                  ${FATDB}")
     message("-- DB               Database implementation                  LEVELDB")
     message("-- PARANOID         -                                        ${PARANOID}")
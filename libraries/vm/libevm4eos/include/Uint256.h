@@ -0,0 +1,534 @@
+/** @file Uint256.h
+ *
+ * Fixed width 256 bit unsigned integer for the interpreter's hot paths.
+ *
+ * u256 is a boost cpp_int: every operation goes through the generic limb loops of the backend
+ * and keeps a variable limb count, and the signed and modular opcodes widen to s512/u512.
+ * uint256 is four 64 bit limbs and nothing else. Its operations have the EVM semantics
+ * (wrap around, division by zero gives zero, two's complement for the signed opcodes) and
+ * are constexpr; operator* and operator+ take the mulx/adcx path when the target has BMI2 and ADX.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__BMI2__) && defined(__ADX__)
+#include <immintrin.h>
+#define EVM_UINT256_ADX 1
+#endif
+
+#ifndef __SIZEOF_INT128__
+#error "uint256 needs unsigned __int128"
+#endif
+
+namespace dev
+{
+
+using uint128 = unsigned __int128;
+
+struct uint256
+{
+	/// Little endian limbs, w[0] is the least significant.
+	uint64_t w[4];
+
+	constexpr uint256(): w{0, 0, 0, 0} {}
+	constexpr uint256(uint64_t _v): w{_v, 0, 0, 0} {}
+	constexpr uint256(uint64_t _w0, uint64_t _w1, uint64_t _w2, uint64_t _w3): w{_w0, _w1, _w2, _w3} {}
+
+	constexpr explicit operator bool() const { return (w[0] | w[1] | w[2] | w[3]) != 0; }
+	constexpr bool fits64() const { return (w[1] | w[2] | w[3]) == 0; }
+	constexpr bool bit(unsigned _i) const { return (w[_i / 64] >> (_i % 64)) & 1; }
+	constexpr bool negative() const { return w[3] >> 63; }
+};
+
+constexpr bool operator==(uint256 const& _a, uint256 const& _b)
+{
+	return ((_a.w[0] ^ _b.w[0]) | (_a.w[1] ^ _b.w[1]) | (_a.w[2] ^ _b.w[2]) | (_a.w[3] ^ _b.w[3])) == 0;
+}
+
+constexpr bool operator!=(uint256 const& _a, uint256 const& _b) { return !(_a == _b); }
+
+constexpr bool operator<(uint256 const& _a, uint256 const& _b)
+{
+	for (int i = 3; i > 0; --i)
+		if (_a.w[i] != _b.w[i])
+			return _a.w[i] < _b.w[i];
+	return _a.w[0] < _b.w[0];
+}
+
+constexpr bool operator>(uint256 const& _a, uint256 const& _b) { return _b < _a; }
+constexpr bool operator<=(uint256 const& _a, uint256 const& _b) { return !(_b < _a); }
+constexpr bool operator>=(uint256 const& _a, uint256 const& _b) { return !(_a < _b); }
+
+constexpr bool slt(uint256 const& _a, uint256 const& _b)
+{
+	return _a.negative() != _b.negative() ? _a.negative() : _a < _b;
+}
+
+constexpr bool sgt(uint256 const& _a, uint256 const& _b) { return slt(_b, _a); }
+
+constexpr uint256 operator&(uint256 const& _a, uint256 const& _b)
+{
+	return {_a.w[0] & _b.w[0], _a.w[1] & _b.w[1], _a.w[2] & _b.w[2], _a.w[3] & _b.w[3]};
+}
+
+constexpr uint256 operator|(uint256 const& _a, uint256 const& _b)
+{
+	return {_a.w[0] | _b.w[0], _a.w[1] | _b.w[1], _a.w[2] | _b.w[2], _a.w[3] | _b.w[3]};
+}
+
+constexpr uint256 operator^(uint256 const& _a, uint256 const& _b)
+{
+	return {_a.w[0] ^ _b.w[0], _a.w[1] ^ _b.w[1], _a.w[2] ^ _b.w[2], _a.w[3] ^ _b.w[3]};
+}
+
+constexpr uint256 operator~(uint256 const& _a)
+{
+	return {~_a.w[0], ~_a.w[1], ~_a.w[2], ~_a.w[3]};
+}
+
+/// Sum mod 2^256, the carry out goes to _carry.
+constexpr uint256 add(uint256 const& _a, uint256 const& _b, bool& _carry)
+{
+	uint128 t = uint128(_a.w[0]) + _b.w[0];
+	uint64_t r0 = uint64_t(t);
+	t = (t >> 64) + _a.w[1] + _b.w[1];
+	uint64_t r1 = uint64_t(t);
+	t = (t >> 64) + _a.w[2] + _b.w[2];
+	uint64_t r2 = uint64_t(t);
+	t = (t >> 64) + _a.w[3] + _b.w[3];
+	_carry = uint64_t(t >> 64);
+	return {r0, r1, r2, uint64_t(t)};
+}
+
+constexpr uint256 add(uint256 const& _a, uint256 const& _b)
+{
+	bool carry = false;
+	return add(_a, _b, carry);
+}
+
+/// Difference mod 2^256, _borrow is set when _b > _a.
+constexpr uint256 sub(uint256 const& _a, uint256 const& _b, bool& _borrow)
+{
+	uint128 t = uint128(_a.w[0]) - _b.w[0];
+	uint64_t r0 = uint64_t(t);
+	t = uint128(_a.w[1]) - _b.w[1] - (uint64_t(t >> 64) & 1);
+	uint64_t r1 = uint64_t(t);
+	t = uint128(_a.w[2]) - _b.w[2] - (uint64_t(t >> 64) & 1);
+	uint64_t r2 = uint64_t(t);
+	t = uint128(_a.w[3]) - _b.w[3] - (uint64_t(t >> 64) & 1);
+	_borrow = uint64_t(t >> 64) & 1;
+	return {r0, r1, r2, uint64_t(t)};
+}
+
+constexpr uint256 sub(uint256 const& _a, uint256 const& _b)
+{
+	bool borrow = false;
+	return sub(_a, _b, borrow);
+}
+
+constexpr uint256 negate(uint256 const& _a) { return sub(uint256(), _a); }
+
+/// Full product of _a and _b as 8 little endian limbs.
+constexpr void mulFull(uint256 const& _a, uint256 const& _b, uint64_t* _r)
+{
+	for (int i = 0; i < 8; ++i)
+		_r[i] = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		uint64_t c = 0;
+		for (int j = 0; j < 4; ++j)
+		{
+			uint128 p = uint128(_a.w[i]) * _b.w[j] + _r[i + j] + c;
+			_r[i + j] = uint64_t(p);
+			c = uint64_t(p >> 64);
+		}
+		_r[i + 4] = c;
+	}
+}
+
+/// Product mod 2^256, the partial products above the fourth limb are skipped.
+constexpr uint256 mul(uint256 const& _a, uint256 const& _b)
+{
+	uint128 t = uint128(_a.w[0]) * _b.w[0];
+	uint64_t r0 = uint64_t(t);
+	t = (t >> 64) + uint128(_a.w[0]) * _b.w[1];
+	uint64_t r1 = uint64_t(t);
+	t = (t >> 64) + uint128(_a.w[0]) * _b.w[2];
+	uint64_t r2 = uint64_t(t);
+	uint64_t r3 = uint64_t(t >> 64) + _a.w[0] * _b.w[3];
+
+	t = uint128(_a.w[1]) * _b.w[0] + r1;
+	r1 = uint64_t(t);
+	t = (t >> 64) + uint128(_a.w[1]) * _b.w[1] + r2;
+	r2 = uint64_t(t);
+	r3 += uint64_t(t >> 64) + _a.w[1] * _b.w[2];
+
+	t = uint128(_a.w[2]) * _b.w[0] + r2;
+	r2 = uint64_t(t);
+	r3 += uint64_t(t >> 64) + _a.w[2] * _b.w[1] + _a.w[3] * _b.w[0];
+	return {r0, r1, r2, r3};
+}
+
+#if EVM_UINT256_ADX
+
+inline uint256 addAdx(uint256 const& _a, uint256 const& _b)
+{
+	uint256 r;
+	unsigned long long w[4];
+	unsigned char c = _addcarryx_u64(0, _a.w[0], _b.w[0], &w[0]);
+	c = _addcarryx_u64(c, _a.w[1], _b.w[1], &w[1]);
+	c = _addcarryx_u64(c, _a.w[2], _b.w[2], &w[2]);
+	_addcarryx_u64(c, _a.w[3], _b.w[3], &w[3]);
+	for (int i = 0; i < 4; ++i)
+		r.w[i] = w[i];
+	return r;
+}
+
+/// mul() with mulx, which leaves the flags alone, and the sums of each row on one adcx carry chain.
+inline uint256 mulAdx(uint256 const& _a, uint256 const& _b)
+{
+	unsigned long long r0, r1, r2, r3, lo, hi;
+	unsigned char c;
+
+	r0 = _mulx_u64(_a.w[0], _b.w[0], &r1);
+	lo = _mulx_u64(_a.w[0], _b.w[1], &r2);
+	c = _addcarryx_u64(0, r1, lo, &r1);
+	lo = _mulx_u64(_a.w[0], _b.w[2], &r3);
+	c = _addcarryx_u64(c, r2, lo, &r2);
+	r3 += _a.w[0] * _b.w[3] + c;
+
+	lo = _mulx_u64(_a.w[1], _b.w[0], &hi);
+	c = _addcarryx_u64(0, r1, lo, &r1);
+	c = _addcarryx_u64(c, r2, hi, &r2);
+	r3 += c;
+	lo = _mulx_u64(_a.w[1], _b.w[1], &hi);
+	c = _addcarryx_u64(0, r2, lo, &r2);
+	r3 += hi + c + _a.w[1] * _b.w[2];
+
+	lo = _mulx_u64(_a.w[2], _b.w[0], &hi);
+	c = _addcarryx_u64(0, r2, lo, &r2);
+	r3 += hi + c + _a.w[2] * _b.w[1] + _a.w[3] * _b.w[0];
+	return {r0, r1, r2, r3};
+}
+
+inline uint256 operator+(uint256 const& _a, uint256 const& _b) { return addAdx(_a, _b); }
+inline uint256 operator*(uint256 const& _a, uint256 const& _b) { return mulAdx(_a, _b); }
+
+#else
+
+constexpr uint256 operator+(uint256 const& _a, uint256 const& _b) { return add(_a, _b); }
+constexpr uint256 operator*(uint256 const& _a, uint256 const& _b) { return mul(_a, _b); }
+
+#endif
+
+constexpr uint256 operator-(uint256 const& _a, uint256 const& _b) { return sub(_a, _b); }
+
+constexpr uint256 shl(uint256 const& _a, unsigned _n)
+{
+	if (_n >= 256)
+		return {};
+	uint256 r;
+	unsigned limbs = _n / 64;
+	unsigned bits = _n % 64;
+	for (int i = 3; i >= int(limbs); --i)
+	{
+		r.w[i] = _a.w[i - limbs] << bits;
+		if (bits && i > int(limbs))
+			r.w[i] |= _a.w[i - limbs - 1] >> (64 - bits);
+	}
+	return r;
+}
+
+constexpr uint256 shr(uint256 const& _a, unsigned _n)
+{
+	if (_n >= 256)
+		return {};
+	uint256 r;
+	unsigned limbs = _n / 64;
+	unsigned bits = _n % 64;
+	for (int i = 0; i + limbs < 4; ++i)
+	{
+		r.w[i] = _a.w[i + limbs] >> bits;
+		if (bits && i + limbs + 1 < 4)
+			r.w[i] |= _a.w[i + limbs + 1] << (64 - bits);
+	}
+	return r;
+}
+
+/// Shift amount of a shift opcode, anything from 256 up shifts everything out.
+constexpr unsigned shiftAmount(uint256 const& _n)
+{
+	return _n.fits64() && _n.w[0] < 256 ? unsigned(_n.w[0]) : 256;
+}
+
+constexpr uint256 shl(uint256 const& _a, uint256 const& _n) { return shl(_a, shiftAmount(_n)); }
+constexpr uint256 shr(uint256 const& _a, uint256 const& _n) { return shr(_a, shiftAmount(_n)); }
+
+constexpr uint256 sar(uint256 const& _a, uint256 const& _n)
+{
+	unsigned n = shiftAmount(_n);
+	if (!_a.negative())
+		return shr(_a, n);
+	if (n >= 256)
+		return ~uint256();
+	return n ? shr(_a, n) | shl(~uint256(), 256 - n) : _a;
+}
+
+constexpr unsigned countLeadingZeros(uint64_t _v)
+{
+	unsigned n = 0;
+	for (uint64_t bit = uint64_t(1) << 63; bit && !(_v & bit); bit >>= 1)
+		++n;
+	return n;
+}
+
+/**
+ * Knuth's algorithm D on 64 bit limbs: _u (_m limbs, at most 8) divided by _v (_n limbs, the top one non zero).
+ * _q gets _m - _n + 1 limbs and _r _n limbs. _m >= _n is assumed.
+ */
+constexpr void divmodLimbs(uint64_t const* _u, int _m, uint64_t const* _v, int _n, uint64_t* _q, uint64_t* _r)
+{
+	if (_n == 1)
+	{
+		uint64_t rem = 0;
+		for (int i = _m - 1; i >= 0; --i)
+		{
+			uint128 num = (uint128(rem) << 64) | _u[i];
+			_q[i] = uint64_t(num / _v[0]);
+			rem = uint64_t(num % _v[0]);
+		}
+		_r[0] = rem;
+		return;
+	}
+
+	// normalize so that the top limb of the divisor has its high bit set
+	unsigned s = countLeadingZeros(_v[_n - 1]);
+	uint64_t vn[8] = {};
+	uint64_t un[9] = {};
+	for (int i = _n - 1; i > 0; --i)
+		vn[i] = (_v[i] << s) | (s ? _v[i - 1] >> (64 - s) : 0);
+	vn[0] = _v[0] << s;
+	un[_m] = s ? _u[_m - 1] >> (64 - s) : 0;
+	for (int i = _m - 1; i > 0; --i)
+		un[i] = (_u[i] << s) | (s ? _u[i - 1] >> (64 - s) : 0);
+	un[0] = _u[0] << s;
+
+	for (int j = _m - _n; j >= 0; --j)
+	{
+		uint128 num = (uint128(un[j + _n]) << 64) | un[j + _n - 1];
+		uint128 qhat = num / vn[_n - 1];
+		uint128 rhat = num % vn[_n - 1];
+		while ((qhat >> 64) || qhat * vn[_n - 2] > ((rhat << 64) | un[j + _n - 2]))
+		{
+			--qhat;
+			rhat += vn[_n - 1];
+			if (rhat >> 64)
+				break;
+		}
+
+		// multiply and subtract
+		uint64_t borrow = 0;
+		uint64_t carry = 0;
+		for (int i = 0; i < _n; ++i)
+		{
+			uint128 p = qhat * vn[i] + carry;
+			carry = uint64_t(p >> 64);
+			uint64_t lo = uint64_t(p);
+			uint64_t t = un[i + j] - lo;
+			uint64_t b = un[i + j] < lo;
+			un[i + j] = t - borrow;
+			borrow = b + (t < borrow);
+		}
+		uint64_t top = un[j + _n];
+		un[j + _n] = top - carry - borrow;
+
+		if (top < uint128(carry) + borrow)
+		{
+			// qhat was one too large, add the divisor back
+			--qhat;
+			uint64_t c = 0;
+			for (int i = 0; i < _n; ++i)
+			{
+				uint128 t = uint128(un[i + j]) + vn[i] + c;
+				un[i + j] = uint64_t(t);
+				c = uint64_t(t >> 64);
+			}
+			un[j + _n] += c;
+		}
+		_q[j] = uint64_t(qhat);
+	}
+
+	for (int i = 0; i < _n; ++i)
+		_r[i] = (un[i] >> s) | (s ? un[i + 1] << (64 - s) : 0);
+}
+
+constexpr int significantLimbs(uint64_t const* _v, int _n)
+{
+	while (_n > 0 && !_v[_n - 1])
+		--_n;
+	return _n;
+}
+
+struct uint256DivMod
+{
+	uint256 quot;
+	uint256 rem;
+};
+
+/// Quotient and remainder, both zero when _b is zero as DIV and MOD want it.
+constexpr uint256DivMod divmod(uint256 const& _a, uint256 const& _b)
+{
+	int n = significantLimbs(_b.w, 4);
+	if (!n)
+		return {};
+	if (_a < _b)
+		return {uint256(), _a};
+	int m = significantLimbs(_a.w, 4);
+	uint256DivMod r;
+	divmodLimbs(_a.w, m, _b.w, n, r.quot.w, r.rem.w);
+	return r;
+}
+
+constexpr uint256 operator/(uint256 const& _a, uint256 const& _b) { return divmod(_a, _b).quot; }
+constexpr uint256 operator%(uint256 const& _a, uint256 const& _b) { return divmod(_a, _b).rem; }
+
+/// 512 bit value _u (8 limbs) mod _m, zero when _m is zero.
+constexpr uint256 mod512(uint64_t const* _u, uint256 const& _m)
+{
+	int n = significantLimbs(_m.w, 4);
+	if (!n)
+		return {};
+	int m = significantLimbs(_u, 8);
+	if (m < n)
+		return {_u[0], _u[1], _u[2], _u[3]};
+	uint64_t q[8] = {};
+	uint256 r;
+	divmodLimbs(_u, m, _m.w, n, q, r.w);
+	return r;
+}
+
+constexpr uint256 magnitude(uint256 const& _a) { return _a.negative() ? negate(_a) : _a; }
+
+/// Signed division truncating toward zero, -2^255 / -1 wraps to -2^255.
+constexpr uint256 sdiv(uint256 const& _a, uint256 const& _b)
+{
+	uint256 q = divmod(magnitude(_a), magnitude(_b)).quot;
+	return _a.negative() != _b.negative() ? negate(q) : q;
+}
+
+/// Signed remainder, it takes the sign of the dividend.
+constexpr uint256 smod(uint256 const& _a, uint256 const& _b)
+{
+	uint256 r = divmod(magnitude(_a), magnitude(_b)).rem;
+	return _a.negative() ? negate(r) : r;
+}
+
+constexpr uint256 addmod(uint256 const& _a, uint256 const& _b, uint256 const& _m)
+{
+	bool carry = false;
+	uint256 s = add(_a, _b, carry);
+	uint64_t u[8] = {s.w[0], s.w[1], s.w[2], s.w[3], carry, 0, 0, 0};
+	return mod512(u, _m);
+}
+
+constexpr uint256 mulmod(uint256 const& _a, uint256 const& _b, uint256 const& _m)
+{
+	uint64_t u[8] = {};
+	mulFull(_a, _b, u);
+	return mod512(u, _m);
+}
+
+constexpr uint256 power(uint256 _base, uint256 const& _exponent)
+{
+	uint256 r = 1;
+	int top = significantLimbs(_exponent.w, 4);
+	for (int i = 0; i < top; ++i)
+	{
+		uint64_t e = _exponent.w[i];
+		// no squarings above the top set bit
+		int bits = i + 1 == top ? 64 - int(countLeadingZeros(e)) : 64;
+		for (int b = 0; b < bits; ++b)
+		{
+			if (e & 1)
+				r = mul(r, _base);
+			_base = mul(_base, _base);
+			e >>= 1;
+		}
+	}
+	return r;
+}
+
+/// BYTE: byte _i of _x counted from the most significant one, zero from 32 up.
+constexpr uint256 byteAt(uint256 const& _i, uint256 const& _x)
+{
+	if (!_i.fits64() || _i.w[0] >= 32)
+		return {};
+	unsigned n = 31 - unsigned(_i.w[0]);
+	return (_x.w[n / 8] >> (n % 8 * 8)) & 0xff;
+}
+
+/// SIGNEXTEND: extends the sign bit of byte _k (counted from the least significant one), _x is kept from 31 up.
+constexpr uint256 signextend(uint256 const& _k, uint256 const& _x)
+{
+	if (!_k.fits64() || _k.w[0] >= 31)
+		return _x;
+	unsigned testBit = unsigned(_k.w[0]) * 8 + 7;
+	uint256 mask = sub(shl(uint256(1), testBit), uint256(1));
+	return _x.bit(testBit) ? _x | ~mask : _x & mask;
+}
+
+/// Bounds check of memory offsets: _offset + _size, or zero when _size is zero, saturated past 2^63 - 1.
+constexpr uint64_t memEnd(uint256 const& _offset, uint256 const& _size)
+{
+	if (!_size)
+		return 0;
+	if (!_offset.fits64() || !_size.fits64())
+		return UINT64_MAX;
+	uint128 end = uint128(_offset.w[0]) + _size.w[0];
+	return end > 0x7FFFFFFFFFFFFFFF ? UINT64_MAX : uint64_t(end);
+}
+
+/// 32 big endian bytes, the layout of EVM memory words.
+constexpr uint256 fromBigEndian(uint8_t const* _in)
+{
+	uint256 r;
+	for (int i = 0; i < 32; ++i)
+		r.w[3 - i / 8] = (r.w[3 - i / 8] << 8) | _in[i];
+	return r;
+}
+
+inline void toBigEndian(uint256 const& _v, uint8_t* _out)
+{
+	for (int i = 0; i < 32; ++i)
+		_out[i] = uint8_t(_v.w[3 - i / 8] >> (56 - i % 8 * 8));
+}
+
+/// Reads a boost fixed width 256 bit number (u256) without going through its operators.
+template <class Number>
+uint256 fromBoost(Number const& _v)
+{
+	auto const& b = _v.backend();
+	static_assert(sizeof(*b.limbs()) == sizeof(uint64_t), "64 bit limbs expected");
+	// the limbs above size() are not kept zero by the backend
+	unsigned n = b.size();
+	auto const* l = b.limbs();
+	return {l[0], n > 1 ? l[1] : 0, n > 2 ? l[2] : 0, n > 3 ? l[3] : 0};
+}
+
+template <class Number>
+void toBoost(Number& _out, uint256 const& _v)
+{
+	auto& b = _out.backend();
+	static_assert(sizeof(*b.limbs()) == sizeof(uint64_t), "64 bit limbs expected");
+	auto* l = b.limbs();
+	l[0] = _v.w[0];
+	l[1] = _v.w[1];
+	l[2] = _v.w[2];
+	l[3] = _v.w[3];
+	// the normalized limb count, what normalize() would leave
+	b.resize(_v.w[3] ? 4 : _v.w[2] ? 3 : _v.w[1] ? 2 : 1, 1);
+}
+
+}
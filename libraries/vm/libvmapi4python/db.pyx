@@ -1,5 +1,9 @@
 from libcpp.string cimport string
 from libcpp.vector cimport vector
+from libc.string cimport memcpy
+from cpython.buffer cimport PyBuffer_FillInfo
+
+import struct
 
 cdef extern from "exception_converter.hpp":
     pass
@@ -32,6 +36,7 @@ cdef extern from "<eosiolib_native/vm_api.h>": # namespace "eosio::chain":
         int32_t (*db_lowerbound_i64)(uint64_t code, uint64_t scope, uint64_t table, uint64_t id)  except +
         int32_t (*db_upperbound_i64)(uint64_t code, uint64_t scope, uint64_t table, uint64_t id)  except +
         int32_t (*db_end_i64)(uint64_t code, uint64_t scope, uint64_t table)  except +
+        int32_t (*db_scan_i64)(uint64_t code, uint64_t scope, uint64_t table, uint64_t* lower, uint64_t upper, uint32_t limit, char* data, uint32_t len)  except +
         
         int32_t (*db_idx64_store)(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary)  except +
         void (*db_idx64_update)(int32_t iterator, uint64_t payer, const uint64_t* secondary)  except +
@@ -44,6 +49,7 @@ cdef extern from "<eosiolib_native/vm_api.h>": # namespace "eosio::chain":
         int32_t (*db_idx64_lowerbound)(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary)  except +
         int32_t (*db_idx64_upperbound)(uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary)  except +
         int32_t (*db_idx64_end)(uint64_t code, uint64_t scope, uint64_t table)  except +
+        int32_t (*db_idx64_scan)(uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t* secondary, uint64_t* primary, uint64_t upper, uint32_t limit, char* data, uint32_t len)  except +
 '''
 int32_t (*db_idx_double_store)(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const float64_t* secondary);
 void (*db_idx_double_update)(int32_t iterator, uint64_t payer, const float64_t* secondary);
@@ -59,13 +65,85 @@ int32_t (*db_idx_double_end)(uint64_t code, uint64_t scope, uint64_t table);
 cdef extern from "eoslib_.hpp":
     vm_api& api()
 
+cdef class RowView:
+    '''
+    Read-only view of the value of a table row. unpack() and tobytes() read straight from the chain state
+    until the row is updated or removed, or the action ends.
+    memoryview() and other buffer exports are served from a copy owned by the view, they may outlive the row.
+    '''
+    cdef const char* data
+    cdef Py_ssize_t size
+    cdef int itr
+    cdef bint valid
+    cdef bint borrowed
+    cdef bytes copy
+
+    def __getbuffer__(self, Py_buffer* buffer, int flags):
+        if self.borrowed:
+            #only while unpack() runs struct, which releases the buffer before returning
+            PyBuffer_FillInfo(buffer, self, <void*>self.data, self.size, 1, flags)
+            return
+        if self.copy is None:
+            if not self.valid:
+                raise BufferError('row view is no longer valid')
+            self.copy = self.data[:self.size]
+        PyBuffer_FillInfo(buffer, self, <void*><const char*>self.copy, self.size, 1, flags)
+
+    def __len__(self):
+        return self.size
+
+    def tobytes(self):
+        if not self.valid:
+            raise BufferError('row view is no longer valid')
+        return self.data[:self.size]
+
+    def unpack(self, fmt, int offset = 0):
+        if not self.valid:
+            raise BufferError('row view is no longer valid')
+        s = struct.Struct(fmt)
+        self.borrowed = True
+        try:
+            return s.unpack_from(self, offset)
+        finally:
+            self.borrowed = False
+
+#views handed out during the current action
+cdef list row_views = []
+
+cdef RowView new_row_view(int iterator):
+    cdef size_t size = 0
+    cdef RowView view = RowView.__new__(RowView)
+    view.data = api().db_get_i64_exex( iterator, &size )
+    view.size = size
+    view.itr = iterator
+    view.valid = True
+    view.borrowed = False
+    view.copy = None
+    return view
+
+cdef invalidate_row_views(int iterator):
+    cdef RowView view
+    for view in row_views:
+        if view.itr == iterator:
+            view.valid = False
+
+#called by the vm on every exit of an action, the rows may change or go away once the action is done
+cdef extern int release_row_views():
+    cdef RowView view
+    for view in row_views:
+        view.valid = False
+    del row_views[:]
+    return 1
+
 def store_i64(scope, table, payer, id, buffer):
     api().db_store_i64(scope, table, payer, id, buffer, len(buffer))
 
 def update_i64(int itr, uint64_t payer, buffer):
+    invalidate_row_views(itr)
     api().db_update_i64(itr, payer, buffer, len(buffer))
 
 def remove_i64(int itr):
+    invalidate_row_views(itr)
     api().db_remove_i64(itr)
 
 def get_i64( int iterator ):
@@ -79,6 +157,24 @@ def get_i64( int iterator ):
     size = api().db_get_i64( iterator, buffer, size )
     return buffer
 
+def get_i64_view( int iterator ):
+    '''
+    Same as get_i64 without the copies: returns a read-only RowView over the row, see RowView for how long it stays valid
+    '''
+    view = new_row_view(iterator)
+    row_views.append(view)
+    return view
+
+def unpack_i64( int iterator, fmt, int offset = 0 ):
+    '''
+    struct.unpack_from(fmt, row, offset) straight from the row data
+    '''
+    cdef RowView view = new_row_view(iterator)
+    try:
+        return view.unpack(fmt, offset)
+    finally:
+        view.valid = False
+
 def next_i64( int iterator):
     cdef uint64_t primary = 0
     itr = api().db_next_i64( iterator, &primary )
@@ -101,6 +197,30 @@ def upperbound_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t id )
 def end_i64( uint64_t code, uint64_t scope, uint64_t table ):
     return api().db_end_i64( code, scope, table )
 
+def scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t lower, uint64_t upper, uint32_t limit = 0 ):
+    '''
+    Returns ([(primary, value), ...], next), next being the primary key to continue from, upper once the range is done
+    '''
+    cdef vector[char] buffer
+    cdef uint64_t primary
+    cdef uint32_t size
+    cdef char* pos
+
+    buffer.resize(4096)
+    count = api().db_scan_i64( code, scope, table, &lower, upper, limit, buffer.data(), buffer.size() )
+    if count < 0:
+        buffer.resize(-count)
+        count = api().db_scan_i64( code, scope, table, &lower, upper, limit, buffer.data(), buffer.size() )
+
+    rows = []
+    pos = buffer.data()
+    for i in range(count):
+        memcpy(&primary, pos, 8)
+        memcpy(&size, pos + 8, 4)
+        rows.append((primary, pos[12:12 + size]))
+        pos += 12 + size
+    return (rows, lower)
+
 
 def db_idx64_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t primary, uint64_t secondary):
     return api().db_idx64_store(scope, table, payer, primary, &secondary)
@@ -146,6 +266,32 @@ def db_idx64_upperbound(uint64_t code, uint64_t scope, uint64_t table):
 def db_idx64_end(uint64_t code, uint64_t scope, uint64_t table):
     return api().db_idx64_end(code, scope, table)
 
+def db_idx64_scan(uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t secondary, uint64_t primary, uint64_t upper, uint32_t limit = 0):
+    '''
+    Returns ([(secondary, primary, value), ...], next_secondary, next_primary), value being the row of row_table
+    '''
+    cdef vector[char] buffer
+    cdef uint64_t _secondary
+    cdef uint64_t _primary
+    cdef uint32_t size
+    cdef char* pos
+
+    buffer.resize(4096)
+    count = api().db_idx64_scan(code, scope, table, row_table, &secondary, &primary, upper, limit, buffer.data(), buffer.size())
+    if count < 0:
+        buffer.resize(-count)
+        count = api().db_idx64_scan(code, scope, table, row_table, &secondary, &primary, upper, limit, buffer.data(), buffer.size())
+
+    entries = []
+    pos = buffer.data()
+    for i in range(count):
+        memcpy(&_secondary, pos, 8)
+        memcpy(&_primary, pos + 8, 8)
+        memcpy(&size, pos + 16, 4)
+        entries.append((_secondary, _primary, pos[20:20 + size]))
+        pos += 20 + size
+    return (entries, secondary, primary)
+
 def get_table_item_count(uint64_t code, uint64_t scope, uint64_t table):
     return api().get_table_item_count(code, scope, table)
 
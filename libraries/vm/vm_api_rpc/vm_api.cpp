@@ -31,6 +31,8 @@ typedef struct { uint64_t v; } float64_t;
 typedef struct { uint64_t v[2]; } float128_t;
 
 
+#include <eosio/chain/db_api.h>
+
 using namespace fc;
 
 namespace eosio {
@@ -159,6 +161,10 @@ struct vm_api* get_vm_api() {
    _vm_api.db_upperbound_i64 = db_upperbound_i64,
    _vm_api.db_end_i64 = db_end_i64,
 
+   //range scans only read, they are served from the mapped state
+   _vm_api.db_scan_i64 = db_api_scan_i64,
+   _vm_api.db_idx64_scan = db_api_idx64_scan,
+
 #if 0
    _vm_api.db_idx64_store = db_idx64_store,
    _vm_api.db_idx64_update = db_idx64_update,
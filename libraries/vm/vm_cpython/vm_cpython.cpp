@@ -14,6 +14,7 @@ extern "C" {
 int cpython_setcode(uint64_t account, string& code);
 int cpython_apply(uint64_t receiver, uint64_t account, uint64_t action);
 int cpython_call(uint64_t account, uint64_t func);
+int release_row_views();
 void cpython_compile(string& name, string& code, string& result);
 
 const char *vm_cpython_compile(const char *name, const char *code, int size, int *result_size) {
@@ -80,11 +81,14 @@ int vm_apply(uint64_t receiver, uint64_t account, uint64_t act) {
    try {
       ret = cpython_apply(receiver, account, act);
    } catch (...) {
+      release_row_views();
       #ifdef WITH_THREAD
       PyGILState_Release(save);
       #endif
       throw;
    }
+   //row views handed out by the db module must not outlive the action
+   release_row_views();
    #ifdef WITH_THREAD
    PyGILState_Release(save);
    #endif
@@ -30,6 +30,7 @@ int cpython_setcode(uint64_t account, string& code);
 int cpython_clearcode(uint64_t account);
 
 int cpython_apply(unsigned long long receiver, unsigned long long account, unsigned long long action);
+int release_row_views();
 int init_function_whitelist();
 int error_handler(string& error);
 
@@ -355,7 +356,20 @@ int vm_apply_no_throw(uint64_t receiver, uint64_t account, uint64_t act) {
 
    prepare_env(receiver);
    uint64_t start = get_microseconds();
-   return cpython_apply(receiver, account, act);
+   int ret;
+   try {
+      ret = cpython_apply(receiver, account, act);
+   } catch (...) {
+      release_row_views();
+      throw;
+   }
+
+   //keep the error of a failed action for error_handler
+   PyObject *type, *value, *traceback;
+   PyErr_Fetch(&type, &value, &traceback);
+   release_row_views();
+   PyErr_Restore(type, value, traceback);
+   return ret;
 }
 
 int vm_apply(uint64_t receiver, uint64_t account, uint64_t act) {
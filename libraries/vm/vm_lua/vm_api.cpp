@@ -167,6 +167,43 @@ static int db_end_i64_(lua_State *L) {
    return 1;
 }
 
+//returns an array of {primary, value} rows and the primary key to continue the scan from
+static int db_scan_i64_(lua_State *L) {
+   uint64_t code = luaL_checknumber(L, 1);
+   uint64_t scope = luaL_checknumber(L, 2);
+   uint64_t table = luaL_checknumber(L, 3);
+   uint64_t lower = luaL_checknumber(L, 4);
+   uint64_t upper = luaL_checknumber(L, 5);
+   uint32_t limit = luaL_optinteger(L, 6, 0);
+
+   vector<char> buffer(4096);
+   int count = db_scan_i64(code, scope, table, &lower, upper, limit, buffer.data(), buffer.size());
+   if (count < 0) {
+      buffer.resize(-count);
+      count = db_scan_i64(code, scope, table, &lower, upper, limit, buffer.data(), buffer.size());
+   }
+
+   lua_createtable(L, count, 0);
+   const char* pos = buffer.data();
+   for (int i = 1; i <= count; i++) {
+      uint64_t primary;
+      uint32_t size;
+      memcpy(&primary, pos, sizeof(primary));
+      memcpy(&size, pos + sizeof(primary), sizeof(size));
+      pos += sizeof(primary) + sizeof(size);
+
+      lua_createtable(L, 2, 0);
+      lua_pushnumber(L, primary);
+      lua_rawseti(L, -2, 1);
+      lua_pushlstring(L, pos, size);
+      lua_rawseti(L, -2, 2);
+      lua_rawseti(L, -2, i);
+      pos += size;
+   }
+   lua_pushnumber(L, lower);
+   return 2;
+}
+
 static int rshift_(lua_State *L) {
    uint64_t n = luaL_checknumber(L, 1);
    uint64_t by = luaL_checknumber(L, 2);
@@ -199,6 +236,7 @@ void lsb_register_vm_api(lsb_lua_sandbox *lsb) {
    lsb_add_function(lsb, db_lowerbound_i64_,          "db_lowerbound_i64");
    lsb_add_function(lsb, db_upperbound_i64_,          "db_upperbound_i64");
    lsb_add_function(lsb, db_end_i64_,                 "db_end_i64");
+   lsb_add_function(lsb, db_scan_i64_,                "db_scan_i64");
    lsb_add_function(lsb, s2n_,                        "s2n");
    lsb_add_function(lsb, s2n_,                        "N");
    lsb_add_function(lsb, n2s_,                        "n2s");
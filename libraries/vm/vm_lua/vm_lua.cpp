@@ -34,7 +34,19 @@ int check_time() {
    return 1;
 }
 
-static std::map<uint64_t, lsb_lua_sandbox *> account_map;
+struct lua_contract {
+   lsb_lua_sandbox *lsb;
+   uint64_t last_used;
+   bool dirty;
+};
+
+//sandboxes are cached per account, at most max_sandboxes of them are kept alive,
+//the least recently used one is destroyed to make room for a new contract
+static const size_t max_sandboxes = 16;
+static std::map<uint64_t, lua_contract> account_map;
+static uint64_t use_counter = 0;
+
+static const char *snapshot_key = "eosio.snapshot";
 
 static char print_out[2048] = { 0 };
 
@@ -113,6 +125,144 @@ static const char *cfg =
 "disable_modules = {io = 1, os=1}\n";
 
 
+static void push_globals(lua_State *L) {
+#ifdef LUA_GLOBALSINDEX
+   lua_pushvalue(L, LUA_GLOBALSINDEX);
+#else
+   lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+#endif
+}
+
+static bool is_library_table(lua_State *L, int idx, int libs) {
+   lua_pushvalue(L, idx);
+   lua_rawget(L, libs);
+   bool ret = !lua_isnil(L, -1);
+   lua_pop(L, 1);
+   return ret;
+}
+
+//record snapshot[table] = shallow copy of table, then descend into table values not seen yet.
+//library tables in package.loaded are shared by every contract and are not copied
+static void snapshot_table(lua_State *L, int snapshot, int libs, int idx) {
+   eosio_assert(lua_checkstack(L, 6), "lua state too deep to snapshot");
+
+   lua_pushvalue(L, idx);
+   lua_rawget(L, snapshot);
+   bool seen = !lua_isnil(L, -1);
+   lua_pop(L, 1);
+   if (seen) {
+      return;
+   }
+
+   lua_newtable(L);
+   int copy = lua_gettop(L);
+   lua_pushvalue(L, idx);
+   lua_pushvalue(L, copy);
+   lua_rawset(L, snapshot);
+
+   lua_pushnil(L);
+   while (lua_next(L, idx)) {
+      lua_pushvalue(L, -2);
+      lua_pushvalue(L, -2);
+      lua_rawset(L, copy);
+      if (lua_type(L, -1) == LUA_TTABLE && !is_library_table(L, -1, libs)) {
+         snapshot_table(L, snapshot, libs, lua_gettop(L));
+      }
+      lua_pop(L, 1);
+   }
+   lua_pop(L, 1);
+}
+
+//capture the globals table after the contract chunk has run,
+//restore_state puts every table reachable from it back to this content.
+//metatables and upvalues of closures are not part of the snapshot
+static void snapshot_state(lua_State *L) {
+   int top = lua_gettop(L);
+
+   lua_newtable(L);
+   int snapshot = lua_gettop(L);
+
+   lua_newtable(L);
+   int libs = lua_gettop(L);
+   lua_getfield(L, LUA_REGISTRYINDEX, "_LOADED");
+   if (lua_istable(L, -1)) {
+      lua_pushnil(L);
+      while (lua_next(L, -2)) {
+         if (lua_istable(L, -1)) {
+            lua_pushboolean(L, 1);
+            lua_rawset(L, libs);
+         } else {
+            lua_pop(L, 1);
+         }
+      }
+   }
+   lua_pop(L, 1);
+
+   push_globals(L);
+   snapshot_table(L, snapshot, libs, lua_gettop(L));
+
+   lua_pushvalue(L, snapshot);
+   lua_setfield(L, LUA_REGISTRYINDEX, snapshot_key);
+   lua_settop(L, top);
+}
+
+static void restore_state(lua_State *L) {
+   int top = lua_gettop(L);
+   lua_getfield(L, LUA_REGISTRYINDEX, snapshot_key);
+   if (!lua_istable(L, -1)) {
+      lua_settop(L, top);
+      return;
+   }
+   int snapshot = lua_gettop(L);
+
+   lua_pushnil(L);
+   while (lua_next(L, snapshot)) {
+      int copy = lua_gettop(L);
+      int original = copy - 1;
+
+      //drop keys added since the snapshot, assigning nil to an existing field is allowed during lua_next
+      lua_pushnil(L);
+      while (lua_next(L, original)) {
+         lua_pop(L, 1);
+         lua_pushvalue(L, -1);
+         lua_rawget(L, copy);
+         if (lua_isnil(L, -1)) {
+            lua_pushvalue(L, -2);
+            lua_pushnil(L);
+            lua_rawset(L, original);
+         }
+         lua_pop(L, 1);
+      }
+
+      lua_pushnil(L);
+      while (lua_next(L, copy)) {
+         lua_pushvalue(L, -2);
+         lua_insert(L, -2);
+         lua_rawset(L, original);
+      }
+      lua_pop(L, 1);
+   }
+   lua_settop(L, top);
+}
+
+static void destroy_sandbox(lsb_lua_sandbox *lsb) {
+   lsb_terminate(lsb, NULL);
+   lsb_destroy(lsb);
+}
+
+static void evict_sandbox() {
+   auto lru = account_map.begin();
+   for (auto itr = account_map.begin(); itr != account_map.end(); itr++) {
+      if (itr->second.last_used < lru->second.last_used) {
+         lru = itr;
+      }
+   }
+   if (lru != account_map.end()) {
+      destroy_sandbox(lru->second.lsb);
+      account_map.erase(lru);
+   }
+}
+
 lsb_lua_sandbox *load_account(uint64_t account) {
    size_t size = 0;
    const char* str_code = get_code(account, &size);
@@ -160,7 +310,12 @@ lsb_lua_sandbox *load_account(uint64_t account) {
       return NULL;
    }
 
-   account_map[account] = lsb;
+   snapshot_state(lua);
+
+   if (account_map.size() >= max_sandboxes) {
+      evict_sandbox();
+   }
+   account_map[account] = lua_contract{lsb, ++use_counter, false};
    return lsb;
 }
 
@@ -247,16 +402,22 @@ int vm_setcode(uint64_t account) {
 int vm_apply(uint64_t receiver, uint64_t account, uint64_t act) {
 //   printf("+++++vm_lua: apply\n");
    auto itr = account_map.find(receiver);
-   lsb_lua_sandbox *lsb;
    if (itr == account_map.end()) {
-      lsb = load_account(receiver);
-   } else {
-      lsb = itr->second;
+      if (!load_account(receiver)) {
+         return 0;
+      }
+      itr = account_map.find(receiver);
    }
 
-   if (!lsb) {
-      return 0;
+   lua_contract& contract = itr->second;
+   lsb_lua_sandbox *lsb = contract.lsb;
+   contract.last_used = ++use_counter;
+
+   //globals mutated by the previous action must not leak into this one
+   if (contract.dirty) {
+      restore_state(lsb_get_lua(lsb));
    }
+   contract.dirty = true;
 
    int ret = _apply(lsb, receiver, account, act);
    if (ret == 0) {
@@ -278,9 +439,8 @@ int vm_call(uint64_t account, uint64_t func) {
 int vm_unload(uint64_t account) {
    auto itr = account_map.find(account);
    if (itr != account_map.end()) {
-      lsb_lua_sandbox *lsb = itr->second;
-      lsb_terminate(lsb, NULL);
-      lsb_destroy(lsb);
+      destroy_sandbox(itr->second.lsb);
+      account_map.erase(itr);
    }
    return 1;
 }
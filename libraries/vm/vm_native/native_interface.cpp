@@ -3,6 +3,8 @@
 
 #include <fc/ext_string.h>
 #include <dlfcn.h>
+#include <sys/stat.h>
+#include <fstream>
 
 #include "native_interface.hpp"
 
@@ -27,18 +29,26 @@ namespace eosio { namespace chain {
    void native_interface::init_native_contract() {
 //      uint64_t native_account[] = {N(eosio.bios), N(eosio.msig), N(eosio.token), N(eosio)/*eosio.system*/, N(exchange)};
       uint64_t native_account[] = {N(eosio.token)};
-      fn_apply* native_applies[] = {&_bios_apply, &_msig_apply, &_token_apply, &_eosio_apply, &_exchange_apply};
       for (int i=0; i<sizeof(native_account)/sizeof(native_account[0]); i++) {
          if (!load_native_contract(native_account[i])) {
-            *native_applies[i] = load_native_contract_default(native_account[i]);
+            load_native_contract_default(native_account[i]);
          }
       }
    }
 
+   native_code_cache* native_interface::cache_entry(uint64_t account, uint32_t version, void* handle) {
+      auto& _cache = native_cache[account];
+      if (!_cache) {
+         _cache = std::make_unique<native_code_cache>();
+         _cache->code_id = {};
+      }
+      _cache->version = version;
+      _cache->handle = handle;
+      _cache->apply = handle ? (fn_apply)dlsym(handle, "apply") : nullptr;
+      return _cache.get();
+   }
+
    fn_apply native_interface::load_native_contract_default(uint64_t _account) {
-      string contract_path;
-      uint32_t version = 0;
-      uint64_t native = N(native);
       void *handle = nullptr;
 
       if (get_vm_api()->is_debug_mode()) {
@@ -61,25 +71,15 @@ namespace eosio { namespace chain {
          }
       }
 
-      fn_apply _apply = (fn_apply)dlsym(handle, "apply");
-
-      std::unique_ptr<native_code_cache> _cache = std::make_unique<native_code_cache>();
-      _cache->version = version;
-      _cache->handle = handle;
-      _cache->apply = _apply;
-//      native_cache.emplace(_account, std::move(_cache));
-      native_cache[_account] =  std::move(_cache);
-      return _apply;
+      return cache_entry(_account, 0, handle)->apply;
    }
 
    fn_apply native_interface::load_native_contract(uint64_t _account) {
       if (!db_api::get().is_account(_account)) {
          return nullptr;
       }
-      string contract_path;
       uint32_t version = 0;
       uint64_t native = N(native);
-      void *handle = nullptr;
       char _name[64];
       snprintf(_name, sizeof(_name), "%s.%d", name(_account).to_string().c_str(), NATIVE_PLATFORM);
       uint64_t __account = NN(_name);
@@ -99,58 +99,91 @@ namespace eosio { namespace chain {
       version = *(uint32_t*)code;
 
       auto _itr = native_cache.find(_account);
-      if (_itr != native_cache.end()) {
+      if (_itr != native_cache.end() && _itr->second->apply) {
          if (version <= _itr->second->version) {
             return _itr->second->apply;
          }
       }
 
-      char native_path[64];
-      sprintf(native_path, "%s.%d",name(__account).to_string().c_str(), version);
+      //every version gets its own file, so a library that is already loaded is never overwritten
+      char native_dir[128];
+      snprintf(native_dir, sizeof(native_dir), "native_contracts/%s", name(__account).to_string().c_str());
+      mkdir("native_contracts", 0755);
+      mkdir(native_dir, 0755);
+
+      char native_path[160];
+      snprintf(native_path, sizeof(native_path), "%s/%d%s", native_dir, version, DYLIB_SUFFIX);
 
       wlog("loading native contract:\t ${n}", ("n", native_path));
 
       struct stat _s;
-      if (stat(native_path, &_s) == 0) {
-         //
-      } else {
-         std::ofstream out(native_path, std::ios::binary | std::ios::out);
+      if (stat(native_path, &_s) != 0) {
+         string tmp_path = string(native_path) + ".tmp";
+         std::ofstream out(tmp_path, std::ios::binary | std::ios::out);
          out.write(&code[4], native_size - 4);
          out.close();
+         if (!out || rename(tmp_path.c_str(), native_path) != 0) {
+            return nullptr;
+         }
       }
-      contract_path = native_path;
 
-      handle = dlopen(contract_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+      void *handle = dlopen(native_path, RTLD_LAZY | RTLD_LOCAL);
       if (!handle) {
          return nullptr;
       }
 
-      fn_apply _apply = (fn_apply)dlsym(handle, "apply");
+      return cache_entry(_account, version, handle)->apply;
+   }
 
-      std::unique_ptr<native_code_cache> _cache = std::make_unique<native_code_cache>();
-      _cache->version = version;
-      _cache->handle = handle;
-      _cache->apply = _apply;
-//      native_cache.emplace(_account, std::move(_cache));
-      native_cache[_account] =  std::move(_cache);
-      return _apply;
+   native_code_cache* native_interface::resolve(uint64_t account, const std::array<char, 32>& code_id) {
+      auto itr = native_cache.find(account);
+      if (itr != native_cache.end() && itr->second->code_id == code_id) {
+         return itr->second.get();
+      }
+
+      if (!load_native_contract(account)) {
+         load_native_contract_default(account);
+      }
+
+      //accounts without a native implementation are remembered too, so their libraries are probed once per code version
+      auto& _cache = native_cache[account];
+      if (!_cache) {
+         _cache = std::make_unique<native_code_cache>();
+         _cache->version = 0;
+         _cache->handle = nullptr;
+         _cache->apply = nullptr;
+      }
+      _cache->code_id = code_id;
+      return _cache.get();
+   }
+
+   void native_interface::unload(uint64_t account) {
+      //handles stay open, the next apply only has to check the native table again
+      if (account == N(native)) {
+         for (auto& entry : native_cache) {
+            entry.second->code_id = {};
+         }
+         return;
+      }
+      auto itr = native_cache.find(account);
+      if (itr != native_cache.end()) {
+         itr->second->code_id = {};
+      }
    }
 
    int native_interface::apply(uint64_t receiver, uint64_t account, uint64_t act) {
-      size_t size = 0;
-      const char* code = get_vm_api()->get_code(receiver, &size);
-      if (code == nullptr || size <= 0) {
+      std::array<char, 32> code_id;
+      if (!get_vm_api()->get_code_id(receiver, code_id.data(), code_id.size())) {
          return 0;
       }
-      auto it = native_cache.find(receiver);
-      if (it == native_cache.end()) {
-         load_native_contract_default(receiver);
-         it = native_cache.find(receiver);
-         if (it == native_cache.end()) {
-            return 0;
-         }
+      if (code_id == std::array<char, 32>{}) { //no code
+         return 0;
+      }
+      native_code_cache* _cache = resolve(receiver, code_id);
+      if (!_cache->apply) {
+         return 0;
       }
-      it->second->apply(receiver, account, act);
+      _cache->apply(receiver, account, act);
       return 1;
    }
 
@@ -1,6 +1,7 @@
 #include <appbase/platform.hpp>
 #include <memory>
 #include <map>
+#include <array>
 
 #include <softfloat.hpp>
 #include <eosiolib_native/vm_api.h>
@@ -23,8 +24,9 @@ namespace eosio { namespace chain {
 
    struct native_code_cache {
          uint32_t version;
+         std::array<char, 32> code_id; ///< code_version of the account when the entry was resolved
          void *handle;
-         fn_apply apply;
+         fn_apply apply;               ///< nullptr if the account has no native implementation
    };
 
    class native_interface {
@@ -37,12 +39,12 @@ namespace eosio { namespace chain {
       fn_apply load_native_contract(uint64_t _account);
       fn_apply load_native_contract_default(uint64_t _account);
       int apply(uint64_t receiver, uint64_t account, uint64_t act);
+
+      /// drops the cached entry of `account`, a new row in the native table drops all of them
+      void unload(uint64_t account);
    private:
-      fn_apply _bios_apply;
-      fn_apply _msig_apply;
-      fn_apply _token_apply;
-      fn_apply _eosio_apply;
-      fn_apply _exchange_apply;
+      native_code_cache* resolve(uint64_t account, const std::array<char, 32>& code_id);
+      native_code_cache* cache_entry(uint64_t account, uint32_t version, void* handle);
 
       map<uint64_t, std::unique_ptr<native_code_cache>> native_cache;
    };
@@ -32,9 +32,15 @@ void vm_deinit() {
 
 int vm_setcode(uint64_t account) {
    printf("+++++vm_native: setcode\n");
+   eosio::chain::native_interface::get().unload(account);
    return 0;
 }
 
+int vm_unload(uint64_t account) {
+   eosio::chain::native_interface::get().unload(account);
+   return 1;
+}
+
 int vm_apply(uint64_t receiver, uint64_t account, uint64_t act) {
    return eosio::chain::native_interface::get().apply(receiver, account, act);
 }
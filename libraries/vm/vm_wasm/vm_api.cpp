@@ -1022,6 +1022,12 @@ class database_api : public context_aware_api {
       int db_end_i64( uint64_t code, uint64_t scope, uint64_t table ) {
          return API()->db_end_i64( code, scope, table );
       }
+      int db_scan_i64( uint64_t code, uint64_t scope, uint64_t table, uint64_t& lower, uint64_t upper, uint32_t limit, array_ptr<char> buffer, size_t buffer_size ) {
+         return API()->db_scan_i64( code, scope, table, &lower, upper, limit, buffer, buffer_size );
+      }
+      int db_idx64_scan( uint64_t code, uint64_t scope, uint64_t table, uint64_t row_table, uint64_t& secondary, uint64_t& primary, uint64_t upper, uint32_t limit, array_ptr<char> buffer, size_t buffer_size ) {
+         return API()->db_idx64_scan( code, scope, table, row_table, &secondary, &primary, upper, limit, buffer, buffer_size );
+      }
 
       DB_API_METHOD_WRAPPERS_SIMPLE_SECONDARY(idx64,  uint64_t)
       DB_API_METHOD_WRAPPERS_SIMPLE_SECONDARY(idx128, uint128_t)
@@ -1494,6 +1500,8 @@ REGISTER_INTRINSICS( database_api,
    (db_lowerbound_i64,   int(int64_t,int64_t,int64_t,int64_t))
    (db_upperbound_i64,   int(int64_t,int64_t,int64_t,int64_t))
    (db_end_i64,          int(int64_t,int64_t,int64_t))
+   (db_scan_i64,         int(int64_t,int64_t,int64_t,int,int64_t,int,int,int))
+   (db_idx64_scan,       int(int64_t,int64_t,int64_t,int64_t,int,int,int64_t,int,int,int))
 
    DB_SECONDARY_INDEX_METHODS_SIMPLE(idx64)
    DB_SECONDARY_INDEX_METHODS_SIMPLE(idx128)
@@ -8,6 +8,7 @@ using namespace eosio;
 int wasm_setcode(uint64_t account);
 int wasm_apply(uint64_t receiver, uint64_t account, uint64_t act);
 int wasm_preload(uint64_t account);
+int wasm_preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size);
 int wasm_unload(uint64_t account);
 
 namespace eosio {
@@ -62,6 +63,10 @@ int vm_preload(uint64_t account) {
    return wasm_preload(account);
 }
 
+int vm_preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size) {
+   return wasm_preload_code(account, code, size, code_id, code_id_size);
+}
+
 int vm_unload(uint64_t account) {
    return wasm_unload(account);
 }
@@ -80,6 +85,18 @@ void pause_billing_timer() {
    get_vm_api()->pause_billing_timer();
 }
 
+void vm_profile_begin(int phase) {
+   if (get_vm_api()->profile_begin) {
+      get_vm_api()->profile_begin(phase);
+   }
+}
+
+void vm_profile_end(int phase) {
+   if (get_vm_api()->profile_end) {
+      get_vm_api()->profile_end(phase);
+   }
+}
+
 const char* get_code( uint64_t receiver, size_t* size ) {
    return get_vm_api()->get_code( receiver, size );
 }
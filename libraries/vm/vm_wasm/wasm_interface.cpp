@@ -89,6 +89,12 @@ namespace eosio { namespace chain {
       return 1;
    }
 
+   int wasm_interface::preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size) {
+      EOS_ASSERT(code_id_size == sizeof(wasm_instantiated_module_interface::code_id), wasm_exception, "bad code id size");
+      my->load_module(account, code, size, code_id);
+      return 1;
+   }
+
    int wasm_interface::unload(uint64_t account) {
       return my->unload_module(account);
    }
@@ -112,6 +118,10 @@ int wasm_preload(uint64_t account) {
    return wasm_interface::get().preload(account);
 }
 
+int wasm_preload_code(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size) {
+   return wasm_interface::get().preload_code(account, code, size, code_id, code_id_size);
+}
+
 int wasm_unload(uint64_t account) {
    return wasm_interface::get().unload(account);
 }
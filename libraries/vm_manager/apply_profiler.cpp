@@ -0,0 +1,121 @@
+#include "apply_profiler.hpp"
+
+#include <time.h>
+#include <chrono>
+
+namespace eosio {
+namespace chain {
+
+namespace {
+
+struct action_frame {
+   uint64_t start_ns;
+   uint64_t start_cpu_ns;
+   uint64_t phase_ns[profile_phase_count];
+   uint64_t phase_start_ns = 0;
+   int phase = -1;
+   int phase_depth = 0;
+   uint64_t db_calls = 0;
+};
+
+//actions nest when a contract calls another one synchronously
+thread_local std::vector<action_frame> frames;
+
+uint64_t now_ns() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t thread_cpu_ns() {
+   struct timespec ts;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+}
+
+apply_profiler& apply_profiler::get() {
+   //initialized once even when the http thread and the chain thread get here first together
+   static apply_profiler profiler;
+   return profiler;
+}
+
+void apply_profiler::reset() {
+   std::lock_guard<std::mutex> lock(profiles_lock);
+   profiles.clear();
+}
+
+void apply_profiler::begin_action() {
+   action_frame frame;
+   frame.start_ns = now_ns();
+   frame.start_cpu_ns = thread_cpu_ns();
+   for (auto& ns : frame.phase_ns) {
+      ns = 0;
+   }
+   frames.push_back(frame);
+}
+
+void apply_profiler::end_action(uint64_t receiver, uint64_t act, int vm_type) {
+   if (frames.empty()) {
+      return;
+   }
+   action_frame frame = frames.back();
+   frames.pop_back();
+
+   uint64_t wall = now_ns() - frame.start_ns;
+   uint64_t cpu = thread_cpu_ns() - frame.start_cpu_ns;
+   uint64_t accounted = frame.phase_ns[profile_load] + frame.phase_ns[profile_instantiate] + frame.phase_ns[profile_db];
+   frame.phase_ns[profile_execute] = wall > accounted ? wall - accounted : 0;
+
+   std::lock_guard<std::mutex> lock(profiles_lock);
+   auto& profile = profiles[std::make_tuple(receiver, act, vm_type)];
+   profile.receiver = receiver;
+   profile.act = act;
+   profile.vm_type = vm_type;
+   profile.wall_ns.record(wall);
+   profile.cpu_ns.record(cpu);
+   for (int i = 0; i < profile_phase_count; i++) {
+      profile.phase_ns[i].record(frame.phase_ns[i]);
+   }
+   profile.db_calls.record(frame.db_calls);
+}
+
+void apply_profiler::begin_phase(int phase) {
+   if (frames.empty() || phase < 0 || phase >= profile_execute) {
+      return;
+   }
+   auto& frame = frames.back();
+   if (phase == profile_db) {
+      frame.db_calls += 1;
+   }
+   //a phase started inside another one is accounted to the outer phase
+   if (frame.phase_depth++ == 0) {
+      frame.phase = phase;
+      frame.phase_start_ns = now_ns();
+   }
+}
+
+void apply_profiler::end_phase(int phase) {
+   if (frames.empty()) {
+      return;
+   }
+   auto& frame = frames.back();
+   if (frame.phase_depth == 0) {
+      return;
+   }
+   if (--frame.phase_depth == 0) {
+      frame.phase_ns[frame.phase] += now_ns() - frame.phase_start_ns;
+   }
+}
+
+std::vector<action_profile> apply_profiler::get_profiles() {
+   std::vector<action_profile> result;
+   std::lock_guard<std::mutex> lock(profiles_lock);
+   result.reserve(profiles.size());
+   for (auto& item : profiles) {
+      result.push_back(item.second);
+   }
+   return result;
+}
+
+}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "latency_histogram.hpp"
+
+namespace eosio {
+namespace chain {
+
+//phases an action's wall time is split into, the VMs report the first three through vm_api
+enum profile_phase {
+   profile_load = 0,
+   profile_instantiate = 1,
+   profile_db = 2,
+   profile_execute = 3,
+   profile_phase_count = 4
+};
+
+struct action_profile {
+   uint64_t receiver = 0;
+   uint64_t act = 0;
+   int vm_type = 0;
+
+   latency_histogram wall_ns;
+   latency_histogram cpu_ns;
+   latency_histogram phase_ns[profile_phase_count];
+   latency_histogram db_calls;
+};
+
+/**
+ * Collects wall and cpu time of every action applied through vm_manager, per (receiver, action, vm type).
+ * Disabled by default; while disabled each hook costs one relaxed atomic load.
+ * Cpu time is only sampled per action: reading the thread cpu clock around every db call would cost
+ * more than most db calls.
+ */
+class apply_profiler
+{
+public:
+   static apply_profiler& get();
+
+   bool enabled() const { return is_enabled.load(std::memory_order_relaxed); }
+   void enable(bool on) { is_enabled.store(on, std::memory_order_relaxed); }
+   void reset();
+
+   void begin_action();
+   void end_action(uint64_t receiver, uint64_t act, int vm_type);
+   void begin_phase(int phase);
+   void end_phase(int phase);
+
+   std::vector<action_profile> get_profiles();
+
+private:
+   apply_profiler() {}
+
+   std::atomic<bool> is_enabled{false};
+   std::mutex profiles_lock;
+   std::map<std::tuple<uint64_t, uint64_t, int>, action_profile> profiles;
+};
+
+}
+}
@@ -0,0 +1,167 @@
+#include "compile_pool.hpp"
+#include "vm_manager.hpp"
+
+#include <fc/log/logger.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/time.hpp>
+
+#include <algorithm>
+
+namespace eosio {
+namespace chain {
+
+compile_pool::compile_pool(const std::vector<vm_calls*>& _workers, fn_on_compiled _on_compiled) : on_compiled(_on_compiled) {
+   for (auto calls : _workers) {
+      std::unique_ptr<worker> w = std::make_unique<worker>();
+      w->calls = calls;
+      workers.push_back(std::move(w));
+   }
+   for (int i=0;i<workers.size();i++) {
+      workers[i]->thread = std::thread(&compile_pool::run, this, i);
+   }
+}
+
+compile_pool::~compile_pool() {
+   {
+      std::lock_guard<std::mutex> lock(queue_lock);
+      stopping = true;
+   }
+   queue_cond.notify_all();
+   for (auto& w : workers) {
+      w->thread.join();
+   }
+}
+
+static uint64_t get_clock_microseconds() {
+   return fc::time_point::now().time_since_epoch().count();
+}
+
+void compile_pool::push(uint64_t account) {
+   compile_job job;
+   job.account = account;
+   push(std::move(job), -1);
+}
+
+void compile_pool::push(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size, int worker) {
+   compile_job job;
+   job.account = account;
+   job.code.assign(code, code + size);
+   job.code_id.assign(code_id, code_id + code_id_size);
+   push(std::move(job), worker);
+}
+
+void compile_pool::push_unload(uint64_t account, int worker) {
+   compile_job job;
+   job.account = account;
+   job.unload_worker = worker;
+   push(std::move(job), worker);
+}
+
+void compile_pool::push(compile_job&& job, int worker) {
+   job.queued_at = get_clock_microseconds();
+   {
+      std::lock_guard<std::mutex> lock(queue_lock);
+      if (worker < 0 || worker >= workers.size()) {
+         worker = next_worker;
+         next_worker = (next_worker + 1) % workers.size();
+      }
+      workers[worker]->queue.push_back(std::move(job));
+      pending += 1;
+   }
+   queue_cond.notify_all();
+}
+
+compile_stats compile_pool::get_stats() {
+   std::lock_guard<std::mutex> lock(queue_lock);
+   compile_stats _stats = stats;
+   _stats.queue_depth = pending;
+   return _stats;
+}
+
+void compile_pool::wait_idle() {
+   std::unique_lock<std::mutex> lock(queue_lock);
+   idle_cond.wait(lock, [this]() { return pending == 0; });
+}
+
+//must be called with queue_lock held
+bool compile_pool::pop(int index, compile_job& job) {
+   auto& own = workers[index]->queue;
+   if (!own.empty()) {
+      job = std::move(own.front());
+      own.pop_front();
+      return true;
+   }
+
+   worker* victim = nullptr;
+   for (auto& w : workers) {
+      if (!w->queue.empty() && (!victim || w->queue.size() > victim->queue.size())) {
+         victim = w.get();
+      }
+   }
+   if (!victim) {
+      return false;
+   }
+   job = std::move(victim->queue.back());
+   victim->queue.pop_back();
+   return true;
+}
+
+void compile_pool::run(int index) {
+   auto& w = *workers[index];
+   while (true) {
+      compile_job job;
+      {
+         std::unique_lock<std::mutex> lock(queue_lock);
+         queue_cond.wait(lock, [&]() { return stopping || pop(index, job); });
+         if (stopping) {
+            return;
+         }
+      }
+
+      if (job.unload_worker >= 0) {
+         //the job may have been stolen, unload from the copy it was queued for
+         try {
+            std::lock_guard<std::mutex> lock(workers[job.unload_worker]->vm_lock);
+            workers[job.unload_worker]->calls->unload(job.account);
+         } FC_LOG_AND_DROP();
+         on_compiled(job.account, job.unload_worker, false);
+         {
+            std::lock_guard<std::mutex> lock(queue_lock);
+            pending -= 1;
+         }
+         idle_cond.notify_all();
+         continue;
+      }
+
+      uint64_t start = get_clock_microseconds();
+      bool compiled = false;
+      try {
+         std::lock_guard<std::mutex> lock(w.vm_lock);
+         if (job.code.size() == 0) {
+            compiled = w.calls->preload(job.account) > 0;
+         } else if (w.calls->preload_code) {
+            compiled = w.calls->preload_code(job.account, job.code.data(), job.code.size(), job.code_id.data(), job.code_id.size()) > 0;
+         }
+      } FC_LOG_AND_DROP();
+      uint64_t end = get_clock_microseconds();
+
+      on_compiled(job.account, index, compiled);
+
+      {
+         std::lock_guard<std::mutex> lock(queue_lock);
+         pending -= 1;
+         if (compiled) {
+            stats.compiled += 1;
+         } else {
+            stats.failed += 1;
+         }
+         stats.total_wait_us += start - job.queued_at;
+         stats.total_compile_us += end - start;
+         stats.max_compile_us = std::max(stats.max_compile_us, end - start);
+      }
+      idle_cond.notify_all();
+   }
+}
+
+}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eosio {
+namespace chain {
+
+struct vm_calls;
+
+struct compile_stats {
+   uint64_t queue_depth = 0;
+   uint64_t compiled = 0;
+   uint64_t failed = 0;
+   uint64_t total_wait_us = 0;
+   uint64_t total_compile_us = 0;
+   uint64_t max_compile_us = 0;
+};
+
+/**
+ * Compiles contracts in the background, one worker thread per WAVM library copy.
+ * WAVM keeps its runtime in globals, so a copy may only run one compile or apply at a time:
+ * each worker owns its copy and guards it with the worker's vm lock.
+ * Accounts are handed out round robin; a worker that runs dry steals from the back of
+ * the busiest queue, so pushing accounts most-used first compiles the hot ones first.
+ */
+class compile_pool
+{
+public:
+   typedef std::function<void(uint64_t account, int worker, bool compiled)> fn_on_compiled;
+
+   compile_pool(const std::vector<vm_calls*>& workers, fn_on_compiled on_compiled);
+   ~compile_pool();
+
+   void push(uint64_t account);
+   //compiles code handed over by the caller instead of reading it from the chain state,
+   //for use while the main thread is applying blocks. A worker >= 0 queues it on that worker.
+   void push(uint64_t account, const char* code, size_t size, const char* code_id, size_t code_id_size, int worker = -1);
+   //drops account's module from worker's copy. Queued so that the caller doesn't wait for the copy's current compile,
+   //reported through on_compiled as not compiled.
+   void push_unload(uint64_t account, int worker);
+   void wait_idle();
+   compile_stats get_stats();
+
+   int size() const { return (int)workers.size(); }
+   vm_calls* get_calls(int worker) { return workers[worker]->calls; }
+   std::mutex& get_vm_lock(int worker) { return workers[worker]->vm_lock; }
+
+private:
+   struct compile_job {
+      uint64_t               account;
+      std::vector<char>      code;
+      std::vector<char>      code_id;
+      uint64_t               queued_at;
+      int                    unload_worker = -1;
+   };
+
+   struct worker {
+      vm_calls*              calls;
+      std::deque<compile_job> queue;
+      std::mutex             vm_lock;
+      std::thread            thread;
+   };
+
+   void push(compile_job&& job, int worker);
+   bool pop(int index, compile_job& job);
+   void run(int index);
+
+   std::vector<std::unique_ptr<worker>> workers;
+   fn_on_compiled on_compiled;
+
+   std::mutex queue_lock;
+   std::condition_variable queue_cond;
+   std::condition_variable idle_cond;
+   int next_worker = 0;
+   int pending = 0;
+   bool stopping = false;
+   compile_stats stats;
+};
+
+}
+}
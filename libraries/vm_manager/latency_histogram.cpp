@@ -0,0 +1,96 @@
+#include "latency_histogram.hpp"
+
+#include <fc/exception/exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace eosio {
+namespace chain {
+
+namespace {
+
+uint32_t msb(uint64_t v) { return 63 - __builtin_clzll(v); }
+
+}
+
+latency_histogram::latency_histogram(uint64_t max_value, uint32_t precision_bits)
+: precision_bits(precision_bits), max_value(max_value) {
+   FC_ASSERT(precision_bits >= 2 && precision_bits <= 16, "precision of ${b} bits is out of range", ("b", precision_bits));
+   FC_ASSERT(max_value > 0, "the histogram needs a maximum value");
+   counts.resize(index_of(max_value) + 1);
+}
+
+size_t latency_histogram::index_of(uint64_t value) const {
+   const uint64_t exact = 1ull << precision_bits;
+   if (value < exact) {
+      return value;
+   }
+   //bucket k >= 1 covers [2^(precision_bits + k - 1), 2^(precision_bits + k)) in half as many slots of width 2^k
+   const uint64_t half = exact >> 1;
+   const uint32_t k = msb(value) - precision_bits + 1;
+   return exact + (k - 1) * half + ((value >> k) - half);
+}
+
+uint64_t latency_histogram::highest_equivalent(size_t index) const {
+   const uint64_t exact = 1ull << precision_bits;
+   if (index < exact) {
+      return index;
+   }
+   const uint64_t half = exact >> 1;
+   const uint32_t k = (index - exact) / half + 1;
+   const uint64_t sub = (index - exact) % half + half;
+   return ((sub + 1) << k) - 1;
+}
+
+void latency_histogram::record(uint64_t value) {
+   value = std::min(value, max_value);
+   counts[index_of(value)] += 1;
+   total_count += 1;
+   total_sum += value;
+   min_recorded = std::min(min_recorded, value);
+   max_recorded = std::max(max_recorded, value);
+}
+
+void latency_histogram::reset() {
+   std::fill(counts.begin(), counts.end(), 0);
+   total_count = 0;
+   total_sum = 0;
+   min_recorded = UINT64_MAX;
+   max_recorded = 0;
+}
+
+uint64_t latency_histogram::percentile(double p) const {
+   if (total_count == 0) {
+      return 0;
+   }
+   p = std::min(std::max(p, 0.0), 100.0);
+   const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(p / 100.0 * total_count)));
+   uint64_t seen = 0;
+   for (size_t i = 0; i < counts.size(); i++) {
+      seen += counts[i];
+      if (seen >= rank) {
+         return std::min(highest_equivalent(i), max_recorded);
+      }
+   }
+   return max_recorded;
+}
+
+latency_summary latency_histogram::summary() const {
+   latency_summary s;
+   s.count = total_count;
+   if (total_count == 0) {
+      return s;
+   }
+   s.min = min_recorded;
+   s.mean = total_sum / total_count;
+   s.p50 = percentile(50);
+   s.p90 = percentile(90);
+   s.p99 = percentile(99);
+   s.p999 = percentile(99.9);
+   s.max = max_recorded;
+   return s;
+}
+
+}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include <fc/reflect/reflect.hpp>
+
+namespace eosio {
+namespace chain {
+
+//percentiles of a latency_histogram, in the unit of the recorded values
+struct latency_summary {
+   uint64_t count = 0;
+   uint64_t min = 0;
+   uint64_t mean = 0;
+   uint64_t p50 = 0;
+   uint64_t p90 = 0;
+   uint64_t p99 = 0;
+   uint64_t p999 = 0;
+   uint64_t max = 0;
+};
+
+/**
+ * Log-linear histogram in the spirit of HdrHistogram: values below 2^precision_bits have a bucket each,
+ * above that every power of two range is split in 2^(precision_bits - 1) buckets, so any value is reported
+ * within a relative error of 2^-(precision_bits - 1) with a fixed amount of memory.
+ * Values above max_value are counted as max_value.
+ * The defaults are those of the action profiler: up to 2^40 (~18 minutes in nanoseconds) within 12.5%.
+ */
+class latency_histogram
+{
+public:
+   explicit latency_histogram(uint64_t max_value = 1ull << 40, uint32_t precision_bits = 4);
+
+   void record(uint64_t value);
+   void reset();
+
+   uint64_t count() const { return total_count; }
+   uint64_t sum() const { return total_sum; }
+   uint64_t max() const { return max_recorded; }
+   //the highest value equivalent to the value at percentile p of the recorded values, p in [0, 100]
+   uint64_t percentile(double p) const;
+   latency_summary summary() const;
+
+private:
+   size_t index_of(uint64_t value) const;
+   uint64_t highest_equivalent(size_t index) const;
+
+   uint32_t precision_bits;
+   uint64_t max_value;
+   std::vector<uint64_t> counts;
+   uint64_t total_count = 0;
+   uint64_t total_sum = 0;
+   uint64_t min_recorded = UINT64_MAX;
+   uint64_t max_recorded = 0;
+};
+
+}
+}
+
+FC_REFLECT( eosio::chain::latency_summary, (count)(min)(mean)(p50)(p90)(p99)(p999)(max) )
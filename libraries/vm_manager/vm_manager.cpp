@@ -1,4 +1,5 @@
 #include "vm_manager.hpp"
+#include "apply_profiler.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -7,6 +8,7 @@
 #include <boost/thread/thread.hpp>
 
 #include <eosio/chain/exceptions.hpp>
+#include <fc/scoped_exit.hpp>
 
 #include <appbase/application.hpp>
 #include <appbase/platform.hpp>
@@ -16,8 +18,10 @@
 #include <time.h>
 #include <unistd.h> // for sysconf
 
+#include <algorithm>
 #include <thread>
 #include <mutex>
+#include <fstream>
 #include <dlfcn.h>
 #include <eosiolib/system.h>
 
@@ -35,7 +39,6 @@ namespace chain {
 }
 
 #define WAVM_VM_START_INDEX (0x10000)
-#define VM_WASM_WAVM_COUNT (1)
 
 typedef void (*fn_on_boost_account)(void* v, uint64_t account, uint64_t expiration);
 void visit_boost_account(fn_on_boost_account fn, void* param);
@@ -224,6 +227,10 @@ bool vm_manager::init() {
    return true;
 }
 
+bool vm_manager::has_vm(int vm_type) {
+   return vm_map.find(vm_type) != vm_map.end();
+}
+
 int vm_manager::load_vm_cpython() {
    return load_vm_from_path(VM_TYPE_CPYTHON_PRIVILEGED, vm_cpython_lib);
 }
@@ -237,14 +244,6 @@ int vm_manager::load_vm_wavm() {
 #else
     load_vm_from_path(default_wavm_index, vm_libs_path[default_wavm_index]);
 #endif
-   char _path[128];
-   const char* _format = "../libs/libvm_wasm_wavm-%d" DYLIB_SUFFIX;
-
-   for (int i=1;i<=VM_WASM_WAVM_COUNT;i++) {
-      snprintf(_path, sizeof(_path), _format, i);
-      load_vm_from_path(WAVM_VM_START_INDEX|i, _path);
-   }
-
    visit_boost_account(_on_boost_account, this);
 
    auto itr = vm_map.find(3);
@@ -254,77 +253,207 @@ int vm_manager::load_vm_wavm() {
             if (db_api::get().get_code_type(account) == 0) {
                auto t = time_counter(account);
                itr->second->preload(account);
-               std::unique_ptr<vm_calls> calls = std::make_unique<vm_calls>();
-               *calls = *itr->second;
-               preload_account_map[account] = std::move(calls);
             }
          }
       }
    }
 
-   if (boost_accounts.size() > 0) {
-      boost::thread_group g;
+   //every libvm_wasm_wavm-N copy carries its own WAVM globals, so each one can JIT on its own thread.
+   //Use as many copies as there are cores, or as were built (copies 1 to VM_WASM_WAVM_COUNT - 1 in CMake).
+   int cpu_num = std::thread::hardware_concurrency();
+   if (cpu_num <= 0) {
+      cpu_num = 1;
+   }
 
-      int cpu_num = std::thread::hardware_concurrency();
-      if (cpu_num <= 0) {
-         cpu_num = 1;
+   char _path[128];
+   const char* _format = "../libs/libvm_wasm_wavm-%d" DYLIB_SUFFIX;
+   vector<vm_calls*> workers;
+   for (int i=1;i<=cpu_num;i++) {
+      snprintf(_path, sizeof(_path), _format, i);
+      if (access(_path, F_OK) != 0) {
+         break;
+      }
+      load_vm_from_path(WAVM_VM_START_INDEX|i, _path);
+      auto _itr = vm_map.find(WAVM_VM_START_INDEX|i);
+      if (_itr == vm_map.end() || !_itr->second->preload) {
+         break;
       }
+      workers.push_back(_itr->second.get());
+   }
+
+   if (workers.size() == 0) {
+      return 1;
+   }
 
-      wlog("preloading code in ${n} threads", ("n", cpu_num));
+   if (!wavm_pool) {
+      wavm_pool = std::make_unique<compile_pool>(workers, [this](uint64_t account, int worker, bool compiled) {
+         on_preloaded(account, worker, compiled);
+      });
+   }
 
-      for (int i=1;i<=cpu_num;i++) {//TODO: 10 --> number of CPU cores
-         auto itr = vm_map.find(WAVM_VM_START_INDEX|i);
-         if (itr == vm_map.end()) {
-            continue;
-         }
-         if (!itr->second->preload) {
-            continue;
+   if (boost_accounts.size() > 0) {
+      wlog("preloading code in ${n} threads", ("n", workers.size()));
+      load_wavm_usage();
+      {
+         std::lock_guard<std::mutex> lock(preload_lock);
+         std::stable_sort(boost_accounts.begin(), boost_accounts.end(), [this](uint64_t a, uint64_t b) {
+            return wavm_usage[a] > wavm_usage[b];
+         });
+      }
+      for (uint64_t account : boost_accounts) {
+         if (account == N(eosio) || account == N(eosio.token)) {
+            continue;//already loaded in vm type 3
          }
+         wavm_pool->push(account);
+      }
+      boost_accounts.clear();
+      wavm_pool->wait_idle();
+   }
+   return 1;
+}
 
-         const auto _calls = itr->second.get();
-         g.create_thread( boost::bind( &vm_manager::preload_accounts,this, _calls ) );
+void vm_manager::on_preloaded(uint64_t account, int worker, bool compiled) {
+   std::lock_guard<std::mutex> lock(preload_lock);
+   auto itr = compiling_accounts.find(account);
+   if (itr != compiling_accounts.end()) {
+      itr->second -= 1;
+      if (itr->second > 0) {
+         return; //a newer setcode is still queued, its compile decides where the code goes
+      }
+      compiling_accounts.erase(itr);
+   }
+   if (compiled) {
+      preload_account_map[account] = worker;
+      //ranked above the accounts it was preloaded with, the ranking of those is kept from the last run
+      if (wavm_usage.find(account) == wavm_usage.end()) {
+         wavm_usage[account] = ++usage_clock;
       }
-      g.join_all();
    }
+}
+
+/*
+ * runs receiver's code on the WAVM copy it was preloaded into.
+ * returns 1 if it did, 0 if receiver isn't preloaded, and -1 if receiver's code is still being
+ * compiled in the background or its copy is busy compiling another account.
+ */
+int vm_manager::apply_preloaded(uint64_t receiver, uint64_t account, uint64_t act) {
+   if (!wavm_pool) {
+      return 0;
+   }
+   int worker;
+   {
+      std::lock_guard<std::mutex> lock(preload_lock);
+      auto itr = preload_account_map.find(receiver);
+      if (itr == preload_account_map.end()) {
+         return compiling_accounts.find(receiver) == compiling_accounts.end() ? 0 : -1;
+      }
+      worker = itr->second;
+   }
+   std::unique_lock<std::mutex> lock(wavm_pool->get_vm_lock(worker), std::try_to_lock);
+   if (!lock.owns_lock()) {
+      //busy compiling, run receiver on the interpreter rather than on the default WAVM instance
+      return -1;
+   }
+   wavm_pool->get_calls(worker)->apply(receiver, account, act);
    return 1;
 }
 
-void vm_manager::preload_accounts(vm_calls* _calls) {
-   static std::mutex m1, m2;
-   while(true) {
-      uint64_t account;
+//queues account's current code for compiling on the pool. The code is copied here since
+//workers must not read the chain state while blocks are being applied.
+bool vm_manager::compile_async(uint64_t account) {
+   if (!wavm_pool) {
+      return false;
+   }
+   size_t size = 0;
+   const char* code = this->api->get_code(account, &size);
+   if (size <= 0) {
+      //the copy holding the code may be compiling, leave the unload to its worker
+      int worker = -1;
       {
-         std::lock_guard<std::mutex> lock(m1);
-         if (boost_accounts.empty()) {
-            break;
+         std::lock_guard<std::mutex> lock(preload_lock);
+         auto itr = preload_account_map.find(account);
+         if (itr != preload_account_map.end()) {
+            worker = itr->second;
+            preload_account_map.erase(itr);
+            compiling_accounts[account] += 1;
          }
-         account = boost_accounts.back();
-         boost_accounts.pop_back();
+         wavm_usage.erase(account);
       }
-      {
-         if (account == N(eosio) || account == N(eosio.token)) {
-            continue;//already loaded in vm type 3
-         }
-         {
-            auto t = time_counter(account);
-            _calls->preload(account);
-         }
+      if (worker >= 0) {
+         wavm_pool->push_unload(account, worker);
+      }
+      auto _itr = vm_map.find(VM_TYPE_WAVM);
+      if (_itr != vm_map.end()) {
+         _itr->second->unload(account);
+      }
+      return false;
+   }
+   char code_id[8*4];
+   if (!this->api->get_code_id(account, code_id, sizeof(code_id))) {
+      return false;
+   }
 
-         std::unique_ptr<vm_calls> calls = std::make_unique<vm_calls>();
-         *calls = *_calls;
-         {
-            std::lock_guard<std::mutex> lock(m2);
-            preload_account_map[account] = std::move(calls);
-         }
+   //drop the stale mapping but leave the old module to be replaced in place: unloading it now would
+   //mean waiting for whatever its copy is compiling
+   int worker = -1;
+   {
+      std::lock_guard<std::mutex> lock(preload_lock);
+      auto itr = preload_account_map.find(account);
+      if (itr != preload_account_map.end()) {
+         worker = itr->second;
+         preload_account_map.erase(itr);
       }
+      compiling_accounts[account] += 1;
+   }
+
+   auto _itr = vm_map.find(VM_TYPE_WAVM);
+   if (_itr != vm_map.end()) {
+      _itr->second->unload(account);
+   }
+
+   wavm_pool->push(account, code, size, code_id, sizeof(code_id), worker);
+   return true;
+}
+
+compile_stats vm_manager::get_compile_stats() {
+   if (!wavm_pool) {
+      return compile_stats();
+   }
+   return wavm_pool->get_stats();
+}
+
+void vm_manager::load_wavm_usage() {
+   std::ifstream in((appbase::app().data_dir() / "wavm-usage.txt").string());
+   string _name;
+   uint64_t last_used;
+   while (in >> _name >> last_used) {
+      wavm_usage[NN(_name.c_str())] = last_used;
+      usage_clock = std::max(usage_clock, last_used);
+   }
+}
+
+void vm_manager::save_wavm_usage() {
+   std::lock_guard<std::mutex> lock(preload_lock);
+   std::ofstream out((appbase::app().data_dir() / "wavm-usage.txt").string());
+   for (auto& u : wavm_usage) {
+      out << name(u.first).to_string() << " " << u.second << "\n";
    }
 }
 
 void vm_manager::unload_account(uint64_t account) {
-   auto itr = preload_account_map.find(account);
-   if (itr != preload_account_map.end()) {
-      itr->second->unload(account);
-      preload_account_map.erase(itr);
+   int worker = -1;
+   {
+      std::lock_guard<std::mutex> lock(preload_lock);
+      auto itr = preload_account_map.find(account);
+      if (itr != preload_account_map.end()) {
+         worker = itr->second;
+         preload_account_map.erase(itr);
+      }
+      wavm_usage.erase(account);
+   }
+   if (worker >= 0) {
+      std::lock_guard<std::mutex> lock(wavm_pool->get_vm_lock(worker));
+      wavm_pool->get_calls(worker)->unload(account);
    }
 
    auto _itr = vm_map.find(3);
@@ -389,6 +518,7 @@ int vm_manager::load_vm_from_path(int vm_type, const char* vm_path) {
    }
    */
    fn_unload unload = (fn_unload)dlsym(handle, "vm_unload");
+   fn_preload_code preload_code = (fn_preload_code)dlsym(handle, "vm_preload_code");
 
    auto __itr = vm_map.find(vm_type);
    if (__itr != vm_map.end()) {
@@ -408,6 +538,7 @@ int vm_manager::load_vm_from_path(int vm_type, const char* vm_path) {
    calls->apply = apply;
    calls->call = _call;
    calls->preload = preload;
+   calls->preload_code = preload_code;
    calls->unload = unload;
 
    vm_map[vm_type] = std::move(calls);
@@ -572,7 +703,12 @@ int vm_manager::setcode(int vm_type, uint64_t account) {
    if (itr == vm_map.end()) {
       return -1;
    }
-   return itr->second->setcode(account);
+   int ret = itr->second->setcode(account);
+   //setcode only validates wasm code, the JIT compile happens off the setcode transaction's path
+   if (vm_type == VM_TYPE_WAVM) {
+      compile_async(account);
+   }
+   return ret;
 }
 
 int vm_manager::apply(int type, uint64_t receiver, uint64_t account, uint64_t act) {
@@ -584,7 +720,27 @@ int vm_manager::apply(int type, uint64_t receiver, uint64_t account, uint64_t ac
          type = VM_TYPE_IPC;
       }
    }
-   return local_apply(type, receiver, account, act);
+
+   apply_profiler& profiler = apply_profiler::get();
+   bool profiling = profiler.enabled();
+   if (profiling) {
+      profiler.begin_action();
+   }
+   auto end_profile = fc::make_scoped_exit([&](){
+      if (profiling) {
+         profiler.end_action(receiver, act, type);
+      }
+   });
+
+   int ret = local_apply(type, receiver, account, act);
+   if (receiver == N(native)) {
+      //the native contract may have stored a new native library, let vm_native check its table again
+      auto itr = vm_map.find(VM_TYPE_NATIVE);
+      if (itr != vm_map.end() && itr->second->unload) {
+         itr->second->unload(receiver);
+      }
+   }
+   return ret;
 }
 
 int vm_manager::call(uint64_t account, uint64_t func) {
@@ -607,6 +763,13 @@ int vm_manager::local_apply(int vm_type, uint64_t receiver, uint64_t account, ui
       }
       if (vm_runtime == 0) {
          vm_type = VM_TYPE_WAVM;
+         int ret = apply_preloaded(receiver, account, act);
+         if (ret > 0) {
+            return 1;
+         } else if (ret < 0 && vm_map.find(VM_TYPE_WABT) != vm_map.end()) {
+            //the new code is still compiling, run it on the interpreter until it's ready
+            vm_type = VM_TYPE_WABT;
+         }
       } else if (vm_runtime == 1) {
          vm_type = VM_TYPE_BINARYEN;
       } else {
@@ -641,6 +804,12 @@ uint64_t vm_manager::wasm_call(const string& func, vector<uint64_t> args) {
 }
 
 int vm_manager::vm_deinit_all() {
+   if (wavm_pool) {
+      try {
+         save_wavm_usage();
+      } FC_LOG_AND_DROP();
+      wavm_pool.reset();
+   }
    for (auto itr = vm_map.begin();itr != vm_map.end();itr++) {
       itr->second->vm_deinit();
    }
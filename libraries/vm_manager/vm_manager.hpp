@@ -13,6 +13,11 @@
 
 #include <eosio/chain/db_api.hpp>
 
+#include <mutex>
+#include <unordered_map>
+
+#include "compile_pool.hpp"
+
 
 using namespace std;
 
@@ -30,6 +35,7 @@ struct vm_calls {
    fn_apply apply;
    fn_call call;
    fn_preload preload;
+   fn_preload_code preload_code;
    fn_unload unload;
 };
 
@@ -54,12 +60,17 @@ public:
    int load_vm_cpython();
 
    bool init();
+   //false if the library of the vm type failed to load, apply on it would silently do nothing
+   bool has_vm(int vm_type);
 
    void *get_eth_vm_api();
 
    uint64_t wasm_call(const string& func, vector<uint64_t> args);
    void on_boost_account(uint64_t account);
-   void preload_accounts(vm_calls* _calls);
+   void on_preloaded(uint64_t account, int worker, bool compiled);
+   int apply_preloaded(uint64_t receiver, uint64_t account, uint64_t act);
+   bool compile_async(uint64_t account);
+   compile_stats get_compile_stats();
 
    void unload_account(uint64_t account);
    bool is_trusted_account(uint64_t account);
@@ -73,7 +84,19 @@ private:
    vector<uint64_t> boost_accounts;
    map<uint64_t, uint64_t> trusted_accounts;
    map<int, std::unique_ptr<vm_calls>> vm_map;
-   map<uint64_t, std::unique_ptr<vm_calls>> preload_account_map;
+   std::unique_ptr<compile_pool> wavm_pool;
+   std::mutex preload_lock;
+   //account -> compile_pool worker whose WAVM copy holds the account's compiled code
+   map<uint64_t, int> preload_account_map;
+   //account -> number of compiles queued for it since its last setcode
+   map<uint64_t, int> compiling_accounts;
+   //account -> value of usage_clock when its code was first preloaded, saved across runs so that the next run
+   //preloads in the same order, newest accounts first. Only touched on preload and unload, under preload_lock.
+   std::unordered_map<uint64_t, uint64_t> wavm_usage;
+   uint64_t usage_clock = 0;
+
+   void load_wavm_usage();
+   void save_wavm_usage();
 };
 
 }
@@ -124,6 +124,10 @@ namespace Runtime
 	// Throws a Runtime::Exception if a trap occurs.
 	RUNTIME_API Result invokeFunction(FunctionInstance* function,const std::vector<Value>& parameters);
 
+	// Invokes a FunctionInstance with arguments the caller has already checked against its type, and returns the result.
+	// Unlike invokeFunction, this doesn't allocate. Throws a Runtime::Exception if a trap occurs.
+	RUNTIME_API Result invokeFunctionUnchecked(FunctionInstance* function,const UntaggedValue* arguments);
+
 	// Returns the type of a FunctionInstance.
 	RUNTIME_API const IR::FunctionType* getFunctionType(FunctionInstance* function);
 
@@ -210,6 +214,8 @@ namespace Runtime
 	RUNTIME_API uint64_t getDefaultMemorySize(ModuleInstance* moduleInstance);
 	RUNTIME_API TableInstance* getDefaultTable(ModuleInstance* moduleInstance);
 
+	// Gets the start function of a ModuleInstance, or null if it doesn't have one.
+	RUNTIME_API FunctionInstance* getInstanceStartFunc(ModuleInstance* moduleInstance);
 	RUNTIME_API void runInstanceStartFunc(ModuleInstance* moduleInstance);
 	RUNTIME_API void resetGlobalInstances(ModuleInstance* moduleInstance);
 	RUNTIME_API void resetMemory(MemoryInstance* memory, IR::MemoryType& newMemoryType);
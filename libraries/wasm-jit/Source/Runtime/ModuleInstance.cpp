@@ -110,11 +110,17 @@ namespace Runtime
       //a new instance while another instance is running
 		
 		// Instantiate the module's global definitions.
-		for(const GlobalDef& globalDef : module.globals.defs)
+		moduleInstance->numGlobalDefs = module.globals.defs.size();
+		moduleInstance->globalDefValues.reset(new UntaggedValue[moduleInstance->numGlobalDefs]);
+		moduleInstance->globalDefInitialValues.reset(new UntaggedValue[moduleInstance->numGlobalDefs]);
+		for(Uptr globalDefIndex = 0;globalDefIndex < module.globals.defs.size();++globalDefIndex)
 		{
+			const GlobalDef& globalDef = module.globals.defs[globalDefIndex];
 			const Value initialValue = evaluateInitializer(moduleInstance,globalDef.initializer);
 			errorUnless(initialValue.type == globalDef.type.valueType);
-			moduleInstance->globals.push_back(new GlobalInstance(globalDef.type,initialValue));
+			moduleInstance->globalDefValues[globalDefIndex] = initialValue;
+			moduleInstance->globalDefInitialValues[globalDefIndex] = initialValue;
+			moduleInstance->globals.push_back(new GlobalInstance(globalDef.type,&moduleInstance->globalDefValues[globalDefIndex],moduleInstance));
 		}
 		
 		// Create the FunctionInstance objects for the module's function definitions.
@@ -185,14 +191,21 @@ namespace Runtime
 	uint64_t getDefaultMemorySize(ModuleInstance* moduleInstance) { return moduleInstance->defaultMemory->numPages << IR::numBytesPerPageLog2; }
 	TableInstance* getDefaultTable(ModuleInstance* moduleInstance) { return moduleInstance->defaultTable; }
 
+	FunctionInstance* getInstanceStartFunc(ModuleInstance* moduleInstance) {
+		if(moduleInstance->startFunctionIndex == UINTPTR_MAX)
+			return nullptr;
+		return moduleInstance->functions[moduleInstance->startFunctionIndex];
+	}
+
 	void runInstanceStartFunc(ModuleInstance* moduleInstance) {
 		if(moduleInstance->startFunctionIndex != UINTPTR_MAX)
 			invokeFunction(moduleInstance->functions[moduleInstance->startFunctionIndex],{});
 	}
 
+	//Imported globals are immutable, so only the module's own definitions need resetting, and those
+	//live in one contiguous block.
 	void resetGlobalInstances(ModuleInstance* moduleInstance) {
-		for(GlobalInstance*& gi : moduleInstance->globals)
-			memcpy(&gi->value, &gi->initialValue, sizeof(gi->value));
+		memcpy(moduleInstance->globalDefValues.get(), moduleInstance->globalDefInitialValues.get(), moduleInstance->numGlobalDefs * sizeof(UntaggedValue));
 	}
 	
 	ObjectInstance* getInstanceExport(ModuleInstance* moduleInstance,const std::string& name)
@@ -97,8 +97,14 @@ namespace Runtime
 				childReferences.insert(childReferences.end(),table->elements.begin(),table->elements.end());
 				break;
 			}
-			case ObjectKind::memory:
-			case ObjectKind::global: break;
+			case ObjectKind::global:
+			{
+				// A module-defined global's value lives in its module, so keep the module alive with it.
+				GlobalInstance* global = asGlobal(scanObject);
+				childReferences.push_back(global->ownerModule);
+				break;
+			}
+			case ObjectKind::memory: break;
 			default: Errors::unreachable();
 			};
 
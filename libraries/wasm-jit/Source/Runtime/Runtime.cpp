@@ -131,6 +131,45 @@ namespace Runtime
 		else { handleHardwareTrap(trapType,std::move(trapCallStack),trapOperand); }
 	}
 
+	Result invokeFunctionUnchecked(FunctionInstance* function,const UntaggedValue* arguments)
+	{
+		const FunctionType* functionType = function->type;
+		const Uptr numParameters = functionType->parameters.size();
+
+		U64* thunkMemory = (U64*)alloca((numParameters + getArity(functionType->ret)) * sizeof(U64));
+		for(Uptr parameterIndex = 0;parameterIndex < numParameters;++parameterIndex)
+		{ thunkMemory[parameterIndex] = arguments[parameterIndex].i64; }
+
+		// Bundle the thunk's state behind a single pointer so the lambda fits in std::function's
+		// inline storage and the call doesn't heap allocate.
+		struct InvokeState
+		{
+			LLVMJIT::InvokeFunctionPointer invokeFunctionPointer;
+			FunctionInstance* function;
+			const FunctionType* functionType;
+			U64* thunkMemory;
+			Result result;
+		} state = { LLVMJIT::getInvokeThunk(functionType), function, functionType, thunkMemory, Result() };
+		InvokeState* statePointer = &state;
+
+		Platform::HardwareTrapType trapType;
+		Platform::CallStack trapCallStack;
+		Uptr trapOperand;
+		trapType = Platform::catchHardwareTraps(trapCallStack,trapOperand,
+			[statePointer]
+			{
+				(*statePointer->invokeFunctionPointer)(statePointer->function->nativeFunction,statePointer->thunkMemory);
+				if(statePointer->functionType->ret != ResultType::none)
+				{
+					statePointer->result.type = statePointer->functionType->ret;
+					statePointer->result.i64 = statePointer->thunkMemory[statePointer->functionType->parameters.size()];
+				}
+			});
+
+		if(trapType == Platform::HardwareTrapType::none) { return state.result; }
+		else { handleHardwareTrap(trapType,std::move(trapCallStack),trapOperand); }
+	}
+
 	const FunctionType* getFunctionType(FunctionInstance* function)
 	{
 		return function->type;
@@ -7,6 +7,7 @@
 #include <functional>
 #include <map>
 #include <atomic>
+#include <memory>
 
 #define HAS_64BIT_ADDRESS_SPACE (sizeof(Uptr) == 8 && !PRETEND_32BIT_ADDRESS_SPACE)
 
@@ -95,13 +96,17 @@ namespace Runtime
 	};
 
 	// An instance of a WebAssembly global.
+	// Globals defined by a module keep their value in the module's contiguous globalDefValues block, so the
+	// whole set can be reset with a single memcpy; other globals keep it in localValue.
 	struct GlobalInstance : GCObject
 	{
 		GlobalType type;
-		UntaggedValue value;
-		UntaggedValue initialValue;
+		UntaggedValue localValue;
+		UntaggedValue& value;
+		ModuleInstance* ownerModule;
 
-		GlobalInstance(GlobalType inType,UntaggedValue inValue): GCObject(ObjectKind::global), type(inType), value(inValue), initialValue(value) {}
+		GlobalInstance(GlobalType inType,UntaggedValue inValue): GCObject(ObjectKind::global), type(inType), localValue(inValue), value(localValue), ownerModule(nullptr) {}
+		GlobalInstance(GlobalType inType,UntaggedValue* inStorage,ModuleInstance* inOwnerModule): GCObject(ObjectKind::global), type(inType), value(*inStorage), ownerModule(inOwnerModule) {}
 	};
 
 	// An instance of a WebAssembly module.
@@ -123,6 +128,11 @@ namespace Runtime
 
 		Uptr startFunctionIndex = UINTPTR_MAX;
 
+		// Storage for the values of the module's global definitions, and a snapshot of their initial values.
+		Uptr numGlobalDefs = 0;
+		std::unique_ptr<UntaggedValue[]> globalDefValues;
+		std::unique_ptr<UntaggedValue[]> globalDefInitialValues;
+
 		ModuleInstance(
 			std::vector<FunctionInstance*>&& inFunctionImports,
 			std::vector<TableInstance*>&& inTableImports,
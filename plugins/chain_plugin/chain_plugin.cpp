@@ -15,6 +15,8 @@
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
 #include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/signature_recovery_cache.hpp>
+#include <eosio/chain/state_prefetcher.hpp>
 
 #include <eosio/chain/eosio_contract.hpp>
 
@@ -110,6 +112,43 @@ void validate(boost::any& v,
   }
 }
 
+std::ostream& operator<<(std::ostream& osm, eosio::chain::huge_pages_mode m) {
+   if ( m == eosio::chain::huge_pages_mode::NONE ) {
+      osm << "none";
+   } else if ( m == eosio::chain::huge_pages_mode::THP ) {
+      osm << "thp";
+   } else if ( m == eosio::chain::huge_pages_mode::HUGETLBFS ) {
+      osm << "hugetlbfs";
+   }
+
+   return osm;
+}
+
+void validate(boost::any& v,
+              const std::vector<std::string>& values,
+              eosio::chain::huge_pages_mode* /* target_type */,
+              int)
+{
+  using namespace boost::program_options;
+
+  // Make sure no previous assignment to 'v' was made.
+  validators::check_first_occurrence(v);
+
+  // Extract the first string from 'values'. If there is more than
+  // one string, it's an error, and exception will be thrown.
+  std::string const& s = validators::get_single_string(values);
+
+  if ( s == "none" ) {
+     v = boost::any(eosio::chain::huge_pages_mode::NONE);
+  } else if ( s == "thp" ) {
+     v = boost::any(eosio::chain::huge_pages_mode::THP);
+  } else if ( s == "hugetlbfs" ) {
+     v = boost::any(eosio::chain::huge_pages_mode::HUGETLBFS);
+  } else {
+     throw validation_error(validation_error::invalid_option_value);
+  }
+}
+
 }
 
 using namespace eosio;
@@ -219,7 +258,19 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("wasm-runtime", bpo::value<eosio::chain::wasm_interface::vm_type>()->value_name("wavm/wabt"), "Override default WASM runtime")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_ms),
           "Override default maximum ABI serialization time allowed in ms")
+         ("signature-cache-size", bpo::value<uint32_t>()->default_value(config::default_signature_cache_size),
+          "Number of recovered public keys kept in the signature recovery cache, 0 disables it")
+         ("state-prefetch", bpo::bool_switch()->default_value(false),
+          "Prefetch the contract table rows transactions are predicted to read from the tables their actions read before")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
+         ("chain-state-db-huge-pages", bpo::value<eosio::chain::huge_pages_mode>()->default_value(eosio::chain::huge_pages_mode::NONE),
+          "Pages backing the chain state database (\"none\", \"thp\" or \"hugetlbfs\").\n"
+          "In \"thp\" mode transparent huge pages are requested, which needs a state directory on tmpfs.\n"
+          "In \"hugetlbfs\" mode the state directory must be a hugetlbfs mount and the state size a multiple of its page size.\n")
+         ("chain-state-db-numa-node", bpo::value<uint32_t>(),
+          "NUMA node the chain state database is preferably allocated on and the chain thread runs on")
+         ("chain-state-db-prefault", bpo::bool_switch()->default_value(false),
+          "Read the whole chain state database into memory at startup, before the node starts syncing")
          ("chain-state-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the chain state database drops below this size (in MiB).")
          ("reversible-blocks-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_cache_size / (1024  * 1024)), "Maximum size (in MiB) of the reversible blocks database")
          ("reversible-blocks-db-guard-size-mb", bpo::value<uint64_t>()->default_value(config::default_reversible_guard_size / (1024  * 1024)), "Safely shut down node when free space remaining in the reverseible blocks database drops below this size (in MiB).")
@@ -403,6 +454,12 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if(options.count("abi-serializer-max-time-ms"))
          my->abi_serializer_max_time_ms = fc::microseconds(options.at("abi-serializer-max-time-ms").as<uint32_t>() * 1000);
 
+      if(options.count("signature-cache-size"))
+         signature_recovery_cache::set_capacity(options.at("signature-cache-size").as<uint32_t>());
+
+      if(options.at("state-prefetch").as<bool>())
+         state_prefetcher::set_enabled(true);
+
       my->chain_config->blocks_dir = my->blocks_dir;
       my->chain_config->state_dir = app().data_dir() / config::default_state_dir_name;
       my->chain_config->read_only = my->readonly;
@@ -410,6 +467,14 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
       if( options.count( "chain-state-db-size-mb" ))
          my->chain_config->state_size = options.at( "chain-state-db-size-mb" ).as<uint64_t>() * 1024 * 1024;
 
+      if( options.count( "chain-state-db-huge-pages" ))
+         my->chain_config->state_mapping.huge_pages = options.at( "chain-state-db-huge-pages" ).as<huge_pages_mode>();
+
+      if( options.count( "chain-state-db-numa-node" ))
+         my->chain_config->state_mapping.numa_node = options.at( "chain-state-db-numa-node" ).as<uint32_t>();
+
+      my->chain_config->state_mapping.prefault = options.at( "chain-state-db-prefault" ).as<bool>();
+
       if( options.count( "chain-state-db-guard-size-mb" ))
          my->chain_config->state_guard_size = options.at( "chain-state-db-guard-size-mb" ).as<uint64_t>() * 1024 * 1024;
 
@@ -543,7 +608,7 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
 
          // recover genesis information from the snapshot
          auto infile = std::ifstream(my->snapshot_path->generic_string(), (std::ios::in | std::ios::binary));
-         auto reader = std::make_shared<istream_snapshot_reader>(infile);
+         auto reader = make_istream_snapshot_reader(infile);
          reader->validate();
          reader->read_section<genesis_state>([this]( auto &section ){
             section.read_row(my->chain_config->genesis);
@@ -692,7 +757,7 @@ void chain_plugin::plugin_startup()
    try {
       if (my->snapshot_path) {
          auto infile = std::ifstream(my->snapshot_path->generic_string(), (std::ios::in | std::ios::binary));
-         auto reader = std::make_shared<istream_snapshot_reader>(infile);
+         auto reader = make_istream_snapshot_reader(infile);
          my->chain->startup(reader);
          infile.close();
       } else {
@@ -1349,6 +1414,14 @@ read_only::get_producer_schedule_result read_only::get_producer_schedule( const
    return result;
 }
 
+read_only::get_signature_cache_stats_results read_only::get_signature_cache_stats( const read_only::get_signature_cache_stats_params& ) const {
+   return signature_recovery_cache::get_stats();
+}
+
+read_only::get_transaction_arena_stats_results read_only::get_transaction_arena_stats( const read_only::get_transaction_arena_stats_params& ) const {
+   return transaction_arena::get_stats();
+}
+
 template<typename Api>
 struct resolver_factory {
    static auto make(const Api* api, const fc::microseconds& max_serialization_time) {
@@ -1536,35 +1609,31 @@ void read_write::push_transaction(const read_write::push_transaction_params& par
    } CATCH_AND_CALL(next);
 }
 
-static void push_recurse(read_write* rw, int index, const std::shared_ptr<read_write::push_transactions_params>& params, const std::shared_ptr<read_write::push_transactions_results>& results, const next_function<read_write::push_transactions_results>& next) {
-   auto wrapped_next = [=](const fc::static_variant<fc::exception_ptr, read_write::push_transaction_results>& result) {
-      if (result.contains<fc::exception_ptr>()) {
-         const auto& e = result.get<fc::exception_ptr>();
-         results->emplace_back( read_write::push_transaction_results{ transaction_id_type(), fc::mutable_variant_object( "error", e->to_detail_string() ) } );
-      } else {
-         const auto& r = result.get<read_write::push_transaction_results>();
-         results->emplace_back( r );
-      }
-
-      int next_index = index + 1;
-      if (next_index < params->size()) {
-         push_recurse(rw, next_index, params, results, next );
-      } else {
-         next(*results);
-      }
-   };
-
-   rw->push_transaction(params->at(index), wrapped_next);
-}
-
 void read_write::push_transactions(const read_write::push_transactions_params& params, next_function<read_write::push_transactions_results> next) {
    try {
       EOS_ASSERT( params.size() <= 1000, too_many_tx_at_once, "Attempt to push too many transactions at once" );
-      auto params_copy = std::make_shared<read_write::push_transactions_params>(params.begin(), params.end());
-      auto result = std::make_shared<read_write::push_transactions_results>();
-      result->reserve(params.size());
+      if( params.empty() ) {
+         next(read_write::push_transactions_results{});
+         return;
+      }
 
-      push_recurse(this, 0, params_copy, result, next);
+      // every transaction is handed to the producer at once rather than the next one from the callback of the
+      // previous, results keep the order of params whatever the order they complete in
+      auto results = std::make_shared<read_write::push_transactions_results>(params.size());
+      auto remaining = std::make_shared<size_t>(params.size());
+      for( size_t index = 0; index < params.size(); ++index ) {
+         push_transaction(params[index], [results, remaining, index, next](const fc::static_variant<fc::exception_ptr, read_write::push_transaction_results>& result) {
+            if (result.contains<fc::exception_ptr>()) {
+               const auto& e = result.get<fc::exception_ptr>();
+               (*results)[index] = read_write::push_transaction_results{ transaction_id_type(), fc::mutable_variant_object( "error", e->to_detail_string() ) };
+            } else {
+               (*results)[index] = result.get<read_write::push_transaction_results>();
+            }
+            if( --*remaining == 0 ) {
+               next(*results);
+            }
+         });
+      }
 
    } CATCH_AND_CALL(next);
 }
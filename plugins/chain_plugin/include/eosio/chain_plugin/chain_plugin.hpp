@@ -12,6 +12,8 @@
 #include <eosio/chain/contract_table_objects.hpp>
 #include <eosio/chain/resource_limits.hpp>
 #include <eosio/chain/transaction.hpp>
+#include <eosio/chain/signature_recovery_cache.hpp>
+#include <eosio/chain/transaction_arena.hpp>
 #include <eosio/chain/abi_serializer.hpp>
 #include <eosio/chain/plugin_interface.hpp>
 #include <eosio/chain/types.hpp>
@@ -346,6 +348,16 @@ public:
 
    get_producer_schedule_result get_producer_schedule( const get_producer_schedule_params& params )const;
 
+   using get_signature_cache_stats_params = empty;
+   using get_signature_cache_stats_results = chain::signature_recovery_cache::stats;
+
+   get_signature_cache_stats_results get_signature_cache_stats( const get_signature_cache_stats_params& params )const;
+
+   using get_transaction_arena_stats_params = empty;
+   using get_transaction_arena_stats_results = chain::transaction_arena::stats;
+
+   get_transaction_arena_stats_results get_transaction_arena_stats( const get_transaction_arena_stats_params& params )const;
+
    struct get_scheduled_transactions_params {
       bool        json = false;
       string      lower_bound;  /// timestamp OR transaction ID
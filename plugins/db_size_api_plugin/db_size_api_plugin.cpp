@@ -5,6 +5,9 @@
 #include <fc/variant.hpp>
 #include <fc/io/json.hpp>
 #include <eosio/db_size_api_plugin/db_size_api_plugin.hpp>
+#include <eosio/chain/table_stats_object.hpp>
+
+#include <algorithm>
 
 namespace eosio {
 
@@ -24,6 +27,9 @@ using namespace eosio;
           } \
        }}
 
+#define INVOKE_R_R(api_handle, call_name, in_param) \
+     auto result = api_handle->call_name(fc::json::from_string(body).as<in_param>());
+
 #define INVOKE_R_V(api_handle, call_name) \
      auto result = api_handle->call_name();
 
@@ -32,6 +38,8 @@ void db_size_api_plugin::plugin_startup() {
    app().get_plugin<http_plugin>().add_api({
        CALL(db_size, this, get,
             INVOKE_R_V(this, get), 200),
+       CALL(db_size, this, get_tables,
+            INVOKE_R_R(this, get_tables, db_size_get_tables_params), 200),
    });
 }
 
@@ -50,6 +58,49 @@ db_size_stats db_size_api_plugin::get() {
    return ret;
 }
 
+db_size_get_tables_results db_size_api_plugin::get_tables(const db_size_get_tables_params& params) {
+   using chain::table_stats_object;
+   using chain::table_stats_index;
+   using chain::by_code_table;
+
+   const chainbase::database& db = app().get_plugin<chain_plugin>().chain().db();
+   const auto& idx = db.get_index<table_stats_index, by_code_table>();
+
+   vector<const table_stats_object*> tables;
+   auto itr = params.code ? idx.lower_bound(boost::make_tuple(*params.code)) : idx.begin();
+   auto end = params.code ? idx.upper_bound(boost::make_tuple(*params.code)) : idx.end();
+   for( ; itr != end; ++itr ) {
+      tables.push_back(&*itr);
+   }
+
+   auto sort_desc = [&tables]( uint64_t table_stats_object::*field ) {
+      std::stable_sort(tables.begin(), tables.end(), [field]( const table_stats_object* a, const table_stats_object* b ) {
+         return a->*field > b->*field;
+      });
+   };
+   if( params.sort_by == "ram_bytes" ) {
+      sort_desc(&table_stats_object::ram_bytes);
+   } else if( params.sort_by == "payload_bytes" ) {
+      sort_desc(&table_stats_object::payload_bytes);
+   } else if( params.sort_by == "rows" ) {
+      sort_desc(&table_stats_object::rows);
+   } else if( params.sort_by == "secondary_rows" ) {
+      sort_desc(&table_stats_object::secondary_rows);
+   } else {
+      EOS_ASSERT( params.sort_by == "table", chain::contract_table_query_exception, "Invalid sort_by: ${s}", ("s", params.sort_by) );
+   }
+
+   db_size_get_tables_results ret;
+   ret.total = tables.size();
+   for( size_t i = params.offset; i < tables.size() && ret.tables.size() < params.limit; ++i ) {
+      const auto& t = *tables[i];
+      ret.tables.emplace_back(db_size_table_stats{t.code, t.table, t.rows, t.secondary_rows, t.payload_bytes, t.ram_bytes});
+   }
+   ret.more = (size_t)params.offset + ret.tables.size() < tables.size();
+   return ret;
+}
+
+#undef INVOKE_R_R
 #undef INVOKE_R_V
 #undef CALL
 
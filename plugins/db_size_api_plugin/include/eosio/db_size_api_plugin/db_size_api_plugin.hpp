@@ -25,6 +25,28 @@ struct db_size_stats {
    vector<db_size_index_count> indices;
 };
 
+struct db_size_table_stats {
+   name     code;
+   name     table;
+   uint64_t rows = 0;
+   uint64_t secondary_rows = 0;
+   uint64_t payload_bytes = 0;
+   uint64_t ram_bytes = 0;
+};
+
+struct db_size_get_tables_params {
+   optional<name> code;                 ///< only the tables of this contract
+   string         sort_by = "ram_bytes"; ///< ram_bytes, payload_bytes, rows, secondary_rows or table
+   uint32_t       offset = 0;
+   uint32_t       limit = 50;
+};
+
+struct db_size_get_tables_results {
+   vector<db_size_table_stats> tables;
+   uint32_t                    total = 0; ///< number of tables matching the params
+   bool                        more = false;
+};
+
 class db_size_api_plugin : public plugin<db_size_api_plugin> {
 public:
    APPBASE_PLUGIN_REQUIRES((http_plugin) (chain_plugin))
@@ -42,6 +64,7 @@ public:
    void plugin_shutdown() {}
 
    db_size_stats get();
+   db_size_get_tables_results get_tables(const db_size_get_tables_params& params);
 
 private:
 };
@@ -49,4 +72,7 @@ private:
 }
 
 FC_REFLECT( eosio::db_size_index_count, (index)(row_count) )
-FC_REFLECT( eosio::db_size_stats, (free_bytes)(used_bytes)(size)(indices) )
\ No newline at end of file
+FC_REFLECT( eosio::db_size_stats, (free_bytes)(used_bytes)(size)(indices) )
+FC_REFLECT( eosio::db_size_table_stats, (code)(table)(rows)(secondary_rows)(payload_bytes)(ram_bytes) )
+FC_REFLECT( eosio::db_size_get_tables_params, (code)(sort_by)(offset)(limit) )
+FC_REFLECT( eosio::db_size_get_tables_results, (tables)(total)(more) )
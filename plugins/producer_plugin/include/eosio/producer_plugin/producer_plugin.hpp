@@ -50,6 +50,18 @@ public:
       std::string          snapshot_name;
    };
 
+   struct live_snapshot_status {
+      std::string          state = "idle";  ///< idle, writing, done or failed
+      chain::block_id_type head_block_id;
+      std::string          snapshot_name;
+      uint32_t             pin_time_ms = 0; ///< time the chain was held while the state was pinned
+      uint64_t             rows_written = 0;
+      uint64_t             rows_total = 0;
+      uint32_t             elapsed_ms = 0;
+      uint32_t             eta_ms = 0;
+      std::string          error;
+   };
+
    producer_plugin();
 
    virtual int produce_block(){return 0;};
@@ -85,6 +97,8 @@ public:
 
    integrity_hash_information get_integrity_hash() const;
    snapshot_information create_snapshot() const;
+   live_snapshot_status create_live_snapshot() const;
+   live_snapshot_status get_live_snapshot_status() const;
 
    signal<void(const chain::producer_confirmation&)> confirmed_block;
 private:
@@ -98,4 +112,6 @@ FC_REFLECT(eosio::producer_plugin::greylist_params, (accounts));
 FC_REFLECT(eosio::producer_plugin::whitelist_blacklist, (actor_whitelist)(actor_blacklist)(contract_whitelist)(contract_blacklist)(action_blacklist)(key_blacklist) )
 FC_REFLECT(eosio::producer_plugin::integrity_hash_information, (head_block_id)(integrity_hash))
 FC_REFLECT(eosio::producer_plugin::snapshot_information, (head_block_id)(snapshot_name))
+FC_REFLECT(eosio::producer_plugin::live_snapshot_status, (state)(head_block_id)(snapshot_name)(pin_time_ms)
+           (rows_written)(rows_total)(elapsed_ms)(eta_ms)(error))
 
@@ -18,6 +18,8 @@
 
 #include <iostream>
 #include <algorithm>
+#include <thread>
+#include <mutex>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/function_output_iterator.hpp>
@@ -189,6 +191,13 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       // path to write the snapshots to
       bfs::path _snapshots_dir;
 
+      // live snapshots are written from a pinned copy of the state on their own thread
+      std::thread                                      _live_snapshot_thread;
+      mutable std::mutex                               _live_snapshot_mutex;
+      producer_plugin::live_snapshot_status            _live_snapshot_status;
+      std::shared_ptr<chunked_ostream_snapshot_writer> _live_snapshot_writer;
+      fc::time_point                                   _live_snapshot_start;
+
 
       void on_block( const block_state_ptr& bsp ) {
          if( bsp->header.timestamp <= _last_signed_block_time ) return;
@@ -780,6 +789,11 @@ void producer_plugin::plugin_shutdown() {
 
    my->_accepted_block_connection.reset();
    my->_irreversible_block_connection.reset();
+
+   if (my->_live_snapshot_thread.joinable()) {
+      ilog("waiting for the live snapshot to finish");
+      my->_live_snapshot_thread.join();
+   }
 }
 
 void producer_plugin::pause() {
@@ -933,7 +947,7 @@ producer_plugin::snapshot_information producer_plugin::create_snapshot() const {
 
 
    auto snap_out = std::ofstream(snapshot_path, (std::ios::out | std::ios::binary));
-   auto writer = std::make_shared<ostream_snapshot_writer>(snap_out);
+   auto writer = std::make_shared<chunked_ostream_snapshot_writer>(snap_out);
    chain.write_snapshot(writer);
    writer->finalize();
    snap_out.flush();
@@ -942,6 +956,105 @@ producer_plugin::snapshot_information producer_plugin::create_snapshot() const {
    return {head_id, snapshot_path};
 }
 
+producer_plugin::live_snapshot_status producer_plugin::create_live_snapshot() const {
+   chain::controller& chain = app().get_plugin<chain_plugin>().chain();
+
+   {
+      std::lock_guard<std::mutex> g(my->_live_snapshot_mutex);
+      EOS_ASSERT( my->_live_snapshot_status.state != "writing", snapshot_exception,
+                  "live snapshot ${name} is still being written", ("name", my->_live_snapshot_status.snapshot_name));
+   }
+   if (my->_live_snapshot_thread.joinable()) {
+      my->_live_snapshot_thread.join();
+   }
+
+   auto reschedule = fc::make_scoped_exit([this](){
+      my->schedule_production_loop();
+   });
+
+   if (chain.pending_block_state()) {
+      // abort the pending block
+      chain.abort_block();
+   } else {
+      reschedule.cancel();
+   }
+
+   auto head_id = chain.head_block_id();
+   std::string snapshot_path = (my->_snapshots_dir / fc::format_string("snapshot-${id}.bin", fc::mutable_variant_object()("id", head_id))).generic_string();
+
+   EOS_ASSERT( !fc::is_regular_file(snapshot_path), snapshot_exists_exception,
+               "snapshot named ${name} already exists", ("name", snapshot_path));
+
+   // the chain is only held while the state is pinned, the snapshot itself is written from the copy
+   auto start = fc::time_point::now();
+   auto pin = chain.pin_state(my->_snapshots_dir / fc::format_string("live-state-${id}", fc::mutable_variant_object()("id", head_id)));
+   auto pinned = fc::time_point::now();
+
+   auto writer_out = std::make_shared<std::ofstream>(snapshot_path + ".incomplete", (std::ios::out | std::ios::binary));
+   auto writer = std::make_shared<chunked_ostream_snapshot_writer>(*writer_out);
+
+   {
+      std::lock_guard<std::mutex> g(my->_live_snapshot_mutex);
+      my->_live_snapshot_status = live_snapshot_status();
+      my->_live_snapshot_status.state = "writing";
+      my->_live_snapshot_status.head_block_id = head_id;
+      my->_live_snapshot_status.snapshot_name = snapshot_path;
+      my->_live_snapshot_status.pin_time_ms = (pinned - start).count() / 1000;
+      my->_live_snapshot_status.rows_total = pin.row_count;
+      my->_live_snapshot_writer = writer;
+      my->_live_snapshot_start = pinned;
+   }
+
+   my->_live_snapshot_thread = std::thread([my = my, &chain, pin, writer, writer_out, snapshot_path]() {
+      std::string error;
+      try {
+         chain.write_snapshot(pin, writer);
+         writer->finalize();
+         writer_out->flush();
+         writer_out->close();
+         fc::rename(snapshot_path + ".incomplete", snapshot_path);
+      } catch (const fc::exception& e) {
+         error = e.to_detail_string();
+      } catch (const std::exception& e) {
+         error = e.what();
+      } catch (...) {
+         error = "unknown exception";
+      }
+
+      fc::remove_all(pin.state_dir);
+      if (!error.empty()) {
+         fc::remove(snapshot_path + ".incomplete");
+         elog("live snapshot ${name} failed: ${e}", ("name", snapshot_path)("e", error));
+      } else {
+         ilog("live snapshot ${name} written", ("name", snapshot_path));
+      }
+
+      std::lock_guard<std::mutex> g(my->_live_snapshot_mutex);
+      my->_live_snapshot_status.state = error.empty() ? "done" : "failed";
+      my->_live_snapshot_status.rows_written = writer->rows_written();
+      my->_live_snapshot_status.elapsed_ms = (fc::time_point::now() - my->_live_snapshot_start).count() / 1000;
+      my->_live_snapshot_status.error = error;
+      my->_live_snapshot_writer.reset();
+   });
+
+   return get_live_snapshot_status();
+}
+
+producer_plugin::live_snapshot_status producer_plugin::get_live_snapshot_status() const {
+   std::lock_guard<std::mutex> g(my->_live_snapshot_mutex);
+   auto status = my->_live_snapshot_status;
+   if (my->_live_snapshot_writer) {
+      status.rows_written = my->_live_snapshot_writer->rows_written();
+      status.elapsed_ms = (fc::time_point::now() - my->_live_snapshot_start).count() / 1000;
+
+      // rows_total only counts chain and contract table rows, stop estimating once it is passed
+      if (status.rows_written > 0 && status.rows_written < status.rows_total) {
+         status.eta_ms = uint64_t(status.elapsed_ms) * (status.rows_total - status.rows_written) / status.rows_written;
+      }
+   }
+   return status;
+}
+
 optional<fc::time_point> producer_plugin_impl::calculate_next_block_time(const account_name& producer_name, const block_timestamp_type& current_block_time) const {
    chain::controller& chain = app().get_plugin<chain_plugin>().chain();
    const auto& hbs = chain.head_block_state();
@@ -0,0 +1,87 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+
+#include <eosio/http_plugin/http_plugin.hpp>
+#include <eosio/chain_plugin/chain_plugin.hpp>
+
+#include <appbase/application.hpp>
+
+namespace eosio {
+
+using namespace appbase;
+
+/// durations are in nanoseconds, percentiles are accurate to 12.5%
+struct profiler_histogram {
+   uint64_t count = 0;
+   uint64_t sum = 0;
+   uint64_t p50 = 0;
+   uint64_t p90 = 0;
+   uint64_t p99 = 0;
+   uint64_t max = 0;
+};
+
+struct profiler_action_stats {
+   name               receiver;
+   name               action;
+   int                vm_type = 0;
+   profiler_histogram wall_ns;
+   profiler_histogram cpu_ns;
+   profiler_histogram load_ns;
+   profiler_histogram instantiate_ns;
+   profiler_histogram execute_ns;
+   profiler_histogram db_ns;
+   profiler_histogram db_calls;
+};
+
+struct profiler_get_params {
+   optional<name> receiver;
+   uint32_t       limit = 50;
+};
+
+struct profiler_get_results {
+   bool                          enabled = false;
+   vector<profiler_action_stats> actions; ///< sorted by total wall time, highest first
+};
+
+struct profiler_enable_params {
+   bool enabled = true;
+};
+
+struct profiler_enable_results {
+   bool enabled = false;
+};
+
+class profiler_api_plugin : public plugin<profiler_api_plugin> {
+public:
+   APPBASE_PLUGIN_REQUIRES((http_plugin) (chain_plugin))
+
+   profiler_api_plugin() = default;
+   profiler_api_plugin(const profiler_api_plugin&) = delete;
+   profiler_api_plugin(profiler_api_plugin&&) = delete;
+   profiler_api_plugin& operator=(const profiler_api_plugin&) = delete;
+   profiler_api_plugin& operator=(profiler_api_plugin&&) = delete;
+   virtual ~profiler_api_plugin() override = default;
+
+   virtual void set_program_options(options_description& cli, options_description& cfg) override;
+   void plugin_initialize(const variables_map& vm);
+   void plugin_startup();
+   void plugin_shutdown() {}
+
+   profiler_get_results get(const profiler_get_params& params);
+   profiler_enable_results enable(const profiler_enable_params& params);
+   profiler_enable_results reset();
+
+private:
+};
+
+}
+
+FC_REFLECT( eosio::profiler_histogram, (count)(sum)(p50)(p90)(p99)(max) )
+FC_REFLECT( eosio::profiler_action_stats, (receiver)(action)(vm_type)(wall_ns)(cpu_ns)(load_ns)(instantiate_ns)(execute_ns)(db_ns)(db_calls) )
+FC_REFLECT( eosio::profiler_get_params, (receiver)(limit) )
+FC_REFLECT( eosio::profiler_get_results, (enabled)(actions) )
+FC_REFLECT( eosio::profiler_enable_params, (enabled) )
+FC_REFLECT( eosio::profiler_enable_results, (enabled) )
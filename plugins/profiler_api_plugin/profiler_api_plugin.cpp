@@ -0,0 +1,130 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <fc/variant.hpp>
+#include <fc/io/json.hpp>
+#include <eosio/profiler_api_plugin/profiler_api_plugin.hpp>
+
+#include <apply_profiler.hpp>
+
+#include <algorithm>
+
+namespace eosio {
+
+static appbase::abstract_plugin& _profiler_api_plugin = app().register_plugin<profiler_api_plugin>();
+
+using namespace eosio;
+using chain::apply_profiler;
+using chain::latency_histogram;
+
+#define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string, string body, url_response_callback cb) mutable { \
+          try { \
+             if (body.empty()) body = "{}"; \
+             INVOKE \
+             cb(http_response_code, fc::json::to_string(result)); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+#define INVOKE_R_R(api_handle, call_name, in_param) \
+     auto result = api_handle->call_name(fc::json::from_string(body).as<in_param>());
+
+#define INVOKE_R_V(api_handle, call_name) \
+     auto result = api_handle->call_name();
+
+
+void profiler_api_plugin::set_program_options(options_description& cli, options_description& cfg) {
+   cfg.add_options()
+         ("profile-actions", bpo::bool_switch()->default_value(false),
+          "Collect per contract and action execution time histograms from startup, they can also be switched on with /v1/profiler/enable")
+         ;
+}
+
+void profiler_api_plugin::plugin_initialize(const variables_map& options) {
+   apply_profiler::get().enable(options.at("profile-actions").as<bool>());
+}
+
+void profiler_api_plugin::plugin_startup() {
+   app().get_plugin<http_plugin>().add_api({
+       CALL(profiler, this, get,
+            INVOKE_R_R(this, get, profiler_get_params), 200),
+       CALL(profiler, this, enable,
+            INVOKE_R_R(this, enable, profiler_enable_params), 200),
+       CALL(profiler, this, reset,
+            INVOKE_R_V(this, reset), 200),
+   });
+}
+
+static profiler_histogram summarize(const latency_histogram& h) {
+   profiler_histogram ret;
+   ret.count = h.count();
+   ret.sum = h.sum();
+   ret.p50 = h.percentile(50);
+   ret.p90 = h.percentile(90);
+   ret.p99 = h.percentile(99);
+   ret.max = h.max();
+   return ret;
+}
+
+profiler_get_results profiler_api_plugin::get(const profiler_get_params& params) {
+   profiler_get_results ret;
+   ret.enabled = apply_profiler::get().enabled();
+
+   auto profiles = apply_profiler::get().get_profiles();
+   if (params.receiver) {
+      auto receiver = params.receiver->value;
+      profiles.erase(std::remove_if(profiles.begin(), profiles.end(), [&](const chain::action_profile& p) {
+         return p.receiver != receiver;
+      }), profiles.end());
+   }
+   std::sort(profiles.begin(), profiles.end(), [](const chain::action_profile& a, const chain::action_profile& b) {
+      return a.wall_ns.sum() > b.wall_ns.sum();
+   });
+   if (profiles.size() > params.limit) {
+      profiles.resize(params.limit);
+   }
+
+   for (const auto& p : profiles) {
+      profiler_action_stats stats;
+      stats.receiver = name(p.receiver);
+      stats.action = name(p.act);
+      stats.vm_type = p.vm_type;
+      stats.wall_ns = summarize(p.wall_ns);
+      stats.cpu_ns = summarize(p.cpu_ns);
+      stats.load_ns = summarize(p.phase_ns[chain::profile_load]);
+      stats.instantiate_ns = summarize(p.phase_ns[chain::profile_instantiate]);
+      stats.execute_ns = summarize(p.phase_ns[chain::profile_execute]);
+      stats.db_ns = summarize(p.phase_ns[chain::profile_db]);
+      stats.db_calls = summarize(p.db_calls);
+      ret.actions.emplace_back(std::move(stats));
+   }
+   return ret;
+}
+
+profiler_enable_results profiler_api_plugin::enable(const profiler_enable_params& params) {
+   apply_profiler::get().enable(params.enabled);
+   return profiler_enable_results{apply_profiler::get().enabled()};
+}
+
+profiler_enable_results profiler_api_plugin::reset() {
+   apply_profiler::get().reset();
+   return profiler_enable_results{apply_profiler::get().enabled()};
+}
+
+#undef INVOKE_R_V
+#undef INVOKE_R_R
+#undef CALL
+
+}
+
+extern "C" void plugin_init(appbase::application* app) {
+   app->register_plugin<eosio::profiler_api_plugin>();
+}
+
+extern "C" void plugin_deinit() {
+
+}
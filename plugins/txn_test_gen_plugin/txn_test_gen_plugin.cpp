@@ -3,6 +3,7 @@
  *  @copyright defined in eos/LICENSE.txt
  */
 #include <eosio/txn_test_gen_plugin/txn_test_gen_plugin.hpp>
+#include <latency_histogram.hpp>
 #include <eosio/chain_plugin/chain_plugin.hpp>
 #include <eosio/chain/wast_to_wasm.hpp>
 #include <eosio/utilities/key_conversion.hpp>
@@ -14,6 +15,7 @@
 #include <fc/io/json.hpp>
 
 #include <boost/asio/high_resolution_timer.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/algorithm/clamp.hpp>
 
 #include <Inline/BasicTypes.h>
@@ -26,17 +28,56 @@
 #include <eosio.token/eosio.token.wast.hpp>
 #include <eosio.token/eosio.token.abi.hpp>
 
+#include <random>
+#include <unordered_map>
+
 namespace eosio { namespace detail {
   struct txn_test_gen_empty {};
+
+  /// an action of a workload mix, picked with a probability of weight over the sum of the weights
+  struct workload_action {
+     uint32_t                          weight = 1;
+     chain::account_name               account;
+     chain::action_name                name;
+     vector<chain::permission_level>   authorization;
+     fc::variant                       data;      ///< arguments, packed with the abi of account
+     chain::bytes                      hex_data;  ///< packed arguments, for contracts without an abi
+     vector<string>                    keys;      ///< signing keys, those of the txn.test accounts if empty
+  };
+
+  struct workload {
+     double                   rate = 1000;                 ///< mean transactions per second
+     uint32_t                 duration = 0;                ///< seconds, 0 runs until stop_workload
+     uint32_t                 actions_per_transaction = 1;
+     uint64_t                 seed = 0;                    ///< 0 seeds from the clock
+     vector<workload_action>  actions;
+  };
+
+  struct workload_stats {
+     bool                    running = false;
+     double                  elapsed = 0;         ///< seconds
+     uint64_t                submitted = 0;
+     uint64_t                failed = 0;
+     uint64_t                traced = 0;
+     uint64_t                irreversible = 0;
+     uint64_t                expired = 0;         ///< traced but not irreversible in time
+     uint64_t                pending = 0;
+     chain::latency_summary  submit_to_trace;         ///< microseconds
+     chain::latency_summary  submit_to_irreversible;  ///< microseconds
+  };
 }}
 
 FC_REFLECT(eosio::detail::txn_test_gen_empty, );
+FC_REFLECT(eosio::detail::workload_action, (weight)(account)(name)(authorization)(data)(hex_data)(keys));
+FC_REFLECT(eosio::detail::workload, (rate)(duration)(actions_per_transaction)(seed)(actions));
+FC_REFLECT(eosio::detail::workload_stats, (running)(elapsed)(submitted)(failed)(traced)(irreversible)(expired)(pending)(submit_to_trace)(submit_to_irreversible));
 
 namespace eosio {
 
 static appbase::abstract_plugin& _txn_test_gen_plugin = app().register_plugin<txn_test_gen_plugin>();
 
 using namespace eosio::chain;
+using namespace eosio::chain::plugin_interface;
 
 #define CALL(api_name, api_handle, call_name, INVOKE, http_response_code) \
 {std::string("/v1/" #api_name "/" #call_name), \
@@ -64,6 +105,14 @@ using namespace eosio::chain;
      api_handle->call_name(); \
      eosio::detail::txn_test_gen_empty result;
 
+#define INVOKE_V_R(api_handle, call_name, in_param0) \
+     const auto& vs = fc::json::json::from_string(body).as<fc::variants>(); \
+     api_handle->call_name(vs.at(0).as<in_param0>()); \
+     eosio::detail::txn_test_gen_empty result;
+
+#define INVOKE_R_V(api_handle, call_name) \
+     auto result = api_handle->call_name();
+
 #define CALL_ASYNC(api_name, api_handle, call_name, INVOKE, http_response_code) \
 {std::string("/v1/" #api_name "/" #call_name), \
    [this](string, string body, url_response_callback cb) mutable { \
@@ -304,17 +353,7 @@ struct txn_test_gen_plugin_impl {
          static uint64_t nonce = static_cast<uint64_t>(fc::time_point::now().sec_since_epoch()) << 32;
          abi_serializer eosio_serializer(cc.db().find<account_object, by_name>(config::system_account_name)->get_abi(), abi_serializer_max_time);
 
-         uint32_t reference_block_num = cc.last_irreversible_block_num();
-         if (txn_reference_block_lag >= 0) {
-            reference_block_num = cc.head_block_num();
-            if (reference_block_num <= (uint32_t)txn_reference_block_lag) {
-               reference_block_num = 0;
-            } else {
-               reference_block_num -= (uint32_t)txn_reference_block_lag;
-            }
-         }
-
-         block_id_type reference_block_id = cc.get_block_id_for_num(reference_block_num);
+         block_id_type reference_block_id = get_reference_block_id(cc);
 
          for(unsigned int i = 0; i < batch; ++i) {
          {
@@ -354,6 +393,240 @@ struct txn_test_gen_plugin_impl {
       ilog("Stopping transaction generation test");
    }
 
+   block_id_type get_reference_block_id(controller& cc)const {
+      uint32_t reference_block_num = cc.last_irreversible_block_num();
+      if (txn_reference_block_lag >= 0) {
+         reference_block_num = cc.head_block_num();
+         if (reference_block_num <= (uint32_t)txn_reference_block_lag) {
+            reference_block_num = 0;
+         } else {
+            reference_block_num -= (uint32_t)txn_reference_block_lag;
+         }
+      }
+      return cc.get_block_id_for_num(reference_block_num);
+   }
+
+   /**
+    * Open loop workload: transactions arrive as a Poisson process of the configured rate whatever the progress
+    * of the node, each made of actions drawn from a weighted mix. Latencies are measured from the scheduled
+    * arrival rather than from the actual submission, so that a node falling behind shows in the numbers
+    * instead of slowing the load down.
+    */
+   void start_workload(const detail::workload& w) {
+      if(workload_running)
+         throw fc::exception(fc::invalid_operation_exception_code);
+      FC_ASSERT(w.rate > 0 && w.rate <= 1000000, "rate of ${r} transactions per second is out of range", ("r", w.rate));
+      FC_ASSERT(w.actions_per_transaction >= 1 && w.actions_per_transaction <= 100, "${n} actions per transaction is out of range", ("n", w.actions_per_transaction));
+      FC_ASSERT(!w.actions.empty(), "the workload has no actions");
+
+      controller& cc = app().get_plugin<chain_plugin>().chain();
+      auto abi_serializer_max_time = app().get_plugin<chain_plugin>().get_abi_serializer_max_time();
+
+      std::map<account_name, fc::crypto::private_key> test_keys;
+      test_keys.emplace(N(txn.test.a), fc::crypto::private_key::regenerate(fc::sha256(std::string(64, 'a'))));
+      test_keys.emplace(N(txn.test.b), fc::crypto::private_key::regenerate(fc::sha256(std::string(64, 'b'))));
+      test_keys.emplace(N(txn.test.t), fc::crypto::private_key::regenerate(fc::sha256(std::string(64, 'c'))));
+
+      std::map<account_name, abi_serializer> serializers;
+      vector<prepared_action> mix;
+      vector<fc::crypto::private_key> keys;
+      // an action refers to its keys by index, the actions of a transaction sharing a key sign it once
+      auto key_index = [&](const fc::crypto::private_key& k) {
+         auto pub = k.get_public_key();
+         for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i].get_public_key() == pub)
+               return i;
+         }
+         keys.push_back(k);
+         return keys.size() - 1;
+      };
+      vector<double> weights;
+      for (const auto& wa : w.actions) {
+         FC_ASSERT(wa.weight > 0, "the weight of ${n} of ${a} must be positive", ("n", wa.name)("a", wa.account));
+         prepared_action pa;
+         pa.act.account = wa.account;
+         pa.act.name = wa.name;
+         pa.act.authorization = wa.authorization;
+         if (wa.data.is_null()) {
+            pa.act.data = wa.hex_data;
+         } else {
+            auto itr = serializers.find(wa.account);
+            if (itr == serializers.end()) {
+               const auto* account = cc.db().find<account_object, by_name>(wa.account);
+               FC_ASSERT(account, "account ${a} does not exist", ("a", wa.account));
+               abi_def abi;
+               FC_ASSERT(abi_serializer::to_abi(account->abi, abi), "account ${a} has no abi to pack the data of ${n} with, use hex_data", ("a", wa.account)("n", wa.name));
+               itr = serializers.emplace(wa.account, abi_serializer(abi, abi_serializer_max_time)).first;
+            }
+            pa.act.data = itr->second.variant_to_binary(itr->second.get_action_type(wa.name), wa.data, abi_serializer_max_time);
+         }
+         for (const auto& k : wa.keys) {
+            pa.keys.push_back(key_index(fc::crypto::private_key(k)));
+         }
+         if (pa.keys.empty()) {
+            for (const auto& auth : wa.authorization) {
+               auto itr = test_keys.find(auth.actor);
+               if (itr != test_keys.end()) {
+                  pa.keys.push_back(key_index(itr->second));
+               }
+            }
+         }
+         FC_ASSERT(!pa.keys.empty() || wa.authorization.empty(), "no key to sign ${n} of ${a} with", ("n", wa.name)("a", wa.account));
+         mix.emplace_back(std::move(pa));
+         weights.push_back(wa.weight);
+      }
+
+      workload_mix = std::move(mix);
+      workload_keys = std::move(keys);
+      pick_action = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+      interarrival = std::exponential_distribution<double>(w.rate);
+      workload_rng.seed(w.seed ? w.seed : static_cast<uint64_t>(fc::time_point::now().time_since_epoch().count()));
+      actions_per_transaction = w.actions_per_transaction;
+
+      ++workload_generation;
+      pending_trxs.clear();
+      trace_latency.reset();
+      irreversible_latency.reset();
+      stats = detail::workload_stats();
+      workload_start = workload_clock::now();
+      last_expiry = workload_start;
+      next_arrival = workload_start;
+      workload_end = w.duration ? workload_start + std::chrono::seconds(w.duration) : workload_clock::time_point::max();
+      workload_running = true;
+
+      ilog("Started open loop workload of ${r} transactions per second over ${n} actions", ("r", w.rate)("n", w.actions.size()));
+      arm_workload_timer();
+   }
+
+   void arm_workload_timer() {
+      workload_timer.expires_at(next_arrival);
+      workload_timer.async_wait([this](const boost::system::error_code& ec) {
+         if(!workload_running || ec)
+            return;
+         submit_due_transactions();
+      });
+   }
+
+   void submit_due_transactions() {
+      auto now = workload_clock::now();
+      try {
+         controller& cc = app().get_plugin<chain_plugin>().chain();
+         block_id_type reference_block_id = get_reference_block_id(cc);
+         // arrivals running late are all sent, in bursts bounded so that blocks get produced in between
+         for (uint32_t burst = 0; next_arrival <= now && burst < max_workload_burst; ++burst) {
+            if (next_arrival >= workload_end) {
+               end_workload();
+               return;
+            }
+            submit_workload_transaction(cc, reference_block_id, next_arrival);
+            next_arrival += std::chrono::duration_cast<workload_clock::duration>(std::chrono::duration<double>(interarrival(workload_rng)));
+         }
+      } catch (const fc::exception& e) {
+         elog("pushing workload transaction failed: ${e}", ("e", e.to_detail_string()));
+         end_workload();
+         return;
+      }
+
+      if (now - last_expiry >= std::chrono::seconds(1)) {
+         expire_pending(now);
+         last_expiry = now;
+      }
+      arm_workload_timer();
+   }
+
+   void submit_workload_transaction(controller& cc, const block_id_type& reference_block_id, workload_clock::time_point arrival) {
+      signed_transaction trx;
+      vector<size_t> signers;
+      for (uint32_t i = 0; i < actions_per_transaction; ++i) {
+         const auto& pa = workload_mix[pick_action(workload_rng)];
+         trx.actions.push_back(pa.act);
+         for (auto k : pa.keys) {
+            if (std::find(signers.begin(), signers.end(), k) == signers.end())
+               signers.push_back(k);
+         }
+      }
+      trx.context_free_actions.emplace_back(action({}, config::null_account_name, "nonce", fc::raw::pack(workload_nonce++)));
+      trx.set_reference_block(reference_block_id);
+      trx.expiration = cc.head_block_time() + fc::seconds(30);
+      auto chainid = app().get_plugin<chain_plugin>().get_chain_id();
+      for (auto k : signers) {
+         trx.sign(workload_keys[k], chainid);
+      }
+
+      auto id = trx.id();
+      pending_trxs[id] = pending_transaction{arrival, false};
+      ++stats.submitted;
+      auto generation = workload_generation;
+      app().get_plugin<chain_plugin>().accept_transaction(packed_transaction(trx), [this, id, generation](const fc::static_variant<fc::exception_ptr, transaction_trace_ptr>& result) {
+         if (generation != workload_generation)
+            return;
+         auto itr = pending_trxs.find(id);
+         if (itr == pending_trxs.end())
+            return;
+         if (result.contains<fc::exception_ptr>() || result.get<transaction_trace_ptr>()->except) {
+            ++stats.failed;
+            pending_trxs.erase(itr);
+            return;
+         }
+         trace_latency.record(std::chrono::duration_cast<std::chrono::microseconds>(workload_clock::now() - itr->second.arrival).count());
+         itr->second.traced = true;
+         ++stats.traced;
+      });
+   }
+
+   void on_irreversible_block(const block_state_ptr& bs) {
+      if (pending_trxs.empty() || !bs->block)
+         return;
+      auto now = workload_clock::now();
+      for (const auto& receipt : bs->block->transactions) {
+         auto id = receipt.trx.contains<transaction_id_type>() ? receipt.trx.get<transaction_id_type>() : receipt.trx.get<packed_transaction>().id();
+         auto itr = pending_trxs.find(id);
+         if (itr == pending_trxs.end())
+            continue;
+         irreversible_latency.record(std::chrono::duration_cast<std::chrono::microseconds>(now - itr->second.arrival).count());
+         ++stats.irreversible;
+         pending_trxs.erase(itr);
+      }
+   }
+
+   /// transactions that did not become irreversible in time are no longer waited for
+   void expire_pending(workload_clock::time_point now) {
+      for (auto itr = pending_trxs.begin(); itr != pending_trxs.end(); ) {
+         if (now - itr->second.arrival > irreversible_timeout) {
+            ++stats.expired;
+            itr = pending_trxs.erase(itr);
+         } else {
+            ++itr;
+         }
+      }
+   }
+
+   void end_workload() {
+      workload_timer.cancel();
+      workload_running = false;
+      workload_stopped = workload_clock::now();
+      ilog("Stopping open loop workload, ${n} transactions submitted", ("n", stats.submitted));
+   }
+
+   void stop_workload() {
+      if(!workload_running)
+         throw fc::exception(fc::invalid_operation_exception_code);
+      end_workload();
+   }
+
+   detail::workload_stats get_workload_stats() {
+      auto now = workload_clock::now();
+      if (stats.submitted)
+         expire_pending(now);
+      detail::workload_stats result = stats;
+      result.running = workload_running;
+      result.elapsed = std::chrono::duration<double>((workload_running ? now : workload_stopped) - workload_start).count();
+      result.pending = pending_trxs.size();
+      result.submit_to_trace = trace_latency.summary();
+      result.submit_to_irreversible = irreversible_latency.summary();
+      return result;
+   }
+
    boost::asio::high_resolution_timer timer{app().get_io_service()};
    bool running{false};
 
@@ -364,8 +637,51 @@ struct txn_test_gen_plugin_impl {
    action act_b_to_a;
 
    int32_t txn_reference_block_lag;
+
+   using workload_clock = std::chrono::steady_clock;
+
+   struct prepared_action {
+      action          act;
+      vector<size_t>  keys; ///< in workload_keys
+   };
+
+   struct pending_transaction {
+      workload_clock::time_point arrival;
+      bool                       traced;
+   };
+
+   static constexpr uint32_t max_workload_burst = 1000;
+   static constexpr std::chrono::minutes irreversible_timeout{10};
+
+   boost::asio::steady_timer workload_timer{app().get_io_service()};
+   bool workload_running{false};
+   uint64_t workload_generation{0};
+   uint64_t workload_nonce{static_cast<uint64_t>(fc::time_point::now().sec_since_epoch()) << 32};
+
+   vector<prepared_action> workload_mix;
+   vector<fc::crypto::private_key> workload_keys;
+   std::discrete_distribution<size_t> pick_action;
+   std::exponential_distribution<double> interarrival;
+   std::mt19937_64 workload_rng;
+   uint32_t actions_per_transaction{1};
+
+   workload_clock::time_point workload_start;
+   workload_clock::time_point workload_stopped;
+   workload_clock::time_point workload_end;
+   workload_clock::time_point next_arrival;
+   workload_clock::time_point last_expiry;
+
+   std::unordered_map<transaction_id_type, pending_transaction> pending_trxs;
+   // microseconds up to an hour, within 1%
+   latency_histogram trace_latency{3600ull * 1000 * 1000, 8};
+   latency_histogram irreversible_latency{3600ull * 1000 * 1000, 8};
+   detail::workload_stats stats;
+
+   channels::irreversible_block::channel_type::handle irreversible_block_subscription;
 };
 
+constexpr std::chrono::minutes txn_test_gen_plugin_impl::irreversible_timeout;
+
 txn_test_gen_plugin::txn_test_gen_plugin() {}
 txn_test_gen_plugin::~txn_test_gen_plugin() {}
 
@@ -383,10 +699,17 @@ void txn_test_gen_plugin::plugin_initialize(const variables_map& options) {
 }
 
 void txn_test_gen_plugin::plugin_startup() {
+   my->irreversible_block_subscription = app().get_channel<channels::irreversible_block>().subscribe( [this]( block_state_ptr s ) {
+      my->on_irreversible_block(s);
+   });
+
    app().get_plugin<http_plugin>().add_api({
       CALL_ASYNC(txn_test_gen, my, create_test_accounts, INVOKE_ASYNC_R_R(my, create_test_accounts, std::string, std::string), 200),
       CALL(txn_test_gen, my, stop_generation, INVOKE_V_V(my, stop_generation), 200),
-      CALL(txn_test_gen, my, start_generation, INVOKE_V_R_R_R(my, start_generation, std::string, uint64_t, uint64_t), 200)
+      CALL(txn_test_gen, my, start_generation, INVOKE_V_R_R_R(my, start_generation, std::string, uint64_t, uint64_t), 200),
+      CALL(txn_test_gen, my, start_workload, INVOKE_V_R(my, start_workload, detail::workload), 200),
+      CALL(txn_test_gen, my, stop_workload, INVOKE_V_V(my, stop_workload), 200),
+      CALL(txn_test_gen, my, get_workload_stats, INVOKE_R_V(my, get_workload_stats), 200)
    });
 }
 
@@ -396,6 +719,11 @@ void txn_test_gen_plugin::plugin_shutdown() {
    }
    catch(fc::exception e) {
    }
+   try {
+      my->stop_workload();
+   }
+   catch(fc::exception e) {
+   }
 }
 
 }
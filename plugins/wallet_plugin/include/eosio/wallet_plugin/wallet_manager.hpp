@@ -53,6 +53,17 @@ public:
    virtual chain::signed_transaction sign_transaction(const chain::signed_transaction& txn, const flat_set<public_key_type>& keys,
                                              const chain::chain_id_type& id);
 
+   /// Sign transactions with the private keys specified via their public keys, spread over threads.
+   /// Only the keys of soft wallets are used from several threads, the signatures of other wallets are made
+   /// one transaction at a time.
+   /// @param txns the transactions to sign, signed in place.
+   /// @param keys the public keys to sign each transaction with, one set per transaction.
+   /// @param id the chain_id to sign transactions with.
+   /// @param threads the number of threads signing, 0 for one per core.
+   /// @throws fc::exception if corresponding private keys not found in unlocked wallets
+   virtual void sign_transactions(vector<chain::signed_transaction>& txns, const vector<flat_set<public_key_type>>& keys,
+                                  const chain::chain_id_type& id, uint32_t threads = 0);
+
 
    /// Sign digest with the private keys specified via their public keys.
    /// @param digest the digest to sign.
@@ -7,6 +7,10 @@
 #include <eosio/wallet_plugin/se_wallet.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <boost/algorithm/string.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
 namespace eosio {
 namespace wallet {
 
@@ -261,6 +265,78 @@ wallet_manager::sign_transaction(const chain::signed_transaction& txn, const fla
    return stxn;
 }
 
+void
+wallet_manager::sign_transactions(vector<chain::signed_transaction>& txns, const vector<flat_set<public_key_type>>& keys,
+                                  const chain::chain_id_type& id, uint32_t threads) {
+   check_timeout();
+   EOS_ASSERT(txns.size() == keys.size(), wallet_exception, "One set of keys per transaction is needed");
+
+   vector<wallet_api*> unlocked;
+   bool soft_only = true;
+   for (const auto& i : wallets) {
+      if (!i.second->is_locked()) {
+         unlocked.push_back(i.second.get());
+         soft_only = soft_only && dynamic_cast<soft_wallet*>(i.second.get()) != nullptr;
+      }
+   }
+
+   if (threads == 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+   if (!soft_only)
+      threads = 1;
+   threads = std::min<size_t>(threads, txns.size());
+
+   auto sign = [&](size_t index) {
+      auto& stxn = txns[index];
+      auto digest = stxn.sig_digest(id, stxn.context_free_data);
+      for (const auto& pk : keys[index]) {
+         bool found = false;
+         for (auto* w : unlocked) {
+            optional<signature_type> sig = w->try_sign_digest(digest, pk);
+            if (sig) {
+               stxn.signatures.push_back(*sig);
+               found = true;
+               break; // inner for
+            }
+         }
+         if (!found) {
+            EOS_THROW(wallet_missing_pub_key_exception, "Public key not found in unlocked wallets ${k}", ("k", pk));
+         }
+      }
+   };
+
+   if (threads <= 1) {
+      for (size_t i = 0; i < txns.size(); ++i)
+         sign(i);
+      return;
+   }
+
+   // transactions are taken one at a time from a shared index, the first error stops every thread
+   std::atomic<size_t> next_index{0};
+   std::mutex error_mutex;
+   fc::exception_ptr error;
+   auto run = [&]() {
+      for (size_t i = next_index++; i < txns.size(); i = next_index++) {
+         try {
+            sign(i);
+         } catch (const fc::exception& e) {
+            std::lock_guard<std::mutex> g(error_mutex);
+            if (!error)
+               error = e.dynamic_copy_exception();
+            next_index = txns.size();
+         }
+      }
+   };
+   vector<std::thread> workers;
+   for (uint32_t t = 1; t < threads; ++t)
+      workers.emplace_back(run);
+   run();
+   for (auto& w : workers)
+      w.join();
+   if (error)
+      error->dynamic_rethrow_exception();
+}
+
 chain::signature_type
 wallet_manager::sign_digest(const chain::digest_type& digest, const public_key_type& key) {
    check_timeout();
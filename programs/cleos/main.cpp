@@ -77,6 +77,8 @@ Options:
 #include <vector>
 #include <regex>
 #include <iostream>
+#include <deque>
+#include <future>
 #include <fc/crypto/hex.hpp>
 #include <fc/variant.hpp>
 #include <fc/io/datastream.hpp>
@@ -2805,15 +2807,43 @@ int eos_main( int argc, char** argv ) {
 
 
    string trxsJson;
+   uint32_t trxs_batch_size = 1000;
+   uint32_t trxs_in_flight = 4;
    auto trxsSubcommand = push->add_subcommand("transactions", localized("Push an array of arbitrary JSON transactions"));
    trxsSubcommand->add_option("transactions", trxsJson, localized("The JSON string or filename defining the array of the transactions to push"))->required();
+   trxsSubcommand->add_option("--batch-size", trxs_batch_size, localized("Number of transactions pushed by one request, at most 1000"), true);
+   trxsSubcommand->add_option("--in-flight", trxs_in_flight, localized("Number of requests sent without waiting for the results of the previous ones"), true);
    trxsSubcommand->set_callback([&] {
       fc::variant trx_var;
       try {
          trx_var = json_from_file_or_string(trxsJson);
       } EOS_RETHROW_EXCEPTIONS(transaction_type_exception, "Fail to parse transaction JSON '${data}'", ("data",trxsJson))
-      auto trxs_result = call(push_txns_func, trx_var);
-      std::cout << fc::json::to_pretty_string(trxs_result) << std::endl;
+      EOSC_ASSERT( trx_var.is_array(), "ERROR: transactions must be an array" );
+      EOSC_ASSERT( trxs_batch_size > 0 && trxs_batch_size <= 1000, "ERROR: --batch-size must be between 1 and 1000" );
+      EOSC_ASSERT( trxs_in_flight > 0, "ERROR: --in-flight must be at least 1" );
+
+      // batches are sent by up to trxs_in_flight threads, results are printed as the oldest batch completes
+      const auto& trxs = trx_var.get_array();
+      std::deque<std::future<fc::variant>> pending;
+      size_t next = 0;
+      bool first = true;
+      std::cout << "[";
+      while( next < trxs.size() || !pending.empty() ) {
+         while( next < trxs.size() && pending.size() < trxs_in_flight ) {
+            size_t last = std::min<size_t>( next + trxs_batch_size, trxs.size() );
+            fc::variants batch( trxs.begin() + next, trxs.begin() + last );
+            pending.emplace_back( std::async( std::launch::async, [batch]() { return call( push_txns_func, batch ); } ) );
+            next = last;
+         }
+         auto results = pending.front().get();
+         pending.pop_front();
+         for( const auto& r : results.get_array() ) {
+            std::cout << (first ? "\n" : ",\n") << fc::json::to_pretty_string( r );
+            first = false;
+         }
+         std::cout.flush();
+      }
+      std::cout << "\n]" << std::endl;
    });
 
 
@@ -49,6 +49,7 @@ cdef extern from "../interface/debug_.hpp":
 
     void add_trusted_account_(uint64_t account);
     void remove_trusted_account_(uint64_t account);
+    void get_compile_stats_(uint64_t& queue_depth, uint64_t& compiled, uint64_t& failed, uint64_t& total_wait_us, uint64_t& total_compile_us, uint64_t& max_compile_us);
 
     int vm_run_script_(const char* str);
 
@@ -153,6 +154,17 @@ def remove_trusted_account(account):
         account = eosapi.s2n(account)
     remove_trusted_account_(account);
 
+def get_compile_stats():
+    cdef uint64_t queue_depth = 0
+    cdef uint64_t compiled = 0
+    cdef uint64_t failed = 0
+    cdef uint64_t total_wait_us = 0
+    cdef uint64_t total_compile_us = 0
+    cdef uint64_t max_compile_us = 0
+    get_compile_stats_(queue_depth, compiled, failed, total_wait_us, total_compile_us, max_compile_us)
+    return dict(queue_depth=queue_depth, compiled=compiled, failed=failed, total_wait_us=total_wait_us,
+                total_compile_us=total_compile_us, max_compile_us=max_compile_us)
+
 def vm_run_script(_str):
     return vm_run_script_(_str)
 
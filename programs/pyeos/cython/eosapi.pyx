@@ -67,7 +67,8 @@ cdef extern from "eosapi_.hpp":
     object get_transaction_(string& id)
 
     int get_code_(string& name, string& wast, string& abi, string& code_hash, int & vm_type)
-    int get_table_(string& scope, string& code, string& table, string& result)
+    object get_table_(string& scope, string& code, string& table)
+    object get_table_rows_(uint64_t code, uint64_t scope, uint64_t table, uint64_t lower_bound, uint64_t upper_bound, uint32_t limit)
 
     object get_currency_balance_(string& _code, string& _account, string& _symbol)
 
@@ -94,6 +95,7 @@ cdef extern from "eosapi_.hpp":
         vector[char]                data
 
     object push_transactions_(vector[vector[action]]& actions, bool sign, uint64_t skip_flag, bool _async, bool _compress, int max_ram_usage)
+    object push_transactions_pipelined_(vector[vector[action]]& actions, bool sign, bool _compress, int max_ram_usage, uint32_t batch_size, object on_result)
     void memcpy(char* dst, char* src, size_t len)
 #    void fc_pack_setcode(setcode _setcode, vector<char>& out)
 
@@ -101,6 +103,7 @@ cdef extern from "eosapi_.hpp":
     void fc_pack_setabi_(string& abiPath, uint64_t account, string& out)
     void fc_pack_updateauth(string& _account, string& _permission, string& _parent, string& _auth, uint32_t _delay, string& result)
     void fc_pack_args(uint64_t code, uint64_t action, string& js, string& bin) except +
+    void fc_pack_args_object(uint64_t code, uint64_t action, object args, string& bin) except +
     object fc_unpack_args(uint64_t code, uint64_t action, string& bin);
 
     object gen_transaction_(vector[action]& v, int expiration)
@@ -384,11 +387,26 @@ def get_code(name):
     return []
 
 def get_table(string& scope, string& code, string& table):
-    cdef string result
+    result = get_table_(scope, code, table)
+    if result is None:
+        return None
+    return JsonStruct(result)
 
-    if 0 == get_table_(scope, code, table, result):
-        return JsonStruct(result)
-    return None
+def get_table_rows(code, scope, table, uint64_t lower_bound=0, uint64_t upper_bound=0xffffffffffffffff, uint32_t limit=10):
+    '''
+    Rows of table with a primary key in [lower_bound, upper_bound], unpacked with the abi of code
+    straight into dicts: {'rows': [...], 'more': bool}
+    '''
+    if isinstance(code, str):
+        code = N(code)
+
+    if isinstance(scope, str):
+        scope = N(scope)
+
+    if isinstance(table, str):
+        table = N(table)
+
+    return get_table_rows_(code, scope, table, lower_bound, upper_bound, limit)
 
 def exec_func(code_:str, action_:str, json_:str, scope_:str, authorization_:str):
     pass
@@ -559,7 +577,6 @@ def pack_updateauth(string& _account, string& _permission, string& _parent, stri
 
 def pack_args(code, action, args):
     cdef string bin
-    args = json.dumps(args)
 
     if isinstance(code, str):
         code = N(code)
@@ -567,7 +584,7 @@ def pack_args(code, action, args):
     if isinstance(action, str):
         action = N(action)
 
-    fc_pack_args(code, action, args, bin)
+    fc_pack_args_object(code, action, args, bin)
     if bin.empty():
         raise Exception('error ocurred in fc_pack_args')
     return <bytes>bin
@@ -632,29 +649,7 @@ def push_raw_transaction(signed_trx):
     if ret:
         return JsonStruct(ret)
 
-def push_transactions(actions, sign = True, uint64_t skip_flag=0, _async=False, compress=False, max_ram_usage=10*1024*1024):
-    '''Send transactions
-
-    Args:
-        actions (list): two dimension action list, structured in [[action1,action2, ...],[action1,action2,...]]
-            each action represented in [account, name, [[actor1, permission1],[actor2, permission2]], data],
-            according to C++ structure defined in transaction.hpp
-           struct action {
-              account_name               account;
-              action_name                name;
-              vector<permission_level>   authorization;
-              bytes                      data;
-            }
-        sign (bool)     : whether to sign the transaction 
-        skip_flag (int) : skip flag, default to 0,
-            all flags are defined in enum validation_steps in eosio/chain/chain_controller.hpp
-        _async          : default to False, True to send in asynchronized mode, 
-            False to send in synchronized mode
-    Returns:
-        int: Sending transactions total cost time 
-    '''
-
-    cdef vector[vector[action]] vv
+cdef to_action_vectors(actions, vector[vector[action]]& vv):
     cdef vector[action] v
     cdef action act
     cdef permission_level per
@@ -698,6 +693,31 @@ def push_transactions(actions, sign = True, uint64_t skip_flag=0, _async=False,
 
         vv.push_back(v)
 
+def push_transactions(actions, sign = True, uint64_t skip_flag=0, _async=False, compress=False, max_ram_usage=10*1024*1024):
+    '''Send transactions
+
+    Args:
+        actions (list): two dimension action list, structured in [[action1,action2, ...],[action1,action2,...]]
+            each action represented in [account, name, [[actor1, permission1],[actor2, permission2]], data],
+            according to C++ structure defined in transaction.hpp
+           struct action {
+              account_name               account;
+              action_name                name;
+              vector<permission_level>   authorization;
+              bytes                      data;
+            }
+        sign (bool)     : whether to sign the transaction 
+        skip_flag (int) : skip flag, default to 0,
+            all flags are defined in enum validation_steps in eosio/chain/chain_controller.hpp
+        _async          : default to False, True to send in asynchronized mode, 
+            False to send in synchronized mode
+    Returns:
+        int: Sending transactions total cost time 
+    '''
+
+    cdef vector[vector[action]] vv
+    to_action_vectors(actions, vv)
+
     results = []
     results, cost = push_transactions_(vv, sign, skip_flag, True, compress, max_ram_usage)
     for i in range(len(results)):
@@ -713,6 +733,29 @@ def push_transactions(actions, sign = True, uint64_t skip_flag=0, _async=False,
             cost_time += r.elapsed
     return results, cost_time
 
+def push_transactions_pipelined(actions, sign=True, compress=False, max_ram_usage=10*1024*1024, uint32_t batch_size=100, on_result=None):
+    '''Send transactions without waiting for each of them
+
+    Args:
+        actions (list)     : two dimension action list, the same as for push_transactions
+        sign (bool)        : whether to sign the transactions, signatures are computed on every core
+        batch_size (int)   : transactions handed to the producer at a time
+        on_result (callable): called with (index, result) as each transaction completes, in completion order
+    Returns:
+        (list, int): results in the order of actions, microseconds from the first dispatch to the last result
+    '''
+    cdef vector[vector[action]] vv
+    to_action_vectors(actions, vv)
+
+    ret = push_transactions_pipelined_(vv, sign, compress, max_ram_usage, batch_size, on_result)
+    if not ret:
+        return [], 0
+    results, cost = ret
+    for i in range(len(results)):
+        if results[i]:
+            results[i] = JsonStruct(results[i])
+    return results, cost
+
 def push_action(contract, action, args, permissions: Dict, _async=False, sign=True, max_ram_usage=10*1024):
     '''Publishing message to blockchain
 
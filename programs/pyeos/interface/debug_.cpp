@@ -313,6 +313,16 @@ void remove_trusted_account_(uint64_t account) {
    vm_manager::get().remove_trusted_account(account);
 }
 
+void get_compile_stats_(uint64_t& queue_depth, uint64_t& compiled, uint64_t& failed, uint64_t& total_wait_us, uint64_t& total_compile_us, uint64_t& max_compile_us) {
+   compile_stats stats = vm_manager::get().get_compile_stats();
+   queue_depth = stats.queue_depth;
+   compiled = stats.compiled;
+   failed = stats.failed;
+   total_wait_us = stats.total_wait_us;
+   total_compile_us = stats.total_compile_us;
+   max_compile_us = stats.max_compile_us;
+}
+
 namespace eosio {
 namespace chain {
    int vm_run_script(const char* str);
@@ -56,6 +56,7 @@ uint64_t acc_get_used_(uint64_t value_ex);
 
 void add_trusted_account_(uint64_t account);
 void remove_trusted_account_(uint64_t account);
+void get_compile_stats_(uint64_t& queue_depth, uint64_t& compiled, uint64_t& failed, uint64_t& total_wait_us, uint64_t& total_compile_us, uint64_t& max_compile_us);
 int vm_run_script_(const char* str);
 
 void softfloat_test_();
@@ -5,6 +5,7 @@
 #include <fc/exception/exception.hpp>
 
 #include <eosio/chain/block_summary_object.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
 #include <eosio/wallet_plugin/wallet_plugin.hpp>
 
 #include <eosio/utilities/common.hpp>
@@ -21,6 +22,7 @@
 #include "fc/bitutil.hpp"
 #include "json.hpp"
 #include "pyobject.hpp"
+#include "pyvariant.hpp"
 #include "wallet_.h"
 
 #include <regex>
@@ -34,6 +36,7 @@
 #include <chrono>
 using namespace std::chrono_literals;
 
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 
@@ -357,6 +360,156 @@ PyObject* push_transactions_(vector<vector<chain::action>>& vv, bool sign, uint6
 }
 
 
+/// results of pipelined transactions, filled on the application thread as they complete
+struct pipeline_results {
+   std::mutex                                              mutex;
+   std::condition_variable                                 cv;
+   std::deque<std::pair<size_t, fc::mutable_variant_object>> completed;
+};
+
+/**
+ * Pushes the transactions of vv without waiting for each of them. They are signed on every core, handed to
+ * transaction_async batch_size at a time, and on_result(index, result) is called on each result as it
+ * completes, unless on_result is None.
+ * Returns [results in the order of vv, microseconds from the first dispatch to the last result].
+ */
+PyObject* push_transactions_pipelined_(vector<vector<chain::action>>& vv, bool sign, bool compress, int32_t max_ram_usage, uint32_t batch_size, PyObject* on_result) {
+   auto notify = [on_result](size_t index, PyObject* result) {
+      if (on_result == Py_None) {
+         return;
+      }
+      python::py_ref ret(PyObject_CallFunction(on_result, "nO", (Py_ssize_t)index, result));
+      if (!ret) {
+         PyErr_Print();
+      }
+   };
+
+   if (get_vm_api()->is_debug_mode() || get_vm_api()->is_unittest_mode()) {
+      // no producer to dispatch to, transactions are applied in place one after the other
+      python::py_ref res(push_transactions_(vv, sign, 0, false, compress, max_ram_usage));
+      PyObject* outputs = PyList_GetItem(res.get(), 0);
+      for (Py_ssize_t i = 0; outputs && i < PyList_Size(outputs); ++i) {
+         notify(i, PyList_GET_ITEM(outputs, i));
+      }
+      return res.release();
+   }
+
+   packed_transaction::compression_type compression = compress ? packed_transaction::zlib : packed_transaction::none;
+   if (batch_size == 0) {
+      batch_size = 1;
+   }
+
+   vector<std::shared_ptr<packed_transaction>> ppts;
+   try {
+      auto info = get_info();
+      controller& ctrl = chain_controller();
+      flat_set<public_key_type> public_keys;
+      if (sign) {
+         public_keys = wm().get_public_keys();
+      }
+
+      vector<signed_transaction> trxs(vv.size());
+      vector<flat_set<public_key_type>> required_keys(vv.size());
+      for (size_t i = 0; i < vv.size(); ++i) {
+         auto& trx = trxs[i];
+         trx.max_ram_usage = max_ram_usage;
+         trx.actions = std::move(vv[i]);
+         if (get_vm_api()->has_option("manual-gen-block")) {
+            trx.expiration = fc::time_point::now() + tx_expiration;
+         } else {
+            trx.expiration = info.head_block_time + tx_expiration;
+         }
+         trx.set_reference_block(info.head_block_id);
+         if (tx_force_unique) {
+            trx.context_free_actions.emplace_back( generate_nonce() );
+         }
+         trx.max_net_usage_words = (tx_max_net_usage + 7)/8;
+         if (sign) {
+            required_keys[i] = ctrl.get_authorization_manager().get_required_keys(trx, public_keys, fc::seconds(10));
+         }
+      }
+
+      Py_BEGIN_ALLOW_THREADS
+      try {
+         if (sign) {
+            wm().sign_transactions(trxs, required_keys, ctrl.get_chain_id());
+         }
+         ppts.reserve(trxs.size());
+         for (auto& trx : trxs) {
+            ppts.emplace_back(std::make_shared<packed_transaction>(trx, compression));
+         }
+      } FC_LOG_AND_DROP();
+      Py_END_ALLOW_THREADS
+   } FC_LOG_AND_DROP();
+
+   if (ppts.size() != vv.size()) {
+      return py_new_none();
+   }
+
+   auto state = std::make_shared<pipeline_results>();
+   uint64_t start = get_microseconds();
+   for (size_t first = 0; first < ppts.size(); first += batch_size) {
+      size_t last = std::min<size_t>(first + batch_size, ppts.size());
+      vector<std::shared_ptr<packed_transaction>> batch(ppts.begin() + first, ppts.begin() + last);
+      // a post per batch leaves the application thread free to produce blocks in between
+      appbase::app().get_io_service().post([state, first, batch]() {
+         for (size_t i = 0; i < batch.size(); ++i) {
+            size_t index = first + i;
+            app().get_method<plugin_interface::incoming::methods::transaction_async>()(batch[i], true, [state, index](const fc::static_variant<fc::exception_ptr, transaction_trace_ptr>& result) {
+               fc::mutable_variant_object output;
+               if (result.contains<fc::exception_ptr>()) {
+                  output("except", result.get<fc::exception_ptr>()->to_string());
+               } else {
+                  auto trx_trace_ptr = result.get<transaction_trace_ptr>();
+                  try {
+                     output = chain_controller().to_variant_with_abi(*trx_trace_ptr, abi_serializer_max_time_ms).get_object();
+                  } catch (const fc::exception&) {
+                     output = fc::variant(*trx_trace_ptr).get_object();
+                  }
+                  output("except", "");
+               }
+               {
+                  std::lock_guard<std::mutex> lk(state->mutex);
+                  state->completed.emplace_back(index, std::move(output));
+               }
+               state->cv.notify_one();
+            });
+         }
+      });
+   }
+
+   python::py_ref outputs(PyList_New(ppts.size()));
+   for (size_t i = 0; i < ppts.size(); ++i) {
+      PyList_SET_ITEM(outputs.get(), i, py_new_none());
+   }
+
+   size_t received = 0;
+   std::deque<std::pair<size_t, fc::mutable_variant_object>> completed;
+   while (received < ppts.size()) {
+      {
+         std::unique_lock<std::mutex> lk(state->mutex);
+         Py_BEGIN_ALLOW_THREADS
+            state->cv.wait(lk, [&]{ return !state->completed.empty(); });
+         Py_END_ALLOW_THREADS
+         completed.swap(state->completed);
+      }
+      for (auto& c : completed) {
+         PyObject* o = python::json::to_string(c.second);
+         PyList_SetItem(outputs.get(), c.first, o);
+         notify(c.first, o);
+      }
+      received += completed.size();
+      completed.clear();
+   }
+   uint64_t cost_time = get_microseconds() - start;
+
+   PyArray res;
+   res.append(outputs.get());
+   res.append(cost_time);
+   return res.get();
+}
+
+
 PyObject* gen_transaction_(vector<chain::action>& v, int expiration) {
    packed_transaction::compression_type compression = packed_transaction::none;
 
@@ -494,6 +647,7 @@ bool update_permission_(uint64_t account, const string& owner, const string& act
    auto owner_perm = authorization.find_permission(eosio::chain::permission_level{account, eosio::chain::name("owner")});
    auto active_perm = authorization.find_permission(eosio::chain::permission_level{account, eosio::chain::name("active")});
 
+   authorization.invalidate_authority_cache();
    modify_permission( *owner_perm, owner_auth );
    modify_permission( *active_perm, active_auth );
    return true;
@@ -739,7 +893,7 @@ uint64_t get_code_update_time_ms_(string& name) {
    return 0;
 }
 
-int get_table_(string& scope, string& code, string& table, string& result) {
+PyObject* get_table_(string& scope, string& code, string& table) {
    try {
       auto& ro_api = get_read_only_api();
       chain_apis::read_only::get_table_rows_params params;
@@ -749,10 +903,76 @@ int get_table_(string& scope, string& code, string& table, string& result) {
       params.table = table;
       chain_apis::read_only::get_table_rows_result results =
           ro_api.get_table_rows(params);
-      result = fc::json::to_string(results);
-      return 0;
+      return python::json::to_string(results);
    }  FC_LOG_AND_DROP();
-   return -1;
+   return py_new_none();
+}
+
+/// the unpacker of the abi of account, rebuilt when the abi changes, null if the account has no abi
+static const python::abi_unpacker* get_abi_unpacker(const account_object& account) {
+   struct cached_abi {
+      string                                 abi;
+      std::unique_ptr<python::abi_unpacker>  unpacker;
+   };
+   static std::map<uint64_t, cached_abi> cache;
+
+   auto& entry = cache[account.name.value];
+   if (entry.abi.size() != account.abi.size() || memcmp(entry.abi.data(), account.abi.data(), account.abi.size()) != 0) {
+      entry.unpacker.reset();
+      entry.abi.assign(account.abi.data(), account.abi.size());
+      abi_def abi;
+      if (abi_serializer::to_abi(account.abi, abi)) {
+         entry.unpacker.reset(new python::abi_unpacker(abi));
+      }
+   }
+   return entry.unpacker.get();
+}
+
+/// a row as python objects, bytes if the abi does not describe it. abi_unpacker knows every type
+/// abi_serializer does, a row it fails on would fail there too
+static PyObject* unpack_row(const python::abi_unpacker* unpacker, const type_name& type,
+                            const char* data, size_t size) {
+   if (!unpacker || type.empty()) {
+      return PyBytes_FromStringAndSize(data, size);
+   }
+   return unpacker->unpack(type, data, size);
+}
+
+/**
+ * The rows of table with a primary key in [lower_bound, upper_bound], at most limit of them, unpacked from
+ * their binary form with the abi of code without going through variants. Rows of a table the abi does not
+ * describe are bytes.
+ */
+PyObject* get_table_rows_(uint64_t code, uint64_t scope, uint64_t table, uint64_t lower_bound, uint64_t upper_bound, uint32_t limit) {
+   try {
+      const auto& d = chain_controller().db();
+      const auto& account = d.get<account_object, by_name>(code);
+      const auto* unpacker = get_abi_unpacker(account);
+      type_name row_type = unpacker ? unpacker->table_type(table) : type_name();
+
+      python::py_ref rows(PyList_New(0));
+      bool more = false;
+      const auto* t_id = d.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+      if (t_id && lower_bound <= upper_bound) {
+         const auto& idx = d.get_index<key_value_index, by_scope_primary>();
+         auto itr = idx.lower_bound(boost::make_tuple(t_id->id, lower_bound));
+         auto end = idx.upper_bound(boost::make_tuple(t_id->id, upper_bound));
+         for (uint32_t count = 0; itr != end; ++itr, ++count) {
+            if (count == limit) {
+               more = true;
+               break;
+            }
+            python::py_ref row(unpack_row(unpacker, row_type, itr->value.data(), itr->value.size()));
+            PyList_Append(rows.get(), row.get());
+         }
+      }
+
+      python::py_ref result(PyDict_New());
+      PyDict_SetItemString(result.get(), "rows", rows.get());
+      PyDict_SetItemString(result.get(), "more", more ? Py_True : Py_False);
+      return result.release();
+   }  FC_LOG_AND_DROP();
+   return py_new_none();
 }
 
 void wast2wasm_(string& wast, string& result) {
@@ -843,7 +1063,28 @@ void fc_pack_args(uint64_t code, uint64_t action, string& json, string& bin) {
    } FC_LOG_AND_DROP();
 }
 
+void fc_pack_args_object(uint64_t code, uint64_t action, PyObject* args, string& bin) {
+   auto& ro_api = get_read_only_api();
+   try {
+      eosio::chain_apis::read_only::abi_json_to_bin_params params;
+      params = {code, action, python::pyobject_to_variant(args)};
+      auto result = ro_api.abi_json_to_bin(params);
+      bin = string(result.binargs.data(), result.binargs.size());
+   } FC_LOG_AND_DROP();
+}
+
 PyObject* fc_unpack_args(uint64_t code, uint64_t action, string& bin) {
+   try {
+      const auto& account = chain_controller().db().get<account_object, by_name>(code);
+      const auto* unpacker = get_abi_unpacker(account);
+      if (unpacker) {
+         auto type = unpacker->action_type(action);
+         if (!type.empty()) {
+            return unpack_row(unpacker, type, bin.data(), bin.size());
+         }
+      }
+   } FC_LOG_AND_DROP();
+
    auto& ro_api = get_read_only_api();
    eosio::chain_apis::read_only::abi_bin_to_json_params params;
    params = {code, action, vector<char>(bin.begin(), bin.end())};
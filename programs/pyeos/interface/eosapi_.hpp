@@ -80,7 +80,8 @@ PyObject* get_public_key_(string& wif_key);
 int get_transaction_(string& id, string& result);
 
 int get_code_(string& name, string& wast, string& abi, string& code_hash, int& vm_type);
-int get_table_(string& scope, string& code, string& table, string& result);
+PyObject* get_table_(string& scope, string& code, string& table);
+PyObject* get_table_rows_(uint64_t code, uint64_t scope, uint64_t table, uint64_t lower_bound, uint64_t upper_bound, uint32_t limit);
 
 uint64_t string_to_uint64_(string str);
 string uint64_to_string_(uint64_t n);
@@ -89,6 +90,7 @@ string convert_from_eth_address(string& eth_address);
 
 
 PyObject* push_transactions_(vector<vector<chain::action>>& vv, bool sign, uint64_t skip_flag = 0, bool async = false, bool compress = false, int32_t max_ram_usage=std::numeric_limits<int32_t>::max());
+PyObject* push_transactions_pipelined_(vector<vector<chain::action>>& vv, bool sign, bool compress, int32_t max_ram_usage, uint32_t batch_size, PyObject* on_result);
 
 
 void wast2wasm_( string& wast ,string& result);
@@ -104,6 +106,7 @@ void fc_pack_setconfig_(string& abiPath, uint64_t account, string& out);
 
 void fc_pack_updateauth(string& _account, string& _permission, string& _parent, string& _auth, uint32_t _delay, string& result);
 void fc_pack_args(uint64_t code, uint64_t action, string& json, string& bin);
+void fc_pack_args_object(uint64_t code, uint64_t action, PyObject* args, string& bin);
 PyObject* fc_unpack_args(uint64_t code, uint64_t action, string& bin);
 
 
@@ -1,4 +1,5 @@
 #include "json.hpp"
+#include "pyvariant.hpp"
 #include <fc/exception/exception.hpp>
 //#include <fc/io/fstream.hpp>
 //#include <fc/io/sstream.hpp>
@@ -24,10 +25,6 @@ namespace python
     template<typename T> variant token_from_stream( T& in );
     void escape_string( const std::string& str, std::ostream& os );
 
-    PyObject* to_stream(const variants& a, json::output_formatting format);
-    PyObject* to_stream(const variant_object& o, json::output_formatting format);
-    PyObject* to_stream(const variant& v, json::output_formatting format);
-
     std::string pretty_print( const std::string& v, uint8_t indent );
 }
 
@@ -573,78 +570,8 @@ namespace python
         return out;
    }
 
-   PyObject* to_stream(const variants& a, json::output_formatting format) {
-      std::stringstream os;
-      PyArray arr;
-      auto itr = a.begin();
-
-      while (itr != a.end()) {
-         PyObject* obj = to_stream(*itr, format);
-         ++itr;
-         arr.append(obj);
-         Py_XDECREF(obj);
-      }
-      return arr.get();
-   }
-
-PyObject* to_stream(const variant_object& o, json::output_formatting format) {
-   PyDict dict;
-
-   auto itr = o.begin();
-
-   while (itr != o.end()) {
-      PyObject* obj = to_stream(itr->value(), format);
-      string key = itr->key();
-      dict.add(key, obj);
-      Py_XDECREF(obj);
-      ++itr;
-   }
-   return dict.get();
-}
-
-PyObject* to_stream(const variant& v, json::output_formatting format) {
-   std::stringstream os;
-
-   switch (v.get_type()) {
-      case variant::null_type:
-         // os << "null";
-         return py_new_none();
-      case variant::int64_type: {
-         int64_t i = v.as_int64();
-         return py_new_int64(i);
-      }
-      case variant::uint64_type: {
-         uint64_t i = v.as_uint64();
-         return py_new_uint64(i);
-      }
-      case variant::double_type:
-         return py_new_float(v.as_double());
-      case variant::bool_type:
-         return py_new_bool(v.as_bool());
-      case variant::string_type: {
-         string str = v.get_string();
-         return py_new_string(str);
-      }
-      case variant::blob_type: {
-         std::stringstream os;
-         escape_string(v.as_string(), os);
-         string s = os.str();
-         return py_new_string(s);
-      }
-      case variant::array_type: {
-         const variants& a = v.get_array();
-         return to_stream(a, format);
-      }
-      case variant::object_type: {
-         const variant_object& o = v.get_object();
-         return to_stream(o, format);
-      }
-   }
-   return py_new_none();
-}
-
    PyObject* json::to_string( const variant& v, output_formatting format /* = stringify_large_ints_and_doubles */) {
-      return python::to_stream(v, format);
+      return variant_to_pyobject(v);
    }
 
     std::string pretty_print( const std::string& v, uint8_t indent ) {
@@ -0,0 +1,356 @@
+#include "pyvariant.hpp"
+
+#include <eosio/chain/abi_serializer.hpp>
+#include <eosio/chain/asset.hpp>
+#include <eosio/chain/block_timestamp.hpp>
+#include <eosio/chain/symbol.hpp>
+#include <eosio/chain/types.hpp>
+
+#include <fc/crypto/hex.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/io/raw.hpp>
+
+#include <unordered_map>
+
+using namespace eosio::chain;
+
+namespace python {
+
+namespace {
+
+   const uint32_t max_depth = 200;
+   /// keys are struct field names, a few hundred at most, the cap only guards against data used as keys
+   const size_t max_interned_keys = 4096;
+
+   PyObject* check( PyObject* o ) {
+      if( !o ) {
+         PyErr_Clear();
+         FC_THROW( "python object allocation failed" );
+      }
+      return o;
+   }
+
+   PyObject* new_string( const char* data, size_t size ) {
+      // strings from the chain are not always valid utf8, surrogateescape keeps their bytes
+      return check( PyUnicode_DecodeUTF8( data, size, "surrogateescape" ) );
+   }
+
+   /// a new reference to the interned python string of key
+   PyObject* interned_key( const std::string& key ) {
+      static std::unordered_map<std::string, PyObject*> keys;
+      auto itr = keys.find( key );
+      if( itr != keys.end() ) {
+         Py_INCREF( itr->second );
+         return itr->second;
+      }
+      PyObject* k = new_string( key.data(), key.size() );
+      PyUnicode_InternInPlace( &k );
+      if( keys.size() < max_interned_keys ) {
+         Py_INCREF( k );
+         keys.emplace( key, k );
+      }
+      return k;
+   }
+
+   PyObject* to_pyobject( const fc::variant& v, uint32_t depth ) {
+      FC_ASSERT( depth < max_depth, "variant nested too deeply" );
+      switch( v.get_type() ) {
+         case fc::variant::null_type:
+            Py_RETURN_NONE;
+         case fc::variant::int64_type:
+            return check( PyLong_FromLongLong( v.as_int64() ) );
+         case fc::variant::uint64_type:
+            return check( PyLong_FromUnsignedLongLong( v.as_uint64() ) );
+         case fc::variant::double_type:
+            return check( PyFloat_FromDouble( v.as_double() ) );
+         case fc::variant::bool_type:
+            return PyBool_FromLong( v.as_bool() );
+         case fc::variant::string_type: {
+            const auto& s = v.get_string();
+            return new_string( s.data(), s.size() );
+         }
+         case fc::variant::blob_type: {
+            const auto& b = v.get_blob();
+            return check( PyBytes_FromStringAndSize( b.data.data(), b.data.size() ) );
+         }
+         case fc::variant::array_type: {
+            const auto& a = v.get_array();
+            py_ref list( check( PyList_New( a.size() ) ) );
+            for( size_t i = 0; i < a.size(); ++i )
+               PyList_SET_ITEM( list.get(), i, to_pyobject( a[i], depth + 1 ) );
+            return list.release();
+         }
+         case fc::variant::object_type: {
+            py_ref dict( check( PyDict_New() ) );
+            for( const auto& entry : v.get_object() ) {
+               py_ref key( interned_key( entry.key() ) );
+               py_ref value( to_pyobject( entry.value(), depth + 1 ) );
+               if( PyDict_SetItem( dict.get(), key.get(), value.get() ) != 0 )
+                  check( nullptr );
+            }
+            return dict.release();
+         }
+      }
+      Py_RETURN_NONE;
+   }
+
+   std::string to_std_string( PyObject* o ) {
+      Py_ssize_t size = 0;
+      const char* data = PyUnicode_AsUTF8AndSize( o, &size );
+      if( !data ) {
+         PyErr_Clear();
+         FC_THROW( "string is not encodable as utf8" );
+      }
+      return std::string( data, size );
+   }
+
+   fc::variant to_variant( PyObject* o, uint32_t depth ) {
+      FC_ASSERT( depth < max_depth, "python object nested too deeply" );
+      if( o == Py_None )
+         return fc::variant();
+      // bool is a subclass of int, it is tested first
+      if( PyBool_Check( o ) )
+         return fc::variant( o == Py_True );
+      if( PyLong_Check( o ) ) {
+         int overflow = 0;
+         long long n = PyLong_AsLongLongAndOverflow( o, &overflow );
+         if( !overflow )
+            return fc::variant( int64_t(n) );
+         if( overflow > 0 ) {
+            unsigned long long u = PyLong_AsUnsignedLongLong( o );
+            if( !PyErr_Occurred() )
+               return fc::variant( uint64_t(u) );
+            PyErr_Clear();
+         }
+         // int128 and the like are strings in json too
+         py_ref s( check( PyObject_Str( o ) ) );
+         return fc::variant( to_std_string( s.get() ) );
+      }
+      if( PyFloat_Check( o ) )
+         return fc::variant( PyFloat_AS_DOUBLE( o ) );
+      if( PyUnicode_Check( o ) )
+         return fc::variant( to_std_string( o ) );
+      if( PyBytes_Check( o ) )
+         return fc::variant( fc::to_hex( PyBytes_AS_STRING( o ), PyBytes_GET_SIZE( o ) ) );
+      if( PyByteArray_Check( o ) )
+         return fc::variant( fc::to_hex( PyByteArray_AS_STRING( o ), PyByteArray_GET_SIZE( o ) ) );
+      if( PyDict_Check( o ) ) {
+         fc::mutable_variant_object obj;
+         PyObject* key;
+         PyObject* value;
+         Py_ssize_t pos = 0;
+         while( PyDict_Next( o, &pos, &key, &value ) ) {
+            if( PyUnicode_Check( key ) ) {
+               obj( to_std_string( key ), to_variant( value, depth + 1 ) );
+            } else {
+               py_ref s( check( PyObject_Str( key ) ) );
+               obj( to_std_string( s.get() ), to_variant( value, depth + 1 ) );
+            }
+         }
+         return fc::variant( std::move(obj) );
+      }
+      if( PyList_Check( o ) || PyTuple_Check( o ) ) {
+         py_ref seq( check( PySequence_Fast( o, "" ) ) );
+         Py_ssize_t size = PySequence_Fast_GET_SIZE( seq.get() );
+         PyObject** items = PySequence_Fast_ITEMS( seq.get() );
+         fc::variants arr;
+         arr.reserve( size );
+         for( Py_ssize_t i = 0; i < size; ++i )
+            arr.emplace_back( to_variant( items[i], depth + 1 ) );
+         return fc::variant( std::move(arr) );
+      }
+      // anything else, a JsonStruct for instance, as its string
+      py_ref s( check( PyObject_Str( o ) ) );
+      return fc::variant( to_std_string( s.get() ) );
+   }
+
+   template<typename T>
+   T read( fc::datastream<const char*>& ds ) {
+      T value;
+      fc::raw::unpack( ds, value );
+      return value;
+   }
+
+   /// the types whose abi_serializer form is a string or a small object, through their variant
+   template<typename T>
+   PyObject* read_as_variant( fc::datastream<const char*>& ds ) {
+      return to_pyobject( fc::variant( read<T>( ds ) ), 0 );
+   }
+
+   PyObject* read_int128( fc::datastream<const char*>& ds, bool is_signed ) {
+      unsigned char bytes[16];
+      ds.read( reinterpret_cast<char*>(bytes), sizeof(bytes) );
+      return check( _PyLong_FromByteArray( bytes, sizeof(bytes), 1, is_signed ) );
+   }
+
+   typedef PyObject* (*builtin_reader)( fc::datastream<const char*>& );
+
+   const std::unordered_map<std::string, builtin_reader>& builtins() {
+      static const std::unordered_map<std::string, builtin_reader> readers = {
+         { "bool",    []( fc::datastream<const char*>& ds ) { return PyBool_FromLong( read<uint8_t>( ds ) ); } },
+         { "int8",    []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<int8_t>( ds ) ) ); } },
+         { "uint8",   []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<uint8_t>( ds ) ) ); } },
+         { "int16",   []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<int16_t>( ds ) ) ); } },
+         { "uint16",  []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<uint16_t>( ds ) ) ); } },
+         { "int32",   []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<int32_t>( ds ) ) ); } },
+         { "uint32",  []( fc::datastream<const char*>& ds ) { return check( PyLong_FromUnsignedLong( read<uint32_t>( ds ) ) ); } },
+         { "int64",   []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLongLong( read<int64_t>( ds ) ) ); } },
+         { "uint64",  []( fc::datastream<const char*>& ds ) { return check( PyLong_FromUnsignedLongLong( read<uint64_t>( ds ) ) ); } },
+         { "int128",  []( fc::datastream<const char*>& ds ) { return read_int128( ds, true ); } },
+         { "uint128", []( fc::datastream<const char*>& ds ) { return read_int128( ds, false ); } },
+         // abi_serializer packs and prints float128 as a uint128
+         { "float128", []( fc::datastream<const char*>& ds ) { return read_int128( ds, false ); } },
+         { "varint32",  []( fc::datastream<const char*>& ds ) { return check( PyLong_FromLong( read<fc::signed_int>( ds ).value ) ); } },
+         { "varuint32", []( fc::datastream<const char*>& ds ) { return check( PyLong_FromUnsignedLong( read<fc::unsigned_int>( ds ).value ) ); } },
+         { "float32", []( fc::datastream<const char*>& ds ) { return check( PyFloat_FromDouble( read<float>( ds ) ) ); } },
+         { "float64", []( fc::datastream<const char*>& ds ) { return check( PyFloat_FromDouble( read<double>( ds ) ) ); } },
+         { "name",    []( fc::datastream<const char*>& ds ) {
+                         auto s = read<name>( ds ).to_string();
+                         return new_string( s.data(), s.size() ); } },
+         { "string",  []( fc::datastream<const char*>& ds ) {
+                         auto s = read<std::string>( ds );
+                         return new_string( s.data(), s.size() ); } },
+         { "bytes",   []( fc::datastream<const char*>& ds ) {
+                         auto b = read<bytes>( ds );
+                         return check( PyBytes_FromStringAndSize( b.data(), b.size() ) ); } },
+         { "raw",     []( fc::datastream<const char*>& ds ) {
+                         // the rest of the data, without a size
+                         py_ref b( check( PyBytes_FromStringAndSize( nullptr, ds.remaining() ) ) );
+                         ds.read( PyBytes_AS_STRING( b.get() ), ds.remaining() );
+                         return b.release(); } },
+         { "time_point",           read_as_variant<fc::time_point> },
+         { "time_point_sec",       read_as_variant<fc::time_point_sec> },
+         { "block_timestamp_type", read_as_variant<block_timestamp_type> },
+         { "checksum160",          read_as_variant<checksum160_type> },
+         { "checksum256",          read_as_variant<checksum256_type> },
+         { "checksum512",          read_as_variant<checksum512_type> },
+         { "public_key",           read_as_variant<public_key_type> },
+         { "signature",            read_as_variant<signature_type> },
+         { "symbol",               read_as_variant<symbol> },
+         { "symbol_code",          read_as_variant<symbol_code> },
+         { "asset",                read_as_variant<asset> },
+         { "extended_asset",       read_as_variant<extended_asset> },
+      };
+      return readers;
+   }
+}
+
+PyObject* variant_to_pyobject( const fc::variant& v ) {
+   return to_pyobject( v, 0 );
+}
+
+fc::variant pyobject_to_variant( PyObject* o ) {
+   return to_variant( o, 0 );
+}
+
+abi_unpacker::abi_unpacker( const abi_def& abi ) {
+   for( const auto& t : abi.types )
+      typedefs[t.new_type_name] = t.type;
+   for( const auto& s : abi.structs ) {
+      auto& layout = structs[s.name];
+      layout.base = s.base;
+      for( const auto& f : s.fields )
+         layout.fields.push_back( field{ interned_key( f.name ), f.type } );
+   }
+   for( const auto& t : abi.tables )
+      tables[t.name] = t.type;
+   for( const auto& a : abi.actions )
+      actions[a.name] = a.type;
+   for( const auto& v : abi.variants.value )
+      variants[v.name] = v.types;
+}
+
+abi_unpacker::~abi_unpacker() {
+   for( auto& s : structs )
+      for( auto& f : s.second.fields )
+         Py_XDECREF( f.key );
+}
+
+type_name abi_unpacker::table_type( name table )const {
+   auto itr = tables.find( table );
+   return itr == tables.end() ? type_name() : itr->second;
+}
+
+type_name abi_unpacker::action_type( name action )const {
+   auto itr = actions.find( action );
+   return itr == actions.end() ? type_name() : itr->second;
+}
+
+type_name abi_unpacker::resolve( const type_name& type )const {
+   auto t = type;
+   for( size_t i = 0; i < typedefs.size(); ++i ) {
+      auto itr = typedefs.find( t );
+      if( itr == typedefs.end() ) return t;
+      t = itr->second;
+   }
+   FC_THROW( "circular typedef ${type}", ("type", type) );
+}
+
+PyObject* abi_unpacker::unpack( const type_name& type, const char* data, size_t size )const {
+   fc::datastream<const char*> ds( data, size );
+   return unpack( type, ds, 0 );
+}
+
+PyObject* abi_unpacker::unpack( const type_name& type, fc::datastream<const char*>& ds, uint32_t depth )const {
+   FC_ASSERT( depth < abi_serializer::max_recursion_depth, "recursive definition of ${type}", ("type", type) );
+   auto rtype = resolve( type );
+
+   auto builtin = builtins().find( rtype );
+   if( builtin != builtins().end() )
+      return builtin->second( ds );
+
+   if( rtype.size() > 2 && rtype.compare( rtype.size() - 2, 2, "[]" ) == 0 ) {
+      auto element = rtype.substr( 0, rtype.size() - 2 );
+      uint32_t size = read<fc::unsigned_int>( ds ).value;
+      // every element takes at least a byte, a forged size fails here rather than in PyList_New
+      FC_ASSERT( size <= ds.remaining(), "array of ${size} elements in ${remaining} bytes", ("size", size)("remaining", ds.remaining()) );
+      py_ref list( check( PyList_New( size ) ) );
+      for( uint32_t i = 0; i < size; ++i )
+         PyList_SET_ITEM( list.get(), i, unpack( element, ds, depth + 1 ) );
+      return list.release();
+   }
+   if( rtype.size() > 1 && rtype.back() == '?' ) {
+      if( !read<uint8_t>( ds ) )
+         Py_RETURN_NONE;
+      return unpack( rtype.substr( 0, rtype.size() - 1 ), ds, depth + 1 );
+   }
+
+   auto v = variants.find( rtype );
+   if( v != variants.end() ) {
+      // [type, value], as abi_serializer gives it
+      uint32_t select = read<fc::unsigned_int>( ds ).value;
+      FC_ASSERT( select < v->second.size(), "invalid tag ${select} of variant ${type}", ("select", select)("type", rtype) );
+      const auto& vtype = v->second[select];
+      py_ref pair( check( PyList_New( 2 ) ) );
+      PyList_SET_ITEM( pair.get(), 0, new_string( vtype.data(), vtype.size() ) );
+      PyList_SET_ITEM( pair.get(), 1, unpack( vtype, ds, depth + 1 ) );
+      return pair.release();
+   }
+
+   auto s = structs.find( rtype );
+   FC_ASSERT( s != structs.end(), "type ${type} is not supported", ("type", rtype) );
+   py_ref dict( check( PyDict_New() ) );
+   unpack_fields( s->second, ds, dict.get(), depth + 1 );
+   return dict.release();
+}
+
+void abi_unpacker::unpack_fields( const struct_layout& s, fc::datastream<const char*>& ds, PyObject* dict, uint32_t depth )const {
+   if( !s.base.empty() ) {
+      auto base = structs.find( resolve( s.base ) );
+      FC_ASSERT( base != structs.end(), "unknown base type ${type}", ("type", s.base) );
+      unpack_fields( base->second, ds, dict, depth + 1 );
+   }
+   for( const auto& f : s.fields ) {
+      auto type = f.type;
+      if( !type.empty() && type.back() == '$' ) {
+         // binary extensions are only present if the data goes on
+         if( ds.remaining() == 0 ) break;
+         type.pop_back();
+      }
+      py_ref value( unpack( type, ds, depth ) );
+      if( PyDict_SetItem( dict, f.key, value.get() ) != 0 )
+         check( nullptr );
+   }
+}
+
+} // python
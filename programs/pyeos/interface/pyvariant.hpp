@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Python.h>
+
+#include <fc/io/datastream.hpp>
+#include <fc/variant.hpp>
+#include <eosio/chain/abi_def.hpp>
+
+#include <map>
+#include <memory>
+
+namespace python {
+
+   struct py_decref {
+      void operator()(PyObject* o) const { Py_XDECREF(o); }
+   };
+   /// an owned reference, released if a conversion throws half way
+   typedef std::unique_ptr<PyObject, py_decref> py_ref;
+
+   /**
+    *  Builds the python object of v with the C API: dicts whose keys are interned, lists, ints, floats, bools,
+    *  None, str for strings and bytes for blobs. The GIL must be held.
+    */
+   PyObject* variant_to_pyobject( const fc::variant& v );
+
+   /**
+    *  The reverse conversion for the arguments of the api: dicts, lists, tuples, ints (as strings past 64 bits),
+    *  floats, bools, None, str, and bytes as the hex strings the abi serializer takes.
+    */
+   fc::variant pyobject_to_variant( PyObject* o );
+
+   /**
+    *  Unpacks the binary data of an abi type, the rows of a table or the arguments of an action, straight
+    *  into python objects. Integers stay ints whatever their size (float128 too, which the abi serializer
+    *  handles as a uint128), bytes stay bytes, variants are [type, value] lists, and names, symbols,
+    *  assets, keys, checksums and times are the strings the abi serializer would give.
+    *  Knows every type abi_serializer does, and throws on malformed data or types the abi does not define.
+    */
+   class abi_unpacker {
+      public:
+         explicit abi_unpacker( const eosio::chain::abi_def& abi );
+         ~abi_unpacker();
+
+         abi_unpacker( const abi_unpacker& ) = delete;
+         abi_unpacker& operator=( const abi_unpacker& ) = delete;
+
+         /// the row type of table, empty if the abi has no such table
+         eosio::chain::type_name table_type( eosio::chain::name table )const;
+         /// the argument type of action, empty if the abi has no such action
+         eosio::chain::type_name action_type( eosio::chain::name action )const;
+
+         PyObject* unpack( const eosio::chain::type_name& type, const char* data, size_t size )const;
+
+      private:
+         struct field {
+            PyObject*                 key; ///< interned
+            eosio::chain::type_name   type;
+         };
+         struct struct_layout {
+            eosio::chain::type_name   base;
+            std::vector<field>        fields;
+         };
+
+         eosio::chain::type_name resolve( const eosio::chain::type_name& type )const;
+         PyObject* unpack( const eosio::chain::type_name& type, fc::datastream<const char*>& ds, uint32_t depth )const;
+         void unpack_fields( const struct_layout& s, fc::datastream<const char*>& ds, PyObject* dict, uint32_t depth )const;
+
+         std::map<eosio::chain::type_name, eosio::chain::type_name>  typedefs;
+         std::map<eosio::chain::type_name, struct_layout>            structs;
+         std::map<eosio::chain::name, eosio::chain::type_name>       tables;
+         std::map<eosio::chain::name, eosio::chain::type_name>       actions;
+         std::map<eosio::chain::type_name, std::vector<eosio::chain::type_name>> variants;
+   };
+
+} // python
@@ -93,6 +93,25 @@ def test_string_find():
     r = eosapi.push_action('luatest', 'sayhello', '', {'luatest':'active'})
     print(r)
 
+def test_state_reset():
+    test_code = '''
+    counter = 0
+    state = {count = 0}
+    function apply(receiver, account, act)
+        if act == N('sayhello') then
+            assert(counter == 0 and state.count == 0 and leaked == nil, 'state leaked from previous action')
+            counter = counter + 1
+            state.count = state.count + 1
+            leaked = 1
+        end
+        return 1
+    end
+    '''
+    deploy('luatest', test_code)
+    for i in range(3):
+        r = eosapi.push_action('luatest', 'sayhello', str(i), {'luatest':'active'})
+        assert r
+
 cfg ='''disable_modules = {io = 1, os=1}
 memory_limit = 1024*64
 output_limit = 1024
@@ -144,6 +163,9 @@ class LUATestCase(unittest.TestCase):
         test_string_find()
 
 
+    def test_state_reset(self):
+        test_state_reset()
+
     def tearDown(self):
         pass
 
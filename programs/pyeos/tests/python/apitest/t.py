@@ -271,3 +271,49 @@ def push_signed_trx():
     r = eosapi.push_raw_transaction(r)
 
 
+
+def table_rows(count=1000):
+    rows = eosapi.get_table_rows('eosio.token', 'eosio', 'accounts')
+    assert rows
+    table = eosapi.get_table('eosio', 'eosio.token', 'accounts')
+    assert [row['balance'] for row in rows['rows']] == [row['balance'] for row in table.rows]
+
+    start = time.time()
+    for i in range(count):
+        eosapi.get_table('eosio', 'eosio.token', 'accounts')
+    print('get_table: %.3f ms'%((time.time() - start)*1e3/count))
+
+    start = time.time()
+    for i in range(count):
+        eosapi.get_table_rows('eosio.token', 'eosio', 'accounts')
+    print('get_table_rows: %.3f ms'%((time.time() - start)*1e3/count))
+
+def args_round_trip(count=1000):
+    args = {'from':'eosio', 'to':'hello', 'quantity':'1.0000 EOS', 'memo':'hello'}
+    bin = eosapi.pack_args('eosio.token', 'transfer', args)
+    assert eosapi.unpack_args('eosio.token', 'transfer', bin) == args
+
+    start = time.time()
+    for i in range(count):
+        eosapi.unpack_args('eosio.token', 'transfer', eosapi.pack_args('eosio.token', 'transfer', args))
+    print('pack_args/unpack_args: %.3f ms'%((time.time() - start)*1e3/count))
+
+@init
+def pipelined(count=1000):
+    actions = []
+    for i in range(count):
+        actions.append([['apitest', 'sayhello', str(i), {'apitest':'active'}]])
+
+    completed = []
+    with producer:
+        results, cost = eosapi.push_transactions_pipelined(actions, batch_size=100, on_result=lambda index, result: completed.append(index))
+    assert len(results) == count and sorted(completed) == list(range(count))
+    assert all(r and not r['except'] for r in results)
+    print('total cost time:%.3f s, transactions per second: %.3f'%(cost/1e6, count*1e6/cost))
+
+@init
+def unpack_types():
+    # float128 and variants are unpacked without abi_serializer, by the same rules as the other types
+    args = {'f': 2**100, 'u': 2**127, 'b': b'\x01\x02', 'v': ['uint64', 5]}
+    bin = eosapi.pack_args('apitest', 'typetest', args)
+    assert eosapi.unpack_args('apitest', 'typetest', bin) == args
@@ -105,8 +105,53 @@ class SDict(object):
         return self.count
 
 
+def test_row_view(code):
+    table_id = N('rows')
+    itr = db.find_i64(code, code, table_id, 1)
+    if itr < 0:
+        db.store_i64(code, table_id, code, 1, struct.pack('QQ', 1, 2))
+        itr = db.find_i64(code, code, table_id, 1)
+
+    view = db.get_i64_view(itr)
+    assert len(view) == 16
+    assert view.tobytes() == db.get_i64(itr)
+    a, b = view.unpack('QQ')
+    assert struct.unpack_from('Q', view, 8)[0] == b
+    assert db.unpack_i64(itr, 'Q', 8)[0] == b
+
+    # memoryviews get a copy of the row, updating it does not change them
+    mv = memoryview(view)
+    assert mv.readonly and mv[:8].tobytes() == struct.pack('Q', a)
+    db.update_i64(itr, code, struct.pack('QQ', a, b + 1))
+    assert struct.unpack('QQ', mv) == (a, b)
+    try:
+        view.unpack('QQ')
+        assert False, 'view of an updated row should be invalid'
+    except BufferError:
+        pass
+    assert db.unpack_i64(itr, 'QQ')[1] == b + 1
+
+kept_views = []
+
+def keep_row_view(code):
+    itr = db.find_i64(code, code, N('rows'), 1)
+    assert itr >= 0
+    # the memoryview outlives the action, it must keep the value the row had
+    kept_views.append((memoryview(db.get_i64_view(itr)), db.get_i64(itr)))
+
+def check_kept_views():
+    assert kept_views
+    for mv, value in kept_views:
+        assert mv.tobytes() == value
+
 def apply(receiver, code, action):
-    if action == N('sayhello'):
+    if action == N('rowview'):
+        test_row_view(code)
+    elif action == N('keepview'):
+        keep_row_view(code)
+    elif action == N('checkview'):
+        check_kept_views()
+    elif action == N('sayhello'):
         msg = read_action()
         sl = SList(code, code, N('mytable'))
         try:
@@ -50,3 +50,19 @@ def debug(msg='hello,world\n'):
     r = eosapi.push_action('db', 'sayhello', msg, {'db':'active'})
     assert r
 
+@init()
+def test_row_view():
+    r = eosapi.push_action('db', 'rowview', '', {'db':'active'})
+    assert r
+
+@init()
+def test_kept_row_view():
+    r = eosapi.push_action('db', 'rowview', '', {'db':'active'})
+    assert r
+    r = eosapi.push_action('db', 'keepview', '', {'db':'active'})
+    assert r
+    # rowview updates the row the kept memoryview was taken from
+    r = eosapi.push_action('db', 'rowview', '', {'db':'active'})
+    assert r
+    r = eosapi.push_action('db', 'checkview', '', {'db':'active'})
+    assert r
@@ -0,0 +1,8 @@
+#include <eosiolib/eosio.hpp>
+
+extern "C" {
+
+void apply( uint64_t receiver, uint64_t code, uint64_t action ) {
+}
+
+}
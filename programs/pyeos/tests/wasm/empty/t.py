@@ -0,0 +1,37 @@
+import os
+import sys
+import time
+import struct
+
+import debug
+import eosapi
+
+from eosapi import N
+from common import prepare, producer
+
+print('please make sure you are running the following command before testing')
+print('./pyeos/pyeos --manual-gen-block --debug -i')
+
+def init(func):
+    def func_wrapper(*args, **kwargs):
+        prepare('empty', 'empty.wast', 'empty.abi', __file__)
+        return func(*args, **kwargs)
+    return func_wrapper
+
+@init
+def test():
+    with producer:
+        r = eosapi.push_action('empty', 'empty', '', {'empty':'active'})
+        assert r
+
+#measures the fixed cost of entering a wasm contract: an apply that does nothing
+@init
+def test2(count=1000):
+    actions = []
+    for i in range(count):
+        action = ['empty', 'empty', str(i), {'empty':'active'}]
+        actions.append(action)
+
+    ret, cost = eosapi.push_actions(actions)
+    assert ret and not ret['except']
+    print('total cost time:%.3f s, cost per action: %.3f ms, actions per second: %.3f'%(cost/1e6, cost/count/1000, 1*1e6/(cost/count)))
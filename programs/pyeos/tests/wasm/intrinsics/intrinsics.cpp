@@ -0,0 +1,49 @@
+#include <eosiolib/eosio.hpp>
+#include <eosiolib/print.hpp>
+#include <eosiolib/crypto.h>
+#include <eosiolib/db.h>
+
+using namespace eosio;
+
+//each action calls one intrinsic `count` times, so cost per action / count approximates
+//the per-call overhead of that intrinsic
+extern "C" {
+
+void apply( uint64_t receiver, uint64_t code, uint64_t action ) {
+   if( code != receiver ) {
+      return;
+   }
+   uint32_t count = 0;
+   read_action_data(&count, sizeof(count));
+
+   switch( action ) {
+      case N(db): {
+         uint64_t value = 0;
+         if( db_find_i64(receiver, receiver, N(bench), 0) < 0 ) {
+            db_store_i64(receiver, N(bench), receiver, 0, &value, sizeof(value));
+         }
+         for( uint32_t i = 0; i < count; i++ ) {
+            int itr = db_find_i64(receiver, receiver, N(bench), 0);
+            db_get_i64(itr, &value, sizeof(value));
+         }
+         break;
+      }
+      case N(sha256): {
+         char data[1024] = {0};
+         checksum256 hash;
+         for( uint32_t i = 0; i < count; i++ ) {
+            sha256(data, sizeof(data), &hash);
+         }
+         break;
+      }
+      case N(print): {
+         for( uint32_t i = 0; i < count; i++ ) {
+            prints("");
+            printui(i);
+         }
+         break;
+      }
+   }
+}
+
+}
@@ -0,0 +1,36 @@
+import os
+import sys
+import time
+import struct
+
+import debug
+import eosapi
+
+from eosapi import N
+from common import prepare, producer
+
+print('please make sure you are running the following command before testing')
+print('./pyeos/pyeos --manual-gen-block --debug -i')
+
+def init(func):
+    def func_wrapper(*args, **kwargs):
+        prepare('intrinsics', 'intrinsics.wast', 'intrinsics.abi', __file__)
+        return func(*args, **kwargs)
+    return func_wrapper
+
+def bench(action, calls, count):
+    actions = []
+    for i in range(count):
+        #the trailing index keeps the actions distinct, the contract only reads the call count
+        args = struct.pack('II', calls, i)
+        actions.append(['intrinsics', action, args, {'intrinsics':'active'}])
+
+    ret, cost = eosapi.push_actions(actions)
+    assert ret and not ret['except']
+    print('%s: cost per action: %.3f ms, cost per call: %.3f us'%(action, cost/count/1000, cost/count/calls))
+
+#run before and after a change to the intrinsic invoker to compare per-call overhead
+@init
+def test(calls=1000, count=100):
+    for action in ('db', 'sha256', 'print'):
+        bench(action, calls, count)
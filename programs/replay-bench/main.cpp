@@ -0,0 +1,428 @@
+/**
+ *  @file
+ *  @copyright defined in eosio/LICENSE.txt
+ */
+#include <eosio/chain/block_log.hpp>
+#include <eosio/chain/config.hpp>
+#include <eosio/chain/controller.hpp>
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/options.hpp>
+#include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/state_prefetcher.hpp>
+#include <eosio/chain/transaction_arena.hpp>
+
+#include <apply_profiler.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/filesystem.hpp>
+#include <fc/variant.hpp>
+
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/program_options.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace eosio::chain;
+namespace bfs = boost::filesystem;
+namespace bpo = boost::program_options;
+using bpo::options_description;
+using bpo::variables_map;
+
+namespace eosio { namespace chain {
+   void set_debug_mode(bool b);
+}}
+
+/**
+ * Replays blocks first..last of a blocks.log against a fresh state, either the genesis state of the log
+ * or a snapshot, and reports how long applying them took.
+ * The blocks are pushed one at a time through controller::push_block on a scratch state and blocks
+ * directory, so the source blocks.log is only read. Blocks between the start state and first are
+ * applied without being measured, with --prefetch they are where the state prefetcher learns from.
+ */
+struct replay_bench {
+   void set_program_options(options_description& cli);
+   void initialize(const variables_map& options);
+   void run();
+
+   bfs::path                        blocks_dir;
+   bfs::path                        data_dir;
+   bfs::path                        output_file;
+   optional<bfs::path>              snapshot_path;
+   uint32_t                         first_block = 0;
+   uint32_t                         last_block = 0;
+   uint64_t                         state_size_mb = 0;
+   state_mapping_config             state_mapping;
+   wasm_interface::vm_type          wasm_runtime = wasm_interface::vm_type::wabt;
+   bool                             native_contracts = false;
+   bool                             irreversible = false;
+   bool                             per_block = false;
+   bool                             prefetch = false;
+};
+
+namespace {
+
+uint64_t now_ns() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+fc::mutable_variant_object summarize(const latency_histogram& h) {
+   return fc::mutable_variant_object()
+      ("count", h.count())
+      ("sum", h.sum())
+      ("p50", h.percentile(50))
+      ("p90", h.percentile(90))
+      ("p99", h.percentile(99))
+      ("max", h.max());
+}
+
+//bytes allocated from the heap and from the chainbase segment
+fc::mutable_variant_object allocator_stats(const controller& chain) {
+   fc::mutable_variant_object stats;
+#ifdef __GLIBC__
+   struct mallinfo mi = mallinfo();
+   stats("heap_in_use", (uint64_t)(uint32_t)mi.uordblks + (uint64_t)(uint32_t)mi.hblkhd);
+   stats("heap_mapped", (uint64_t)(uint32_t)mi.hblkhd);
+#endif
+   auto segment = chain.db().get_segment_manager();
+   stats("state_size", (uint64_t)segment->get_size());
+   stats("state_in_use", (uint64_t)(segment->get_size() - segment->get_free_memory()));
+   return stats;
+}
+
+/**
+ * Last level cache reads and read misses of the calling thread, counted by the kernel. Unavailable, and
+ * reported as null, without perf events or when perf_event_paranoid forbids them.
+ */
+struct llc_counters {
+#ifdef __linux__
+   int accesses = open(PERF_COUNT_HW_CACHE_RESULT_ACCESS);
+   int misses = open(PERF_COUNT_HW_CACHE_RESULT_MISS);
+
+   ~llc_counters() {
+      if (accesses >= 0) close(accesses);
+      if (misses >= 0) close(misses);
+   }
+
+   static int open(uint64_t result) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.size = sizeof(attr);
+      attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+   }
+
+   void start() {
+      for (int fd : {accesses, misses}) {
+         if (fd < 0) continue;
+         ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+         ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+   }
+
+   void stop() {
+      for (int fd : {accesses, misses}) {
+         if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+   }
+
+   static fc::variant read(int fd) {
+      uint64_t count = 0;
+      if (fd < 0 || ::read(fd, &count, sizeof(count)) != sizeof(count)) return fc::variant();
+      return fc::variant(count);
+   }
+
+   fc::mutable_variant_object report() const {
+      return fc::mutable_variant_object()
+         ("llc_reads", read(accesses))
+         ("llc_read_misses", read(misses));
+   }
+#else
+   void start() {}
+   void stop() {}
+   fc::mutable_variant_object report() const {
+      return fc::mutable_variant_object()
+         ("llc_reads", fc::variant())
+         ("llc_read_misses", fc::variant());
+   }
+#endif
+};
+
+struct contract_totals {
+   uint64_t     actions = 0;
+   uint64_t     wall_ns = 0;
+   fc::variants per_action;
+};
+
+}
+
+void replay_bench::run() {
+   controller::config cfg;
+   cfg.blocks_dir = data_dir / config::default_blocks_dir_name;
+   cfg.state_dir = data_dir / config::default_state_dir_name;
+   cfg.state_size = state_size_mb * 1024 * 1024;
+   cfg.state_mapping = state_mapping;
+   cfg.wasm_runtime = wasm_runtime;
+   EOS_ASSERT( !fc::exists(cfg.state_dir / "shared_memory.bin") && !fc::exists(cfg.blocks_dir / "blocks.log"),
+               misc_exception, "${dir} is not empty, replay-bench needs a fresh data directory",
+               ("dir", data_dir.generic_string()) );
+
+   //vm_manager reads the runtime and the debug flag from these rather than from the controller config
+   options::get().set_wasm_runtime_type(wasm_runtime);
+   set_debug_mode(native_contracts);
+   state_prefetcher::set_enabled(prefetch);
+
+   std::ifstream snapshot_file;
+   snapshot_reader_ptr reader;
+   if (snapshot_path) {
+      snapshot_file.open(snapshot_path->generic_string(), (std::ios::in | std::ios::binary));
+      EOS_ASSERT( snapshot_file.good(), snapshot_exception, "Cannot open snapshot ${name}", ("name", snapshot_path->generic_string()) );
+      reader = make_istream_snapshot_reader(snapshot_file);
+      reader->validate();
+      reader->read_section<genesis_state>([&]( auto &section ){
+         section.read_row(cfg.genesis);
+      });
+   } else {
+      cfg.genesis = block_log::extract_genesis_state(blocks_dir);
+   }
+
+   block_log source_log(blocks_dir);
+   const auto source_head = source_log.read_head();
+   EOS_ASSERT( source_head, block_log_exception, "No blocks found in block log" );
+   EOS_ASSERT( source_log.extract_genesis_state(blocks_dir).compute_chain_id() == cfg.genesis.compute_chain_id(),
+               block_log_exception, "Genesis information in blocks.log does not match genesis information in the snapshot" );
+
+   controller chain(cfg);
+   chain.add_indices();
+   chain.startup(reader);
+   snapshot_file.close();
+
+   uint32_t start_num = chain.head_block_num() + 1;
+   uint32_t first = first_block ? first_block : start_num;
+   uint32_t last = std::min(last_block, source_head->block_num());
+   EOS_ASSERT( first >= start_num, block_log_exception, "first block ${first} is before the start state at block ${head}",
+               ("first", first)("head", chain.head_block_num()) );
+   EOS_ASSERT( first <= last, block_log_exception, "no blocks to replay from ${first} to ${last}", ("first", first)("last", last) );
+
+   auto status = irreversible ? controller::block_status::irreversible : controller::block_status::complete;
+   auto read_block = [&](uint32_t num) {
+      auto block = source_log.read_block_by_num(num);
+      EOS_ASSERT( block, block_log_exception, "block ${num} is missing from the block log", ("num", num) );
+      return block;
+   };
+
+   if (start_num < first) {
+      ilog( "applying blocks ${from} to ${to} before the measured range", ("from", start_num)("to", first - 1) );
+      for (uint32_t num = start_num; num < first; num++) {
+         chain.push_block(read_block(num), status);
+      }
+   }
+
+   auto start_allocator = allocator_stats(chain);
+   auto& profiler = apply_profiler::get();
+   profiler.reset();
+   profiler.enable(true);
+   transaction_arena::reset_stats();
+   //the blocks are applied on this thread
+   llc_counters llc;
+   llc.start();
+
+   ilog( "replaying blocks ${first} to ${last}", ("first", first)("last", last) );
+   latency_histogram block_ns;
+   uint64_t trx_count = 0;
+   fc::variants blocks;
+   for (uint32_t num = first; num <= last; num++) {
+      auto block = read_block(num);
+      uint64_t start = now_ns();
+      chain.push_block(block, status);
+      uint64_t elapsed = now_ns() - start;
+
+      block_ns.record(elapsed);
+      trx_count += block->transactions.size();
+      if (per_block) {
+         blocks.emplace_back(fc::mutable_variant_object()
+            ("block_num", num)
+            ("trxs", block->transactions.size())
+            ("apply_ns", elapsed));
+      }
+   }
+   llc.stop();
+   profiler.enable(false);
+
+   map<uint64_t, contract_totals> contracts;
+   for (const auto& p : profiler.get_profiles()) {
+      auto& totals = contracts[p.receiver];
+      totals.actions += p.wall_ns.count();
+      totals.wall_ns += p.wall_ns.sum();
+      totals.per_action.emplace_back(fc::mutable_variant_object()
+         ("action", name(p.act))
+         ("vm_type", p.vm_type)
+         ("wall_ns", summarize(p.wall_ns)));
+   }
+   fc::variants contract_results;
+   for (const auto& item : contracts) {
+      contract_results.emplace_back(fc::mutable_variant_object()
+         ("receiver", name(item.first))
+         ("actions", item.second.actions)
+         ("wall_ns", item.second.wall_ns)
+         ("per_action", item.second.per_action));
+   }
+   std::sort(contract_results.begin(), contract_results.end(), [](const fc::variant& a, const fc::variant& b) {
+      return a["wall_ns"].as_uint64() > b["wall_ns"].as_uint64();
+   });
+
+   double seconds = block_ns.sum() / 1e9;
+   auto report = fc::mutable_variant_object()
+      ("first_block", first)
+      ("last_block", last)
+      ("snapshot", snapshot_path ? snapshot_path->generic_string() : string())
+      ("wasm_runtime", wasm_runtime == wasm_interface::vm_type::wavm ? "wavm" : "wabt")
+      ("native_contracts", native_contracts)
+      ("block_status", irreversible ? "irreversible" : "complete")
+      ("state_mapping", state_mapping)
+      ("blocks", block_ns.count())
+      ("trxs", trx_count)
+      ("seconds", seconds)
+      ("blocks_per_sec", seconds > 0 ? block_ns.count() / seconds : 0)
+      ("trxs_per_sec", seconds > 0 ? trx_count / seconds : 0)
+      ("block_ns", summarize(block_ns))
+      ("allocator_start", start_allocator)
+      ("allocator_end", allocator_stats(chain))
+      ("cache", llc.report())
+      ("prefetch", prefetch)
+      ("prefetcher", state_prefetcher::get_stats())
+      ("arena", transaction_arena::get_stats())
+      ("contracts", contract_results);
+   if (per_block) {
+      report("per_block", blocks);
+   }
+
+   string json = fc::json::to_pretty_string(report);
+   if (output_file.empty()) {
+      std::cout << json << std::endl;
+   } else {
+      std::ofstream out(output_file.generic_string());
+      EOS_ASSERT( out.good(), misc_exception, "Unable to open file '${f}'", ("f", output_file.generic_string()) );
+      out << json << std::endl;
+   }
+}
+
+void replay_bench::set_program_options(options_description& cli)
+{
+   cli.add_options()
+         ("blocks-dir", bpo::value<bfs::path>()->default_value("blocks"),
+          "the location of the blocks directory holding the blocks.log to replay, it is only read")
+         ("snapshot", bpo::value<bfs::path>(),
+          "snapshot to start from, the genesis state of the block log if not specified")
+         ("data-dir", bpo::value<bfs::path>()->default_value("replay-bench-data"),
+          "an empty directory for the state and blocks written during the replay")
+         ("first", bpo::value<uint32_t>(&first_block)->default_value(0),
+          "the first block number to measure, the block after the start state if 0")
+         ("last", bpo::value<uint32_t>(&last_block)->default_value(std::numeric_limits<uint32_t>::max()),
+          "the last block number (inclusive) to measure")
+         ("chain-state-db-size-mb", bpo::value<uint64_t>(&state_size_mb)->default_value(config::default_state_size / (1024  * 1024)),
+          "Maximum size (in MiB) of the chain state database")
+         ("chain-state-db-huge-pages", bpo::value<string>()->default_value("none"),
+          "Pages backing the chain state database, \"none\", \"thp\" or \"hugetlbfs\" (the data directory must then be a hugetlbfs mount)")
+         ("chain-state-db-numa-node", bpo::value<uint32_t>(),
+          "NUMA node the chain state database is preferably allocated on and the replay runs on")
+         ("chain-state-db-prefault", bpo::bool_switch(&state_mapping.prefault)->default_value(false),
+          "Read the whole chain state database into memory before replaying")
+         ("wasm-runtime", bpo::value<wasm_interface::vm_type>(&wasm_runtime)->default_value(wasm_interface::vm_type::wabt),
+          "Override default WASM runtime, \"wavm\" or \"wabt\"")
+         ("native-contracts", bpo::bool_switch(&native_contracts)->default_value(false),
+          "Run contracts that have a native build in ../libs/lib<account>_native in place of their wasm code")
+         ("irreversible", bpo::bool_switch(&irreversible)->default_value(false),
+          "Push the blocks as irreversible, skipping the checks a replay of blocks.log skips")
+         ("per-block", bpo::bool_switch(&per_block)->default_value(false),
+          "Include the apply time of every block in the report")
+         ("prefetch", bpo::bool_switch(&prefetch)->default_value(false),
+          "Enable the state prefetcher, compare the cache misses of the report with a run without it")
+         ("output-file,o", bpo::value<bfs::path>(),
+          "the file to write the json report to, stdout if not specified")
+         ("help", "Print this help message and exit.")
+         ;
+}
+
+void replay_bench::initialize(const variables_map& options) {
+   try {
+      auto to_absolute = [](const bfs::path& p) {
+         return p.is_relative() ? bfs::current_path() / p : p;
+      };
+      blocks_dir = to_absolute(options.at( "blocks-dir" ).as<bfs::path>());
+      data_dir = to_absolute(options.at( "data-dir" ).as<bfs::path>());
+      if (options.count( "snapshot" )) {
+         snapshot_path = to_absolute(options.at( "snapshot" ).as<bfs::path>());
+         EOS_ASSERT( fc::exists(*snapshot_path), snapshot_exception,
+                     "Cannot load snapshot, ${name} does not exist", ("name", snapshot_path->generic_string()) );
+      }
+      if (options.count( "output-file" )) {
+         output_file = to_absolute(options.at( "output-file" ).as<bfs::path>());
+      }
+      const auto& huge_pages = options.at( "chain-state-db-huge-pages" ).as<string>();
+      if (huge_pages == "thp") {
+         state_mapping.huge_pages = huge_pages_mode::THP;
+      } else if (huge_pages == "hugetlbfs") {
+         state_mapping.huge_pages = huge_pages_mode::HUGETLBFS;
+      } else {
+         EOS_ASSERT( huge_pages == "none", misc_exception, "unknown huge pages mode ${m}", ("m", huge_pages) );
+      }
+      if (options.count( "chain-state-db-numa-node" )) {
+         state_mapping.numa_node = options.at( "chain-state-db-numa-node" ).as<uint32_t>();
+      }
+   } FC_LOG_AND_RETHROW()
+}
+
+
+int main(int argc, char** argv)
+{
+   options_description cli ("replay-bench command line options");
+   try {
+      replay_bench bench;
+      bench.set_program_options(cli);
+      variables_map vmap;
+      bpo::store(bpo::parse_command_line(argc, argv, cli), vmap);
+      bpo::notify(vmap);
+      if (vmap.count("help") > 0) {
+        cli.print(std::cerr);
+        return 0;
+      }
+      bench.initialize(vmap);
+      bench.run();
+   } catch( const fc::exception& e ) {
+      elog( "${e}", ("e", e.to_detail_string()));
+      return -1;
+   } catch( const boost::exception& e ) {
+      elog("${e}", ("e",boost::diagnostic_information(e)));
+      return -1;
+   } catch( const std::exception& e ) {
+      elog("${e}", ("e",e.what()));
+      return -1;
+   } catch( ... ) {
+      elog("unknown exception");
+      return -1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <latency_histogram.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace eosio { namespace chain {
+
+BOOST_AUTO_TEST_SUITE(latency_histogram_tests)
+
+BOOST_AUTO_TEST_CASE(exact_small_values)
+{
+   latency_histogram h(3600ull * 1000 * 1000, 8);
+   BOOST_CHECK_EQUAL(0, h.percentile(50));
+   for (uint64_t v = 1; v <= 100; ++v)
+      h.record(v);
+   auto s = h.summary();
+   BOOST_CHECK_EQUAL(100, s.count);
+   BOOST_CHECK_EQUAL(1, s.min);
+   BOOST_CHECK_EQUAL(50, s.mean);
+   BOOST_CHECK_EQUAL(50, s.p50);
+   BOOST_CHECK_EQUAL(90, s.p90);
+   BOOST_CHECK_EQUAL(99, s.p99);
+   BOOST_CHECK_EQUAL(100, s.max);
+   BOOST_CHECK_EQUAL(5050, h.sum());
+
+   h.reset();
+   BOOST_CHECK_EQUAL(0, h.count());
+   BOOST_CHECK_EQUAL(0, h.sum());
+   BOOST_CHECK_EQUAL(0, h.summary().max);
+}
+
+/// percentiles of values spread over several orders of magnitude are within the precision of the buckets
+BOOST_AUTO_TEST_CASE(relative_error)
+{
+   // the workload generator's precision and the profiler's default one
+   for (uint32_t bits : {8u, 4u}) {
+      latency_histogram h(3600ull * 1000 * 1000, bits);
+      std::vector<uint64_t> values;
+      std::mt19937_64 rng(1);
+      std::lognormal_distribution<double> dist(8, 2);
+      for (int i = 0; i < 100000; ++i) {
+         uint64_t v = std::min<uint64_t>(dist(rng), 3600ull * 1000 * 1000);
+         values.push_back(v);
+         h.record(v);
+      }
+      std::sort(values.begin(), values.end());
+      for (double p : {50.0, 90.0, 99.0, 99.9}) {
+         uint64_t exact = values[size_t(std::ceil(p / 100 * values.size())) - 1];
+         uint64_t reported = h.percentile(p);
+         BOOST_CHECK_GE(reported, exact);
+         BOOST_CHECK_LE(reported, exact + (exact >> (bits - 1)) + 1);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(saturation)
+{
+   latency_histogram h(1000);
+   h.record(5000);
+   BOOST_CHECK_EQUAL(1000, h.summary().max);
+   BOOST_CHECK_EQUAL(1000, h.percentile(100));
+
+   // the profiler default tops out at 2^40
+   latency_histogram d;
+   d.record(UINT64_MAX);
+   BOOST_CHECK_EQUAL(1ull << 40, d.max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} }
@@ -0,0 +1,137 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <Common.h>
+#include <FixedHash.h>
+#include <Uint256.h>
+
+#include "vm_bench.hpp"
+
+#include <chrono>
+#include <functional>
+#include <random>
+
+using namespace dev;
+
+namespace eosio { namespace vm_bench {
+
+namespace {
+
+const uint32_t operand_count = 1024;
+
+/**
+ * One opcode as LegacyVM runs it, with and without EVM_UINT256: ref is the u256 expression,
+ * fast reads the u256 slots with fromBoost and writes the result back with toBoost.
+ */
+struct evm_op {
+   std::string                                          name;
+   std::function<void(u256*, u256 const*)>              ref;
+   std::function<void(u256*, u256 const*)>              fast;
+};
+
+#define FAST(expr) [](u256* r, u256 const* sp) { \
+      uint256 a = fromBoost(sp[0]), b = fromBoost(sp[1]), c = fromBoost(sp[2]); (void)b; (void)c; \
+      toBoost(*r, expr); }
+
+u256 exp_ref(u256 base, u256 exponent) {
+   u256 result = 1;
+   while (exponent) {
+      if (static_cast<boost::multiprecision::limb_type>(exponent) & 1)
+         result *= base;
+      base *= base;
+      exponent >>= 1;
+   }
+   return result;
+}
+
+const std::vector<evm_op> opcodes = {
+   {"ADD", [](u256* r, u256 const* sp) { *r = sp[0] + sp[1]; }, FAST(a + b)},
+   {"MUL", [](u256* r, u256 const* sp) { *r = sp[0] * sp[1]; }, FAST(a * b)},
+   {"SUB", [](u256* r, u256 const* sp) { *r = sp[0] - sp[1]; }, FAST(a - b)},
+   {"DIV", [](u256* r, u256 const* sp) { *r = sp[1] ? u256(s512(sp[0]) / s512(sp[1])) : 0; }, FAST(a / b)},
+   {"SDIV", [](u256* r, u256 const* sp) { *r = sp[1] ? s2u(s256(s512(u2s(sp[0])) / s512(u2s(sp[1])))) : 0; }, FAST(sdiv(a, b))},
+   {"MOD", [](u256* r, u256 const* sp) { *r = sp[1] ? u256(s512(sp[0]) % s512(sp[1])) : 0; }, FAST(a % b)},
+   {"EXP", [](u256* r, u256 const* sp) { *r = exp_ref(sp[0], sp[1]); }, FAST(power(a, b))},
+   {"LT", [](u256* r, u256 const* sp) { *r = sp[0] < sp[1] ? 1 : 0; }, FAST(uint256(a < b))},
+   {"SLT", [](u256* r, u256 const* sp) { *r = u2s(sp[0]) < u2s(sp[1]) ? 1 : 0; }, FAST(uint256(slt(a, b)))},
+   {"AND", [](u256* r, u256 const* sp) { *r = sp[0] & sp[1]; }, FAST(a & b)},
+   {"BYTE", [](u256* r, u256 const* sp) { *r = sp[0] < 32 ? u256((sp[1] >> (unsigned)(8 * (31 - sp[0]))) & 0xff) : u256(0); }, FAST(byteAt(a, b))},
+   {"SHL", [](u256* r, u256 const* sp) { *r = sp[0] >= 256 ? u256(0) : u256(sp[1] << unsigned(sp[0])); }, FAST(shl(b, a))},
+   {"SAR", [](u256* r, u256 const* sp) {
+              static u256 const hibit = u256(1) << 255;
+              static u256 const allbits = ~u256(0);
+              if (sp[0] >= 256) { *r = (sp[1] & hibit) ? allbits : 0; return; }
+              unsigned amount = unsigned(sp[0]);
+              *r = sp[1] >> amount;
+              if (sp[1] & hibit) *r |= allbits << (256 - amount); },
+           FAST(sar(b, a))},
+   {"ADDMOD", [](u256* r, u256 const* sp) { *r = sp[2] ? u256((u512(sp[0]) + u512(sp[1])) % sp[2]) : 0; }, FAST(addmod(a, b, c))},
+   {"MULMOD", [](u256* r, u256 const* sp) { *r = sp[2] ? u256((u512(sp[0]) * u512(sp[1])) % sp[2]) : 0; }, FAST(mulmod(a, b, c))},
+   {"MSTORE", [](u256* r, u256 const* sp) { h256 w = (h256)sp[0]; *r = (u256)w; },
+              [](u256* r, u256 const* sp) { uint8_t w[32]; toBigEndian(fromBoost(sp[0]), w); toBoost(*r, fromBigEndian(w)); }},
+   {"memNeed", [](u256* r, u256 const* sp) { u512 end = sp[1] ? u512(sp[0]) + sp[1] : u512(0); *r = u256(end > 0x7FFFFFFFFFFFFFFF ? 0 : end); },
+               [](u256* r, u256 const* sp) { uint64_t end = memEnd(fromBoost(sp[0]), fromBoost(sp[1])); *r = end == UINT64_MAX ? 0 : end; }},
+};
+
+#undef FAST
+
+/// ns per operation of op over the operands, each operand triple is one "stack"
+double time_op(const std::function<void(u256*, u256 const*)>& op, const std::vector<u256>& operands, uint32_t rounds) {
+   u256 result;
+   uint64_t sink = 0;
+   auto start = std::chrono::steady_clock::now();
+   for (uint32_t round = 0; round < rounds; ++round) {
+      for (uint32_t i = 0; i + 3 <= operands.size(); i += 3) {
+         op(&result, &operands[i]);
+         sink ^= static_cast<uint64_t>(result);
+      }
+   }
+   auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+   static volatile uint64_t keep;
+   keep = sink;
+   return double(ns) / (rounds * (operands.size() / 3));
+}
+
+}
+
+}}
+
+using namespace eosio::vm_bench;
+
+BOOST_AUTO_TEST_SUITE(vm_bench)
+
+//not a vm backend: the arithmetic of the evm interpreter alone, u256 (boost) against uint256 (Uint256.h)
+BOOST_AUTO_TEST_CASE(evm_ops) {
+   //full width operands with the top limbs of some of them cleared and small ones, the shift amounts,
+   //byte indexes and exponents, as stack values mostly are
+   std::mt19937_64 rng;
+   std::vector<u256> operands(operand_count * 3);
+   for (auto& v : operands) {
+      uint256 x(rng(), rng(), rng(), rng());
+      for (int i = 3; i > 0 && rng() % 2; --i)
+         x.w[i] = 0;
+      if (rng() % 4 == 0)
+         x = uint256(rng() % 300);
+      toBoost(v, x);
+   }
+
+   uint32_t rounds = std::max<uint32_t>(1, options().iterations / 10);
+   for (const auto& op : opcodes) {
+      double ref_ns = time_op(op.ref, operands, rounds);
+      double fast_ns = time_op(op.fast, operands, rounds);
+      results().emplace_back(fc::mutable_variant_object()
+         ("backend", "evm_ops")
+         ("workload", op.name)
+         ("status", "ok")
+         ("u256_ns", ref_ns)
+         ("uint256_ns", fast_ns)
+         ("speedup", fast_ns > 0 ? ref_ns / fast_ns : 0));
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
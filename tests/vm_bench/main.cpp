@@ -0,0 +1,57 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <cstdlib>
+#include <iostream>
+#include <boost/test/included/unit_test.hpp>
+#include <fc/log/logger.hpp>
+#include <eosio/chain/exceptions.hpp>
+#include <eosiolib_native/vm_api.h>
+
+#include "vm_bench.hpp"
+
+void translate_fc_exception(const fc::exception &e) {
+   std::cerr << "\033[33m" <<  e.to_detail_string() << "\033[0m" << std::endl;
+   BOOST_TEST_FAIL("Caught Unexpected Exception");
+}
+
+namespace eosio {
+namespace chain {
+   void set_debug_mode(bool b);
+}
+}
+
+extern "C" void vm_api_init();
+
+boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[]) {
+   //unlike unit_test this leaves unittest mode off, the native backend is only tried outside of it
+   eosio::chain::set_debug_mode(true);
+   vm_api_init();
+
+   auto& opts = eosio::vm_bench::options();
+   bool is_verbose = false;
+   for (int i = 0; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "--verbose") {
+         is_verbose = true;
+      } else if (i + 1 < argc) {
+         if (arg == "--iterations") {
+            opts.iterations = std::stoul(argv[++i]);
+         } else if (arg == "--batch") {
+            opts.batch = std::stoul(argv[++i]);
+         } else if (arg == "--rows") {
+            opts.rows = std::stoul(argv[++i]);
+         } else if (arg == "--out") {
+            opts.out = argv[++i];
+         }
+      }
+   }
+   if (opts.batch == 0) {
+      opts.batch = 1;
+   }
+   if(!is_verbose) fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::off);
+
+   boost::unit_test::unit_test_monitor.register_exception_translator<fc::exception>(&translate_fc_exception);
+   return nullptr;
+}
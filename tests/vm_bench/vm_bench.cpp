@@ -0,0 +1,341 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <eosio/testing/tester.hpp>
+#include <eosio/chain/wast_to_wasm.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <eosiolib_native/vm_api.h>
+#include <vm_manager.hpp>
+#include <apply_profiler.hpp>
+
+#include <vm_bench/vm_bench.wast.hpp>
+
+#include <config.hpp>
+#include "vm_bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+//action data of the transfer action of vm_eth2
+struct eth_transfer {
+   uint64_t from;
+   uint64_t to;
+   int64_t  value;
+   bytes    data;
+};
+
+FC_REFLECT( eth_transfer, (from)(to)(value)(data) )
+
+namespace eosio { namespace vm_bench {
+
+bench_options& options() {
+   static bench_options opts;
+   return opts;
+}
+
+fc::variants& results() {
+   static fc::variants r;
+   return r;
+}
+
+namespace {
+
+const account_name bench_account = N(vmbench);
+const uint32_t hash_size = 1024;
+const uint32_t setup_chunk = 100;
+const uint32_t warmup_count = 10;
+//billed up front so that a block holds a whole batch whatever the backend's speed
+const uint32_t billed_cpu_time_us = 100;
+
+const vector<string> all_workloads = {"empty", "transfer", "scan", "bulkscan", "lookup", "range", "hash", "fanout"};
+
+/*
+ * EVM version of the workloads, the first calldata byte selects the workload:
+ * 0 stops at once, 1 calls the sha256 precompile on the whole calldata and 2 SLOADs slots 0-999.
+ * The init code stores slots 0-999 before returning the runtime code.
+ */
+const char* evm_init_code =
+   "60005b806001018155600101806103e81160025750603d8060206000396000f3";
+const char* evm_runtime_code =
+   "60003560001a80600114601457600214602a5700"
+   "5b5036600060003760206000366000600060025af100"
+   "5b60005b805450600101806103e811602d5700";
+
+struct backend {
+   string         name;
+   int            vm_type;     ///< vm type of the setcode action
+   int            required_vm; ///< vm library the backend runs on
+   vector<string> workloads;
+};
+
+struct results_writer {
+   ~results_writer() {
+      string json = fc::json::to_pretty_string(fc::mutable_variant_object()("results", results()));
+      if (options().out.empty()) {
+         std::cout << json << std::endl;
+      } else {
+         std::ofstream out(options().out);
+         out << json << std::endl;
+      }
+   }
+};
+
+bytes read_file(const char* path) {
+   std::ifstream in(path, std::ios::binary);
+   BOOST_REQUIRE_MESSAGE(in, "can not open " << path);
+   return bytes(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+bytes contract_code(const backend& b) {
+   switch (b.vm_type) {
+      case VM_TYPE_PY:
+         return read_file(config::python_contract_path);
+      case VM_TYPE_LUA:
+         return read_file(config::lua_contract_path);
+      case VM_TYPE_ETH: {
+         string hex = string(evm_init_code) + evm_runtime_code;
+         bytes code(hex.size() / 2);
+         fc::from_hex(hex, code.data(), code.size());
+         return code;
+      }
+      default: {
+         auto wasm = wast_to_wasm(vm_bench_wast);
+         return bytes(wasm.begin(), wasm.end());
+      }
+   }
+}
+
+action bench_action(const backend& b, const string& workload, bytes data) {
+   return action(vector<permission_level>{{bench_account, config::active_name}}, bench_account, name(workload), data);
+}
+
+action workload_action(const backend& b, const string& workload, uint64_t nonce) {
+   bytes data = fc::raw::pack(nonce);
+   if (b.vm_type == VM_TYPE_ETH) {
+      eth_transfer et{bench_account, bench_account, 0, {}};
+      et.data.push_back(workload == "hash" ? 1 : workload == "scan" ? 2 : 0);
+      et.data.insert(et.data.end(), data.begin(), data.end());
+      if (workload == "hash") {
+         et.data.resize(et.data.size() + hash_size, 'x');
+      }
+      return bench_action(b, "transfer", fc::raw::pack(et));
+   }
+   if (workload == "hash") {
+      auto payload = fc::raw::pack(bytes(hash_size, 'x'));
+      data.insert(data.end(), payload.begin(), payload.end());
+   }
+   return bench_action(b, workload, data);
+}
+
+void push_action(tester& t, action&& act) {
+   signed_transaction trx;
+   trx.actions.emplace_back(std::move(act));
+   t.set_transaction_headers(trx);
+   trx.sign(tester::get_private_key(bench_account, "active"), t.control->get_chain_id());
+   t.push_transaction(trx);
+}
+
+void deploy(tester& t, const backend& b) {
+   t.create_accounts({bench_account, N(alice)});
+   //fanout sends its inline actions with vmbench@active
+   authority auth(tester::get_public_key(bench_account, "active"));
+   auth.accounts.push_back(permission_level_weight{{bench_account, config::eosio_code_name}, 1});
+   t.set_authority(bench_account, config::active_name, auth);
+   t.produce_block();
+
+   if (b.required_vm == VM_TYPE_NATIVE) {
+      //wasm code is set, vm_manager runs the native library of the debug contract in its place
+      get_vm_api()->vm_set_debug_contract(bench_account, config::native_contract_path);
+   }
+   push_action(t, action(vector<permission_level>{{bench_account, config::active_name}},
+                         setcode{
+                            .account    = bench_account,
+                            .vmtype     = (uint8_t)b.vm_type,
+                            .vmversion  = 0,
+                            .code       = contract_code(b)
+                         }));
+   t.produce_block();
+
+   if (b.vm_type == VM_TYPE_ETH) {
+      return;
+   }
+   uint64_t nonce = 0;
+   for (uint32_t start = 0; start < options().rows; start += setup_chunk) {
+      uint32_t count = std::min(setup_chunk, options().rows - start);
+      bytes data = fc::raw::pack(nonce++);
+      for (uint32_t arg : {start, count}) {
+         auto packed = fc::raw::pack(arg);
+         data.insert(data.end(), packed.begin(), packed.end());
+      }
+      push_action(t, bench_action(b, "setup", data));
+      t.produce_block();
+   }
+}
+
+fc::mutable_variant_object summarize(const latency_histogram& h) {
+   return fc::mutable_variant_object()
+      ("count", h.count())
+      ("p50", h.percentile(50))
+      ("p90", h.percentile(90))
+      ("p99", h.percentile(99))
+      ("max", h.max());
+}
+
+uint64_t now_ns() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Pushes batches of transactions carrying one workload action each and produces a block after every batch.
+ * Only push_transaction is timed: the transactions are signed and their keys recovered beforehand.
+ * push_ns is the whole transaction, apply_ns the vm_manager::apply of the workload action alone.
+ */
+fc::mutable_variant_object run_workload(tester& t, const backend& b, const string& workload, uint64_t& nonce) {
+   auto run = [&](uint32_t count, latency_histogram* push_ns) {
+      vector<transaction_metadata_ptr> trxs;
+      trxs.reserve(count);
+      for (uint32_t i = 0; i < count; i++) {
+         signed_transaction trx;
+         trx.actions.emplace_back(workload_action(b, workload, nonce++));
+         t.set_transaction_headers(trx);
+         trx.sign(tester::get_private_key(bench_account, "active"), t.control->get_chain_id());
+         auto meta = std::make_shared<transaction_metadata>(trx);
+         meta->recover_keys(t.control->get_chain_id());
+         trxs.emplace_back(std::move(meta));
+      }
+
+      for (auto& trx : trxs) {
+         uint64_t start = now_ns();
+         auto trace = t.control->push_transaction(trx, fc::time_point::maximum(), billed_cpu_time_us);
+         uint64_t elapsed = now_ns() - start;
+         if (trace->except_ptr) std::rethrow_exception(trace->except_ptr);
+         if (trace->except) throw *trace->except;
+         if (push_ns) {
+            push_ns->record(elapsed);
+         }
+      }
+      t.produce_block();
+   };
+
+   //the first actions load and compile the code
+   run(warmup_count, nullptr);
+
+   auto& profiler = apply_profiler::get();
+   profiler.reset();
+   profiler.enable(true);
+   latency_histogram push_ns;
+   for (uint32_t done = 0; done < options().iterations; done += options().batch) {
+      run(std::min(options().batch, options().iterations - done), &push_ns);
+   }
+   profiler.enable(false);
+
+   uint64_t act = b.vm_type == VM_TYPE_ETH ? N(transfer) : name(workload).value;
+   fc::mutable_variant_object apply_ns;
+   for (const auto& p : profiler.get_profiles()) {
+      if (p.receiver == bench_account.value && p.act == act) {
+         apply_ns = summarize(p.wall_ns);
+      }
+   }
+
+   double seconds = push_ns.sum() / 1e9;
+   return fc::mutable_variant_object()
+      ("backend", b.name)
+      ("vm_type", b.vm_type)
+      ("workload", workload)
+      ("status", "ok")
+      ("ops_per_sec", seconds > 0 ? push_ns.count() / seconds : 0)
+      ("push_ns", summarize(push_ns))
+      ("apply_ns", apply_ns);
+}
+
+void add_result(const backend& b, const string& workload, const string& status, const string& error = "") {
+   auto r = fc::mutable_variant_object()
+      ("backend", b.name)
+      ("vm_type", b.vm_type)
+      ("workload", workload)
+      ("status", status);
+   if (!error.empty()) {
+      r("error", error);
+   }
+   results().emplace_back(std::move(r));
+}
+
+void run_backend(const backend& b) {
+   tester t;
+   if (!vm_manager::get().has_vm(b.required_vm)) {
+      BOOST_TEST_MESSAGE(b.name << " is not loaded, skipped");
+      for (const auto& w : all_workloads) {
+         add_result(b, w, "unavailable");
+      }
+      return;
+   }
+
+   deploy(t, b);
+
+   uint64_t nonce = 0;
+   for (const auto& w : all_workloads) {
+      if (std::find(b.workloads.begin(), b.workloads.end(), w) == b.workloads.end()) {
+         add_result(b, w, "unsupported");
+         continue;
+      }
+      try {
+         results().emplace_back(run_workload(t, b, w, nonce));
+      } catch (const fc::exception& e) {
+         BOOST_ERROR(b.name << " " << w << " failed: " << e.to_string());
+         add_result(b, w, "failed", e.to_string());
+         t.control->abort_block();
+      }
+   }
+}
+
+}
+
+}}
+
+using namespace eosio::vm_bench;
+
+BOOST_GLOBAL_FIXTURE(results_writer);
+
+BOOST_AUTO_TEST_SUITE(vm_bench)
+
+BOOST_AUTO_TEST_CASE(wavm) {
+   run_backend({"wavm", VM_TYPE_WAVM, VM_TYPE_WAVM, all_workloads});
+}
+
+BOOST_AUTO_TEST_CASE(wabt) {
+   run_backend({"wabt", VM_TYPE_WABT, VM_TYPE_WABT, all_workloads});
+}
+
+BOOST_AUTO_TEST_CASE(native) {
+   run_backend({"native", 0, VM_TYPE_NATIVE, all_workloads});
+}
+
+BOOST_AUTO_TEST_CASE(python) {
+   run_backend({"python", VM_TYPE_PY, VM_TYPE_PY, all_workloads});
+}
+
+//vm_lua has no crypto, secondary index or inline action api
+BOOST_AUTO_TEST_CASE(lua) {
+   run_backend({"lua", VM_TYPE_LUA, VM_TYPE_LUA, {"empty", "transfer", "scan", "bulkscan", "lookup"}});
+}
+
+//the evm contract has no tables or inline actions, scan reads 1000 storage slots
+BOOST_AUTO_TEST_CASE(evm) {
+   run_backend({"evm", VM_TYPE_ETH, VM_TYPE_ETH, {"empty", "scan", "hash"}});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,25 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#include <fc/variant.hpp>
+
+namespace eosio { namespace vm_bench {
+
+   struct bench_options {
+      uint32_t    iterations = 1000; ///< measured transactions per workload
+      uint32_t    batch = 100;       ///< transactions per block
+      uint32_t    rows = 1000;       ///< rows read by the scan workloads
+      std::string out;               ///< json results file, stdout if empty
+   };
+
+   bench_options& options();
+
+   /// results written as json when the run ends
+   fc::variants& results();
+
+}}
@@ -181,6 +181,16 @@ BOOST_AUTO_TEST_CASE(wallet_manager_test)
    BOOST_CHECK(find(pks.cbegin(), pks.cend(), pkey1.get_public_key()) != pks.cend());
    BOOST_CHECK(find(pks.cbegin(), pks.cend(), pkey2.get_public_key()) != pks.cend());
 
+   vector<chain::signed_transaction> trxs(16);
+   for (size_t i = 0; i < trxs.size(); ++i)
+      trxs[i].ref_block_num = i;
+   vector<flat_set<public_key_type>> trxs_pubkeys(trxs.size(), pubkeys);
+   wm.sign_transactions(trxs, trxs_pubkeys, chain_id, 4);
+   for (const auto& t : trxs)
+      BOOST_CHECK(t.get_signature_keys(chain_id) == pks);
+   trxs_pubkeys[7].emplace(private_key_type::generate().get_public_key());
+   BOOST_CHECK_THROW(wm.sign_transactions(trxs, trxs_pubkeys, chain_id, 4), wallet_missing_pub_key_exception);
+
    BOOST_CHECK_EQUAL(3, wm.get_public_keys().size());
    wm.set_timeout(chrono::seconds(0));
    BOOST_CHECK_THROW(wm.get_public_keys(), wallet_locked_exception);
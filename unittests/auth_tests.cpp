@@ -294,6 +294,38 @@ BOOST_AUTO_TEST_CASE(link_then_update_auth) { try {
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE(authority_cache_invalidation) { try {
+   TESTER chain;
+
+   chain.create_account("alice");
+
+   const auto first_pub_key = chain.get_public_key("alice", "first");
+   const auto second_pub_key = chain.get_public_key("alice", "second");
+   const auto& authorization = chain.control->get_authorization_manager();
+
+   chain.set_authority("alice", "first", first_pub_key, "active");
+   chain.produce_block();
+
+   // resolved authority is now cached for the pending block
+   authorization.check_authorization(N(alice), N(first), {first_pub_key});
+   BOOST_REQUIRE_EQUAL(*authorization.lookup_minimum_permission(N(alice), N(eosio), N(reqauth)), config::active_name);
+
+   // updates within the same block must be seen
+   chain.set_authority("alice", "first", second_pub_key, "active");
+   BOOST_CHECK_THROW(authorization.check_authorization(N(alice), N(first), {first_pub_key}), unsatisfied_authorization);
+   authorization.check_authorization(N(alice), N(first), {second_pub_key});
+
+   chain.link_authority("alice", "eosio", "first", "reqauth");
+   BOOST_REQUIRE_EQUAL(*authorization.lookup_minimum_permission(N(alice), N(eosio), N(reqauth)), N(first));
+
+   // aborting the block undoes the update, which the cache must follow
+   chain.control->abort_block();
+   authorization.check_authorization(N(alice), N(first), {first_pub_key});
+   BOOST_CHECK_THROW(authorization.check_authorization(N(alice), N(first), {second_pub_key}), unsatisfied_authorization);
+   BOOST_REQUIRE_EQUAL(*authorization.lookup_minimum_permission(N(alice), N(eosio), N(reqauth)), config::active_name);
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE(create_account) {
 try {
    TESTER chain;
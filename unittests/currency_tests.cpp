@@ -6,6 +6,8 @@
 #include <eosio/testing/tester.hpp>
 #include <eosio/chain/abi_serializer.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
+#include <eosio/chain/table_stats_object.hpp>
+#include <eosio/chain/snapshot.hpp>
 
 #include <eosio.token/eosio.token.wast.hpp>
 #include <eosio.token/eosio.token.abi.hpp>
@@ -598,4 +600,61 @@ BOOST_FIXTURE_TEST_CASE( test_input_quantity, currency_tester ) try {
 
 } FC_LOG_AND_RETHROW() /// test_currency
 
+BOOST_FIXTURE_TEST_CASE( test_table_stats, currency_tester ) try {
+   auto check_stats = [&]( name table ) {
+      const auto& db = control->db();
+      uint64_t rows = 0, payload = 0;
+      index_utils<key_value_index>::walk(db, [&]( const key_value_object& row ) {
+         const auto& tab = db.get<table_id_object>(row.t_id);
+         if( tab.code == N(eosio.token) && tab.table == table ) {
+            rows += 1;
+            payload += row.value.size();
+         }
+      });
+
+      const auto* stats = db.find<table_stats_object, by_code_table>(boost::make_tuple(N(eosio.token), table));
+      BOOST_REQUIRE(stats != nullptr);
+      BOOST_REQUIRE_EQUAL(stats->rows, rows);
+      BOOST_REQUIRE_EQUAL(stats->payload_bytes, payload);
+      BOOST_REQUIRE_EQUAL(stats->ram_bytes, payload + rows * config::billable_size_v<key_value_object>);
+      return rows;
+   };
+
+   BOOST_REQUIRE_EQUAL(check_stats(N(stat)), 1);
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 1);
+
+   create_accounts( {N(alice), N(bob)} );
+   transfer(N(eosio.token), N(alice), "100.0000 CUR");
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 2);
+
+   // rows stored in a block that is aborted are taken out of the stats again
+   push_action(N(eosio.token), N(transfer), mutable_variant_object()
+      ("from", eosio_token)
+      ("to",   "bob")
+      ("quantity", "10.0000 CUR")
+      ("memo", "")
+   );
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 3);
+   control->abort_block();
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 2);
+
+   // the stats are rebuilt from a snapshot before the blocks after it are replayed
+   fc::mutable_variant_object snapshot;
+   auto writer = std::make_shared<variant_snapshot_writer>(snapshot);
+   control->write_snapshot(writer);
+   writer->finalize();
+
+   transfer(N(eosio.token), N(bob), "10.0000 CUR");
+   produce_blocks(2);
+   control->abort_block();
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 3);
+
+   close();
+   fc::remove_all(cfg.state_dir);
+   fc::variant snapshot_state(snapshot);
+   open(std::make_shared<variant_snapshot_reader>(snapshot_state));
+   BOOST_REQUIRE_EQUAL(check_stats(N(stat)), 1);
+   BOOST_REQUIRE_EQUAL(check_stats(N(accounts)), 3);
+} FC_LOG_AND_RETHROW() /// test_table_stats
+
 BOOST_AUTO_TEST_SUITE_END()
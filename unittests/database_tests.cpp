@@ -5,6 +5,9 @@
 
 #include <eosio/testing/tester.hpp>
 #include <eosio/chain/global_property_object.hpp>
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/transaction_context.hpp>
 #include <fc/crypto/digest.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -100,5 +103,106 @@ BOOST_AUTO_TEST_SUITE(database_tests)
       } FC_LOG_AND_RETHROW()
    }
 
+   // db_scan_i64 and db_idx64_scan: resuming from the continuation, stopping at the limit and a buffer too small for a row
+   BOOST_AUTO_TEST_CASE(scan_test) {
+      try {
+         TESTER test;
+
+         signed_transaction trx;
+         // the undo session of the transaction context drops the rows created below
+         transaction_context trx_ctx( *test.control, trx, trx.id() );
+         action act;
+         act.account = N(scanner);
+         apply_context ctx( *test.control, trx_ctx, act );
+
+         eosio::chain::database& db = const_cast<eosio::chain::database&>( test.control->db() );
+         auto create_table = [&]( name table ) -> const table_id_object& {
+            return db.create<table_id_object>([&]( table_id_object& t ) {
+               t.code = act.account;
+               t.scope = N(scope);
+               t.table = table;
+               t.payer = act.account;
+            });
+         };
+         const auto& rows = create_table( N(rows) );
+         const auto& by_age = create_table( N(rows.age) );
+         // row i is i + 1 bytes long and indexed by age 100 - i
+         for( uint64_t i = 0; i < 10; ++i ) {
+            db.create<key_value_object>([&]( key_value_object& o ) {
+               o.t_id = rows.id;
+               o.primary_key = i * 10;
+               o.payer = act.account;
+               o.value.assign( string( i + 1, char('a' + i) ).c_str(), i + 1 );
+            });
+            db.create<index64_object>([&]( index64_object& o ) {
+               o.t_id = by_age.id;
+               o.primary_key = i * 10;
+               o.payer = act.account;
+               o.secondary_key = 100 - i;
+            });
+         }
+
+         auto read_u64 = []( const char* p ) { uint64_t v; memcpy( &v, p, sizeof(v) ); return v; };
+         auto read_u32 = []( const char* p ) { uint32_t v; memcpy( &v, p, sizeof(v) ); return v; };
+
+         char buffer[256];
+         // resume through lower, 3 rows at a time from 15 up to 75
+         uint64_t lower = 15;
+         vector<uint64_t> keys;
+         int calls = 0;
+         while( lower < 75 ) {
+            int n = ctx.db_scan_i64( act.account, N(scope), N(rows), lower, 75, 3, buffer, sizeof(buffer) );
+            BOOST_REQUIRE( n > 0 && n <= 3 );
+            size_t pos = 0;
+            for( int i = 0; i < n; ++i ) {
+               uint64_t key = read_u64( buffer + pos );
+               uint32_t size = read_u32( buffer + pos + 8 );
+               BOOST_REQUIRE_EQUAL( size, key / 10 + 1 );
+               BOOST_REQUIRE_EQUAL( buffer[pos + 12], char('a' + key / 10) );
+               keys.push_back( key );
+               pos += 12 + size;
+            }
+            ++calls;
+         }
+         BOOST_REQUIRE_EQUAL( lower, 75u );
+         BOOST_REQUIRE_EQUAL( calls, 2 );
+         BOOST_REQUIRE( keys == vector<uint64_t>({20, 30, 40, 50, 60, 70}) );
+
+         // stopping at the limit leaves the next key in lower
+         lower = 0;
+         BOOST_REQUIRE_EQUAL( ctx.db_scan_i64( act.account, N(scope), N(rows), lower, 1000, 4, buffer, sizeof(buffer) ), 4 );
+         BOOST_REQUIRE_EQUAL( lower, 40u );
+
+         // a buffer too small for the next row returns minus the size of its record and does not move lower
+         lower = 90;
+         BOOST_REQUIRE_EQUAL( ctx.db_scan_i64( act.account, N(scope), N(rows), lower, 1000, 0, buffer, 12 ), -22 );
+         BOOST_REQUIRE_EQUAL( lower, 90u );
+         // rows that fit are still returned, the continuation points at the one that did not
+         lower = 0;
+         BOOST_REQUIRE_EQUAL( ctx.db_scan_i64( act.account, N(scope), N(rows), lower, 1000, 0, buffer, 13 + 14 ), 2 );
+         BOOST_REQUIRE_EQUAL( lower, 20u );
+
+         // the secondary index walks by age, resuming through (secondary, primary)
+         uint64_t secondary = 0, primary = 0;
+         BOOST_REQUIRE_EQUAL( ctx.db_idx64_scan( act.account, N(scope), N(rows.age), N(rows), secondary, primary, 96, 2, buffer, sizeof(buffer) ), 2 );
+         BOOST_REQUIRE_EQUAL( read_u64( buffer ), 91u );
+         BOOST_REQUIRE_EQUAL( read_u64( buffer + 8 ), 90u );
+         BOOST_REQUIRE_EQUAL( read_u32( buffer + 16 ), 10u );
+         BOOST_REQUIRE_EQUAL( secondary, 93u );
+         BOOST_REQUIRE_EQUAL( primary, 70u );
+         BOOST_REQUIRE_EQUAL( ctx.db_idx64_scan( act.account, N(scope), N(rows.age), N(rows), secondary, primary, 96, 0, buffer, sizeof(buffer) ), 3 );
+         BOOST_REQUIRE_EQUAL( secondary, 96u );
+         BOOST_REQUIRE_EQUAL( primary, 0u );
+         secondary = 91;
+         primary = 90;
+         BOOST_REQUIRE_EQUAL( ctx.db_idx64_scan( act.account, N(scope), N(rows.age), N(rows), secondary, primary, 96, 0, buffer, 20 ), -30 );
+
+         // a missing table is an empty range
+         lower = 5;
+         BOOST_REQUIRE_EQUAL( ctx.db_scan_i64( act.account, N(scope), N(missing), lower, 50, 0, buffer, sizeof(buffer) ), 0 );
+         BOOST_REQUIRE_EQUAL( lower, 50u );
+      } FC_LOG_AND_RETHROW()
+   }
+
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <Common.h>
+#include <Uint256.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace dev;
+
+namespace {
+
+//evaluated at compile time, the fuzz test below checks the same functions at run time
+static_assert(mul(uint256(0, 1, 0, 0), uint256(0, 1, 0, 0)) == uint256(0, 0, 1, 0), "constexpr mul");
+static_assert(sub(uint256(), uint256(1)) == ~uint256(), "constexpr sub");
+static_assert(divmod(uint256(0, 0, 0, 1), uint256(3)).rem == uint256(1), "constexpr divmod");
+static_assert(power(uint256(2), uint256(255)) == uint256(0, 0, 0, uint64_t(1) << 63), "constexpr power");
+static_assert(sdiv(~uint256(), uint256(1)) == ~uint256(), "constexpr sdiv");
+
+//the u256 expressions of LegacyVM.cpp the uint256 versions replace
+template <class S> S divWorkaround(S const& _a, S const& _b)
+{
+   return (S)(s512(_a) / s512(_b));
+}
+
+template <class S> S modWorkaround(S const& _a, S const& _b)
+{
+   return (S)(s512(_a) % s512(_b));
+}
+
+u256 ref_exp(u256 _base, u256 _exponent)
+{
+   u256 result = 1;
+   while (_exponent) {
+      if (static_cast<boost::multiprecision::limb_type>(_exponent) & 1)
+         result *= _base;
+      _base *= _base;
+      _exponent >>= 1;
+   }
+   return result;
+}
+
+u256 ref_sar(u256 const& a, u256 const& b)
+{
+   static u256 const hibit = u256(1) << 255;
+   static u256 const allbits = u256("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+   if (a >= 256)
+      return (b & hibit) ? allbits : 0;
+   unsigned amount = unsigned(a);
+   u256 r = b >> amount;
+   if (b & hibit)
+      r |= allbits << (256 - amount);
+   return r;
+}
+
+u256 ref_signextend(u256 const& a, u256 number)
+{
+   if (a < 31) {
+      unsigned testBit = static_cast<unsigned>(a) * 8 + 7;
+      u256 mask = ((u256(1) << testBit) - 1);
+      if (boost::multiprecision::bit_test(number, testBit))
+         number |= ~mask;
+      else
+         number &= mask;
+   }
+   return number;
+}
+
+struct opcode {
+   std::string                                                                   name;
+   std::function<uint256(uint256 const&, uint256 const&, uint256 const&)>       fast;
+   std::function<u256(u256 const&, u256 const&, u256 const&)>                    ref;
+};
+
+const std::vector<opcode> opcodes = {
+   {"ADD", [](auto& a, auto& b, auto&) { return a + b; }, [](auto& a, auto& b, auto&) { return u256(a + b); }},
+   {"add", [](auto& a, auto& b, auto&) { return add(a, b); }, [](auto& a, auto& b, auto&) { return u256(a + b); }},
+   {"MUL", [](auto& a, auto& b, auto&) { return a * b; }, [](auto& a, auto& b, auto&) { return u256(a * b); }},
+   {"mul", [](auto& a, auto& b, auto&) { return mul(a, b); }, [](auto& a, auto& b, auto&) { return u256(a * b); }},
+   {"SUB", [](auto& a, auto& b, auto&) { return a - b; }, [](auto& a, auto& b, auto&) { return u256(a - b); }},
+   {"DIV", [](auto& a, auto& b, auto&) { return a / b; },
+           [](auto& a, auto& b, auto&) { return b ? divWorkaround(a, b) : u256(0); }},
+   {"SDIV", [](auto& a, auto& b, auto&) { return sdiv(a, b); },
+            [](auto& a, auto& b, auto&) { return b ? s2u(divWorkaround(u2s(a), u2s(b))) : u256(0); }},
+   {"MOD", [](auto& a, auto& b, auto&) { return a % b; },
+           [](auto& a, auto& b, auto&) { return b ? modWorkaround(a, b) : u256(0); }},
+   {"SMOD", [](auto& a, auto& b, auto&) { return smod(a, b); },
+            [](auto& a, auto& b, auto&) { return b ? s2u(modWorkaround(u2s(a), u2s(b))) : u256(0); }},
+   {"EXP", [](auto& a, auto& b, auto&) { return power(a, b); }, [](auto& a, auto& b, auto&) { return ref_exp(a, b); }},
+   {"NOT", [](auto& a, auto&, auto&) { return ~a; }, [](auto& a, auto&, auto&) { return u256(~a); }},
+   {"LT", [](auto& a, auto& b, auto&) { return uint256(a < b); }, [](auto& a, auto& b, auto&) { return u256(a < b ? 1 : 0); }},
+   {"GT", [](auto& a, auto& b, auto&) { return uint256(a > b); }, [](auto& a, auto& b, auto&) { return u256(a > b ? 1 : 0); }},
+   {"SLT", [](auto& a, auto& b, auto&) { return uint256(slt(a, b)); },
+           [](auto& a, auto& b, auto&) { return u256(u2s(a) < u2s(b) ? 1 : 0); }},
+   {"SGT", [](auto& a, auto& b, auto&) { return uint256(sgt(a, b)); },
+           [](auto& a, auto& b, auto&) { return u256(u2s(a) > u2s(b) ? 1 : 0); }},
+   {"EQ", [](auto& a, auto& b, auto&) { return uint256(a == b); }, [](auto& a, auto& b, auto&) { return u256(a == b ? 1 : 0); }},
+   {"ISZERO", [](auto& a, auto&, auto&) { return uint256(!a); }, [](auto& a, auto&, auto&) { return u256(a ? 0 : 1); }},
+   {"AND", [](auto& a, auto& b, auto&) { return a & b; }, [](auto& a, auto& b, auto&) { return u256(a & b); }},
+   {"OR", [](auto& a, auto& b, auto&) { return a | b; }, [](auto& a, auto& b, auto&) { return u256(a | b); }},
+   {"XOR", [](auto& a, auto& b, auto&) { return a ^ b; }, [](auto& a, auto& b, auto&) { return u256(a ^ b); }},
+   {"BYTE", [](auto& a, auto& b, auto&) { return byteAt(a, b); },
+            [](auto& a, auto& b, auto&) { return a < 32 ? u256((b >> (unsigned)(8 * (31 - a))) & 0xff) : u256(0); }},
+   {"SHL", [](auto& a, auto& b, auto&) { return shl(b, a); },
+           [](auto& a, auto& b, auto&) { return a >= 256 ? u256(0) : u256(b << unsigned(a)); }},
+   {"SHR", [](auto& a, auto& b, auto&) { return shr(b, a); },
+           [](auto& a, auto& b, auto&) { return a >= 256 ? u256(0) : u256(b >> unsigned(a)); }},
+   {"SAR", [](auto& a, auto& b, auto&) { return sar(b, a); }, [](auto& a, auto& b, auto&) { return ref_sar(a, b); }},
+   {"ADDMOD", [](auto& a, auto& b, auto& c) { return addmod(a, b, c); },
+              [](auto& a, auto& b, auto& c) { return c ? u256((u512(a) + u512(b)) % c) : u256(0); }},
+   {"MULMOD", [](auto& a, auto& b, auto& c) { return mulmod(a, b, c); },
+              [](auto& a, auto& b, auto& c) { return c ? u256((u512(a) * u512(b)) % c) : u256(0); }},
+   {"SIGNEXTEND", [](auto& a, auto& b, auto&) { return signextend(a, b); },
+                  [](auto& a, auto& b, auto&) { return ref_signextend(a, b); }},
+};
+
+/**
+ * Operands biased toward the edge cases: zero, one, all ones, the sign bit, single limb values,
+ * small shift amounts and values with random limbs cleared, so that every divisor length is hit.
+ */
+struct operand_generator {
+   boost::random::mt19937 rng;
+   boost::random::uniform_int_distribution<uint64_t> limb;
+   boost::random::uniform_int_distribution<int> kind{0, 9};
+
+   uint256 operator()() {
+      uint64_t top = uint64_t(1) << 63;
+      switch (kind(rng)) {
+         case 0: return uint256(limb(rng) % 4);
+         case 1: return ~uint256() - uint256(limb(rng) % 4);
+         case 2: return uint256(0, 0, 0, top) - uint256(limb(rng) % 2);
+         case 3: return uint256(limb(rng) % 300);
+         case 4: return uint256(limb(rng));
+         case 5: return shl(uint256(1), unsigned(limb(rng) % 256));
+         default: {
+            uint256 v(limb(rng), limb(rng), limb(rng), limb(rng));
+            uint64_t mask = limb(rng);
+            for (int i = 0; i < 4; ++i) {
+               if (mask & (1 << i)) v.w[i] = 0;
+               if (mask & (16 << i)) v.w[i] = ~uint64_t(0);
+            }
+            return v;
+         }
+      }
+   }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(evm_uint256_tests)
+
+BOOST_AUTO_TEST_CASE(conversion_test) {
+   operand_generator gen;
+   for (int i = 0; i < 10000; ++i) {
+      uint256 v = gen();
+      u256 b;
+      toBoost(b, v);
+      BOOST_REQUIRE(fromBoost(b) == v);
+      //through boost's own arithmetic, so that normalized backends with fewer limbs are read too
+      u256 c = b + 1 - 1;
+      BOOST_REQUIRE(fromBoost(c) == v);
+   }
+}
+
+BOOST_AUTO_TEST_CASE(differential_fuzz_test) {
+   operand_generator gen;
+   for (const auto& op : opcodes) {
+      for (int i = 0; i < 20000; ++i) {
+         uint256 a = gen(), b = gen(), c = gen();
+         u256 ua, ub, uc;
+         toBoost(ua, a);
+         toBoost(ub, b);
+         toBoost(uc, c);
+         u256 expected = op.ref(ua, ub, uc);
+         uint256 got = op.fast(a, b, c);
+         BOOST_REQUIRE_MESSAGE(fromBoost(expected) == got,
+                               op.name << "(" << ua << ", " << ub << ", " << uc << ") is " << expected);
+      }
+   }
+}
+
+BOOST_AUTO_TEST_CASE(mem_end_test) {
+   operand_generator gen;
+   for (int i = 0; i < 100000; ++i) {
+      uint256 offset = gen(), size = gen();
+      u256 uoffset, usize;
+      toBoost(uoffset, offset);
+      toBoost(usize, size);
+      u512 end = usize ? u512(uoffset) + usize : u512(0);
+      uint64_t got = memEnd(offset, size);
+      if (end > 0x7FFFFFFFFFFFFFFF)
+         BOOST_REQUIRE_EQUAL(got, UINT64_MAX);
+      else
+         BOOST_REQUIRE_EQUAL(got, uint64_t(end));
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+/**
+ *  @file
+ *  @copyright defined in eos/LICENSE.txt
+ */
+#include <eosio/chain/merkle.hpp>
+#include <eosio/chain/sha256_batch.hpp>
+#include <fc/time.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace eosio::chain;
+
+namespace {
+
+   // the straightforward definition merkle() must keep matching
+   digest_type reference_merkle( vector<digest_type> ids ) {
+      if( 0 == ids.size() ) { return digest_type(); }
+
+      while( ids.size() > 1 ) {
+         if( ids.size() % 2 )
+            ids.push_back(ids.back());
+
+         for( size_t i = 0; i < ids.size() / 2; i++ ) {
+            ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+         }
+
+         ids.resize(ids.size() / 2);
+      }
+
+      return ids.front();
+   }
+
+   vector<digest_type> make_leaves( size_t count ) {
+      vector<digest_type> leaves;
+      leaves.reserve(count);
+      for( size_t i = 0; i < count; i++ ) {
+         leaves.push_back(digest_type::hash(i));
+      }
+      return leaves;
+   }
+
+   const char* impl_names[] = { "generic", "avx2", "shani" };
+
+}
+
+BOOST_AUTO_TEST_SUITE(merkle_tests)
+
+BOOST_AUTO_TEST_CASE(batch_matches_digest_hash)
+{
+   const char* selected = sha256_batch_impl();
+
+   for( auto name : impl_names ) {
+      if( !set_sha256_batch_impl(name) ) {
+         BOOST_TEST_MESSAGE("sha256 batch implementation " << name << " is not supported by this cpu");
+         continue;
+      }
+
+      for( size_t count : { 1, 2, 7, 8, 9, 16, 17, 33 } ) {
+         auto leaves = make_leaves(count * 2);
+         vector<digest_type> batched(count);
+         sha256_batch_64((const char*)leaves.data(), count, (char*)batched.data());
+
+         for( size_t i = 0; i < count; i++ ) {
+            BOOST_REQUIRE_EQUAL(batched[i].str(), digest_type::hash(std::make_pair(leaves[2 * i], leaves[2 * i + 1])).str());
+         }
+      }
+
+      for( size_t count = 0; count < 70; count++ ) {
+         auto leaves = make_leaves(count);
+         BOOST_REQUIRE_EQUAL(merkle(leaves).str(), reference_merkle(leaves).str());
+      }
+   }
+
+   BOOST_REQUIRE(set_sha256_batch_impl(selected));
+}
+
+/**
+ * Compares merkle() against the one-pair-at-a-time reference for 1k, 10k and 100k leaves with each
+ * supported implementation.  Disabled by default, run with --run_test=merkle_tests/bench_merkle
+ */
+BOOST_AUTO_TEST_CASE(bench_merkle, * boost::unit_test::disabled())
+{
+   const char* selected = sha256_batch_impl();
+
+   for( size_t count : { 1000, 10000, 100000 } ) {
+      auto leaves = make_leaves(count);
+      const int rounds = 10;
+
+      auto start = fc::time_point::now();
+      for( int r = 0; r < rounds; r++ ) {
+         reference_merkle(leaves);
+      }
+      BOOST_TEST_MESSAGE(count << " leaves, reference: " << (fc::time_point::now() - start).count() / rounds << " us");
+
+      for( auto name : impl_names ) {
+         if( !set_sha256_batch_impl(name) ) {
+            continue;
+         }
+         start = fc::time_point::now();
+         for( int r = 0; r < rounds; r++ ) {
+            merkle(leaves);
+         }
+         BOOST_TEST_MESSAGE(count << " leaves, " << name << ": " << (fc::time_point::now() - start).count() / rounds << " us");
+      }
+   }
+
+   BOOST_REQUIRE(set_sha256_batch_impl(selected));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,8 @@
 #include <eosio/chain/authority.hpp>
 #include <eosio/chain/types.hpp>
 #include <eosio/chain/asset.hpp>
+#include <eosio/chain/flat_hash_map.hpp>
+#include <eosio/chain/transaction_arena.hpp>
 #include <eosio/testing/tester.hpp>
 
 #include <eosio/utilities/key_conversion.hpp>
@@ -584,6 +586,87 @@ BOOST_AUTO_TEST_CASE(alphabetic_sort)
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE(flat_hash_map_test)
+{ try {
+  flat_hash_map<uint64_t, int> m(4);
+  map<uint64_t, int> expected;
+
+  boost::random::mt19937 rng;
+  boost::random::uniform_int_distribution<uint64_t> key_dist(0, 999);
+  boost::random::uniform_int_distribution<int> op_dist(0, 2);
+  for( int i = 0; i < 100000; ++i ) {
+    auto k = key_dist(rng);
+    switch( op_dist(rng) ) {
+      case 0:
+        m.set(k, i);
+        expected[k] = i;
+        break;
+      case 1:
+        BOOST_REQUIRE_EQUAL(m.erase(k), expected.erase(k) == 1);
+        break;
+      default: {
+        auto* v = m.find(k);
+        auto itr = expected.find(k);
+        BOOST_REQUIRE_EQUAL(v != nullptr, itr != expected.end());
+        if( v ) BOOST_REQUIRE_EQUAL(*v, itr->second);
+      }
+    }
+    BOOST_REQUIRE_EQUAL(m.size(), expected.size());
+  }
+
+  m.clear();
+  BOOST_TEST(m.empty());
+  BOOST_TEST(m.find(1) == nullptr);
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(transaction_arena_test)
+{ try {
+  // no scope open, the containers draw from the heap
+  BOOST_TEST(transaction_arena::current() == nullptr);
+  arena_vector<int> heap_ints(10, 1);
+
+  transaction_arena::reset_stats();
+  {
+    transaction_arena::scope outer;
+    BOOST_REQUIRE(transaction_arena::current() != nullptr);
+
+    arena_vector<uint64_t> ints;
+    for( uint64_t i = 0; i < 100000; ++i ) ints.push_back(i);
+    BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(ints.data()) % alignof(uint64_t), 0u);
+    {
+      transaction_arena::scope inner;
+      vector<bool, arena_allocator<bool>> flags(1000, false);
+      flags[999] = true;
+      BOOST_TEST(flags[999]);
+    }
+    // closing a nested scope does not release the arena
+    BOOST_REQUIRE(transaction_arena::current() != nullptr);
+    for( uint64_t i = 0; i < ints.size(); ++i ) BOOST_REQUIRE_EQUAL(ints[i], i);
+
+    arena_ostringstream console;
+    console << "hello " << 42;
+    BOOST_REQUIRE_EQUAL(string(console.str().c_str()), "hello 42");
+  }
+  BOOST_TEST(transaction_arena::current() == nullptr);
+
+  auto s = transaction_arena::get_stats();
+  BOOST_REQUIRE_EQUAL(s.releases, 1u);
+  BOOST_TEST(s.last_bytes >= 100000 * sizeof(uint64_t));
+  BOOST_REQUIRE_EQUAL(s.high_water_bytes, s.last_bytes);
+  BOOST_TEST(s.reserved_bytes > 0u);
+
+  // the chunks kept by the first scope serve the next one
+  auto allocations = s.chunk_allocations;
+  {
+    transaction_arena::scope again;
+    arena_vector<uint64_t> ints(1000);
+  }
+  BOOST_REQUIRE_EQUAL(transaction_arena::get_stats().chunk_allocations, allocations);
+  BOOST_REQUIRE_EQUAL(transaction_arena::get_stats().releases, 2u);
+
+} FC_LOG_AND_RETHROW() }
+
 
 BOOST_AUTO_TEST_CASE(transaction_test) { try {
 
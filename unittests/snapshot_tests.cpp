@@ -13,6 +13,7 @@
 #include <snapshot_test/snapshot_test.abi.hpp>
 
 #include <sstream>
+#include <fstream>
 
 using namespace eosio;
 using namespace testing;
@@ -145,9 +146,93 @@ struct buffered_snapshot_suite {
 
 };
 
+struct chunked_snapshot_suite {
+   using writer_t = chunked_ostream_snapshot_writer;
+   using reader_t = chunked_istream_snapshot_reader;
+   using write_storage_t = std::ostringstream;
+   using snapshot_t = std::string;
+   using read_storage_t = std::istringstream;
+
+   struct writer : public writer_t {
+      writer( const std::shared_ptr<write_storage_t>& storage )
+      :writer_t(*storage)
+      ,storage(storage)
+      {
+
+      }
+
+      std::shared_ptr<write_storage_t> storage;
+   };
+
+   struct reader : public reader_t {
+      explicit reader(const std::shared_ptr<read_storage_t>& storage)
+      :reader_t(*storage)
+      ,storage(storage)
+      {}
+
+      std::shared_ptr<read_storage_t> storage;
+   };
+
+
+   static auto get_writer() {
+      return std::make_shared<writer>(std::make_shared<write_storage_t>());
+   }
+
+   static auto finalize(const std::shared_ptr<writer>& w) {
+      w->finalize();
+      return w->storage->str();
+   }
+
+   static auto get_reader( const snapshot_t& buffer) {
+      return std::make_shared<reader>(std::make_shared<read_storage_t>(buffer));
+   }
+
+};
+
 BOOST_AUTO_TEST_SUITE(snapshot_tests)
 
-using snapshot_suites = boost::mpl::list<variant_snapshot_suite, buffered_snapshot_suite>;
+using snapshot_suites = boost::mpl::list<variant_snapshot_suite, buffered_snapshot_suite, chunked_snapshot_suite>;
+
+BOOST_AUTO_TEST_CASE(test_chunked_snapshot_checksum)
+{
+   tester chain;
+   const auto& db = chain.control->db();
+
+   std::ostringstream out;
+   // uncompressed, so that the corrupted byte below is a row byte rather than part of zlib's own framing
+   chunked_ostream_snapshot_writer writer(out, 2, false);
+   writer.write_section("rows", [&db](auto& section) {
+      for (uint64_t i = 0; i < 1024; i++) {
+         section.add_row(i, db);
+      }
+   });
+   writer.finalize();
+
+   std::string buffer = out.str();
+   {
+      std::istringstream in(buffer);
+      chunked_istream_snapshot_reader reader(in, 2);
+      reader.validate();
+      BOOST_REQUIRE(reader.has_section("rows"));
+      reader.read_section("rows", [](auto& section) {
+         uint64_t value = 0;
+         for (uint64_t i = 0; i < 1024; i++) {
+            bool more = section.read_row(value);
+            BOOST_REQUIRE_EQUAL(value, i);
+            BOOST_REQUIRE_EQUAL(more, i + 1 < 1024);
+         }
+      });
+   }
+
+   // flip a byte in the middle of the chunk's rows, in front of the end marker, the checksum must catch it
+   buffer[buffer.size() - sizeof(uint64_t) - 512 * sizeof(uint64_t)] ^= 0xff;
+   std::istringstream in(buffer);
+   chunked_istream_snapshot_reader reader(in, 2);
+   BOOST_CHECK_EXCEPTION(reader.read_section("rows", [](auto& section) {
+      uint64_t value = 0;
+      section.read_row(value);
+   }), snapshot_exception, fc_exception_message_is("Binary snapshot chunk checksum mismatch"));
+}
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_exhaustive_snapshot, SNAPSHOT_SUITE, snapshot_suites)
 {
@@ -250,4 +335,70 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_replay_over_snapshot, SNAPSHOT_SUITE, snapsho
    BOOST_REQUIRE_EQUAL(expected_post_integrity_hash.str(), snap_chain.control->calculate_integrity_hash().str());
 }
 
+/**
+ * Writes and reads back SNAPSHOT_BENCH_GB (default 10) gigabytes of synthetic rows with the version 1
+ * and the chunked version 2 binary formats and reports the time taken by each.
+ * Disabled by default, run with --run_test=snapshot_tests/bench_synthetic_snapshot
+ */
+BOOST_AUTO_TEST_CASE(bench_synthetic_snapshot, * boost::unit_test::disabled())
+{
+   uint64_t gigabytes = 10;
+   if (const char* env = getenv("SNAPSHOT_BENCH_GB")) {
+      gigabytes = std::stoull(env);
+   }
+
+   tester chain;
+   const auto& db = chain.control->db();
+
+   // rows shaped like contract table rows, a primary key and a small blob
+   const size_t value_size = 112;
+   const uint64_t row_count = gigabytes * 1024 * 1024 * 1024 / (value_size + sizeof(uint64_t) + 1);
+   const uint64_t section_count = 16;
+   auto path = fc::temp_directory_path() / "snapshot-bench.bin";
+
+   auto bench = [&](const char* name, auto make_writer, auto make_reader) {
+      auto start = fc::time_point::now();
+      {
+         std::ofstream out(path.generic_string(), (std::ios::out | std::ios::binary));
+         auto writer = make_writer(out);
+         bytes value(value_size);
+         for (uint64_t s = 0; s < section_count; s++) {
+            writer->write_section(std::to_string(s), [&](auto& section) {
+               for (uint64_t i = s; i < row_count; i += section_count) {
+                  memcpy(value.data(), &i, sizeof(i));
+                  section.add_row(std::make_pair(i, value), db);
+               }
+            });
+         }
+         writer->finalize();
+      }
+      auto written = fc::time_point::now();
+
+      {
+         std::ifstream in(path.generic_string(), (std::ios::in | std::ios::binary));
+         auto reader = make_reader(in);
+         reader->validate();
+         for (uint64_t s = 0; s < section_count; s++) {
+            reader->read_section(std::to_string(s), [&](auto& section) {
+               std::pair<uint64_t, bytes> row;
+               bool more = !section.empty();
+               while (more) {
+                  more = section.read_row(row);
+               }
+            });
+         }
+      }
+      auto read = fc::time_point::now();
+
+      BOOST_TEST_MESSAGE(name << ": " << fc::file_size(path) / (1024 * 1024) << " MB on disk, write "
+                         << (written - start).count() / 1000 << " ms, read " << (read - written).count() / 1000 << " ms");
+      fc::remove(path);
+   };
+
+   bench("version 1", [](std::ostream& out) { return std::make_shared<ostream_snapshot_writer>(out); },
+                      [](std::istream& in) { return std::make_shared<istream_snapshot_reader>(in); });
+   bench("version 2", [](std::ostream& out) { return std::make_shared<chunked_ostream_snapshot_writer>(out); },
+                      [](std::istream& in) { return std::make_shared<chunked_istream_snapshot_reader>(in); });
+}
+
 BOOST_AUTO_TEST_SUITE_END()